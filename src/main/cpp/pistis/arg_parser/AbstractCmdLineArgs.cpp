@@ -1,28 +1,31 @@
 #include "AbstractCmdLineArgs.hpp"
 #include "CmdLineArgGenerator.hpp"
+#include "ParseStats.hpp"
+#include "ResourceLimitExceededError.hpp"
 #include "TooManyCmdLineArgsError.hpp"
 #include "UnknownCmdLineArgError.hpp"
+#include <string.h>
 
 using namespace pistis::arg_parser;
 
 AbstractCmdLineArgs::AbstractCmdLineArgs():
-  showUsage_(false) {
+  showUsage_(false), parseStats_(nullptr), parseLimits_() {
 }
 
 void AbstractCmdLineArgs::parse(int argc, char **argv) {
+  if (parseLimits_.limitsTokens()) {
+    checkTokens_(argc, argv);
+  }
+  if (parseStats_) {
+    parseWithStats_(argc, argv);
+    return;
+  }
+
   init_(argc, argv);
   CmdLineArgGenerator args(argc, argv);
   while (args.remaining()) {
     std::string arg= args.next();
-    if (!arg.empty() && (arg[0] == '-')) {
-      if (!handleNamedArg_(args, arg)) {
-	throw UnknownCmdLineArgError(args.appName(), arg);
-      }
-    } else {
-      if (!handleUnnamedArg_(args, arg)) {
-	throw TooManyCmdLineArgsError(args.appName());
-      }
-    }
+    handleArg_(args, arg);
   }
   check_(args.appName());
 }
@@ -48,3 +51,97 @@ bool AbstractCmdLineArgs::handleUnnamedArg_(CmdLineArgGenerator& args,
 void AbstractCmdLineArgs::check_(const std::string& appName) {
   // Default implementation does nothing
 }
+
+void AbstractCmdLineArgs::checkTokens_(int argc, char** argv) const {
+  const std::string appName((argc > 0) ? argv[0] : "");
+  if ((argc > 1) && ((size_t)(argc - 1) > parseLimits_.maxTokens)) {
+    throw ResourceLimitExceededError(appName, "", "Number of arguments",
+				     parseLimits_.maxTokens);
+  }
+  if (parseLimits_.maxTokenSize != ParseLimits::UNLIMITED) {
+    for (int i= 1; i < argc; ++i) {
+      // Stops at the limit rather than measuring all of a long argument
+      if (strnlen(argv[i], parseLimits_.maxTokenSize + 1) >
+	    parseLimits_.maxTokenSize) {
+	throw ResourceLimitExceededError(
+	    appName, "", "Length of argument " + std::to_string(i),
+	    parseLimits_.maxTokenSize
+	);
+      }
+    }
+  }
+}
+
+void AbstractCmdLineArgs::handleArg_(CmdLineArgGenerator& args,
+				     const std::string& arg) {
+  if (!arg.empty() && (arg[0] == '-')) {
+    if (!handleNamedArg_(args, arg)) {
+      throw UnknownCmdLineArgError(args.appName(), arg,
+				   suggestionsFor_(arg));
+    }
+  } else {
+    if (!handleUnnamedArg_(args, arg)) {
+      throw TooManyCmdLineArgsError(args.appName());
+    }
+  }
+}
+
+void AbstractCmdLineArgs::parseWithStats_(int argc, char** argv) {
+  ParseStats& stats= *parseStats_;
+  const ParseStats::AllocationCounter countAllocations=
+      ParseStats::allocationCounter();
+  uint64_t allocationsBefore= 0;
+  uint64_t bytesBefore= 0;
+  if (countAllocations) {
+    countAllocations(allocationsBefore, bytesBefore);
+  }
+
+  CmdLineArgGenerator args(argc, argv);
+  auto finish= [&]() {
+    stats.tokens += args.numArgs() - args.remaining();
+    if (countAllocations) {
+      uint64_t allocations= 0;
+      uint64_t bytes= 0;
+      countAllocations(allocations, bytes);
+      stats.allocations += allocations - allocationsBefore;
+      stats.bytesAllocated += bytes - bytesBefore;
+    }
+  };
+
+  ++stats.parses;
+  try {
+    uint64_t start= ParseStats::now();
+    init_(argc, argv);
+    uint64_t end= ParseStats::now();
+    stats.initTime += end - start;
+
+    while (args.remaining()) {
+      start= end;
+      std::string arg= args.next();
+      end= ParseStats::now();
+      stats.tokenizeTime += end - start;
+
+      // Handlers add their own time to conversionTime
+      start= end;
+      const uint64_t conversionTime= stats.conversionTime;
+      handleArg_(args, arg);
+      end= ParseStats::now();
+      stats.dispatchTime +=
+	  (end - start) - (stats.conversionTime - conversionTime);
+    }
+
+    check_(args.appName());
+    stats.checkTime += ParseStats::now() - end;
+  } catch(...) {
+    ++stats.exceptions;
+    finish();
+    throw;
+  }
+  finish();
+}
+
+std::vector<std::string> AbstractCmdLineArgs::suggestionsFor_(
+    const std::string& /* argName */
+) const {
+  return std::vector<std::string>();
+}
@@ -1,12 +1,15 @@
 #ifndef __PISTIS__ARG_PARSER__ABSTRACTCMDLINEARGS_HPP__
 #define __PISTIS__ARG_PARSER__ABSTRACTCMDLINEARGS_HPP__
 
+#include <pistis/arg_parser/ParseLimits.hpp>
 #include <string>
+#include <vector>
 
 namespace pistis {
   namespace arg_parser {
 
     class CmdLineArgGenerator;
+    struct ParseStats;
 
     class AbstractCmdLineArgs {
     public:
@@ -16,6 +19,17 @@ namespace pistis {
       void parse(int argc, char** argv);
       bool showUsage() const { return showUsage_; }
 
+      /** Statistics that parse() adds to, or nullptr if it collects none.
+       *  The object is not owned and must outlive any parse that uses it.
+       */
+      ParseStats* parseStats() const { return parseStats_; }
+      void setParseStats(ParseStats* stats) { parseStats_= stats; }
+
+      const ParseLimits& parseLimits() const { return parseLimits_; }
+      void setParseLimits(const ParseLimits& limits) {
+	parseLimits_= limits;
+      }
+
     protected:
       virtual void init_(int argc, char** argv);
       virtual bool handleNamedArg_(CmdLineArgGenerator& args,
@@ -24,8 +38,21 @@ namespace pistis {
 				     const std::string& value);
       virtual void check_(const std::string& appName);
 
+      /** Known arguments to suggest in place of the unknown argument
+       *  argName.  The default implementation suggests nothing.
+       */
+      virtual std::vector<std::string> suggestionsFor_(
+	  const std::string& argName
+      ) const;
+
     private:
       bool showUsage_;
+      ParseStats* parseStats_;
+      ParseLimits parseLimits_;
+
+      void checkTokens_(int argc, char** argv) const;
+      void handleArg_(CmdLineArgGenerator& args, const std::string& arg);
+      void parseWithStats_(int argc, char** argv);
     };
 
   }
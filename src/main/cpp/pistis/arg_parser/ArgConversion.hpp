@@ -0,0 +1,56 @@
+#ifndef __PISTIS__ARG_PARSER__ARGCONVERSION_HPP__
+#define __PISTIS__ARG_PARSER__ARGCONVERSION_HPP__
+
+#include <type_traits>
+
+namespace pistis {
+  namespace arg_parser {
+
+    struct NoArgConversion { };
+
+    /** Converts command-line values to Value, for arguments registered
+     *  with a destination of type Value, std::vector<Value> or
+     *  std::unordered_set<Value>.
+     *
+     *  Specialize it for types that SimpleCmdLineArgs cannot convert,
+     *  with a static member function
+     *
+     *    template <typename Emplace>
+     *    static void convert(const char* begin, const char* end,
+     *                        const Emplace& emplace);
+     *
+     *  that parses the characters in [begin, end) and calls emplace once
+     *  with the arguments of the Value constructor to use.  The value is
+     *  then constructed directly in its container with emplace_back() or
+     *  emplace(), or is constructed and moved into a plain destination.
+     *  Throw any std::exception to reject the value; its message becomes
+     *  part of the error for the argument.  For example:
+     *
+     *    template <>
+     *    struct ArgConversion<Shard> {
+     *      template <typename Emplace>
+     *      static void convert(const char* begin, const char* end,
+     *                          const Emplace& emplace) {
+     *        const char* colon= std::find(begin, end, ':');
+     *        if (colon == end) {
+     *          throw std::invalid_argument("Shard must be host:port");
+     *        }
+     *        emplace(std::string(begin, colon),
+     *                std::stoi(std::string(colon + 1, end)));
+     *      }
+     *    };
+     */
+    template <typename Value>
+    struct ArgConversion : NoArgConversion { };
+
+    template <typename Value>
+    struct HasArgConversion :
+	std::integral_constant<
+	    bool,
+	    !std::is_base_of< NoArgConversion, ArgConversion<Value> >::value
+	> {
+    };
+
+  }
+}
+#endif
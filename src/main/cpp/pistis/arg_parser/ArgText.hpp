@@ -0,0 +1,132 @@
+#ifndef __PISTIS__ARG_PARSER__ARGTEXT_HPP__
+#define __PISTIS__ARG_PARSER__ARGTEXT_HPP__
+
+#include <pistis/arg_parser/SeededHash.hpp>
+#include <ostream>
+#include <string>
+#include <string.h>
+#include <stddef.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Text with static storage duration, such as a string literal.
+     *
+     *  Names and descriptions registered as StaticText are referred to
+     *  rather than copied, so registering an argument with them does not
+     *  allocate any memory for strings.  Only pass text that lives until
+     *  the program exits.  Arrays that are not const are rejected, since
+     *  their text may change, and the text ends at its first '\0' rather
+     *  than at the end of the array.
+     */
+    class StaticText {
+    public:
+      template <size_t N>
+      StaticText(const char (&text)[N]): text_(text), size_(strlen(text)) {
+	// Intentionally left blank
+      }
+
+      template <size_t N>
+      StaticText(char (&text)[N]) = delete;
+
+      const char* data() const { return text_; }
+      size_t size() const { return size_; }
+
+    private:
+      const char* text_;
+      size_t size_;
+    };
+
+    /** The name or description of an argument.
+     *
+     *  ArgText either owns a copy of its text or refers to text owned by
+     *  someone else, which is either StaticText or, for views made with
+     *  view(), a string that outlives the ArgText.  The text is always
+     *  followed by a '\0'.
+     */
+    class ArgText {
+    public:
+      ArgText(): text_(""), size_(0), owned_(), isOwned_(false) {
+	// Intentionally left blank
+      }
+
+      ArgText(const char* text):
+	  text_(nullptr), size_(strlen(text)), owned_(text), isOwned_(true) {
+	// Intentionally left blank
+      }
+
+      ArgText(const std::string& text):
+	  text_(nullptr), size_(text.size()), owned_(text), isOwned_(true) {
+	// Intentionally left blank
+      }
+
+      ArgText(std::string&& text):
+	  text_(nullptr), size_(text.size()), owned_(std::move(text)),
+	  isOwned_(true) {
+	// Intentionally left blank
+      }
+
+      ArgText(const StaticText& text):
+	  text_(text.data()), size_(text.size()), owned_(), isOwned_(false) {
+	// Intentionally left blank
+      }
+
+      /** Refers to text without copying it */
+      static ArgText view(const std::string& text) {
+	return ArgText(text.c_str(), text.size());
+      }
+
+      static ArgText view(const char* text) {
+	return ArgText(text, strlen(text));
+      }
+
+      static ArgText view(const ArgText& text) {
+	return ArgText(text.data(), text.size());
+      }
+
+      const char* data() const {
+	return isOwned_ ? owned_.c_str() : text_;
+      }
+      const char* c_str() const { return data(); }
+      size_t size() const { return size_; }
+      bool empty() const { return !size_; }
+      bool isOwned() const { return isOwned_; }
+      char operator[](size_t i) const { return data()[i]; }
+
+      std::string str() const { return std::string(data(), size_); }
+
+      bool operator==(const ArgText& other) const {
+	return (size_ == other.size_) &&
+	         !memcmp(data(), other.data(), size_);
+      }
+
+      bool operator!=(const ArgText& other) const {
+	return !(*this == other);
+      }
+
+    private:
+      const char* text_;
+      size_t size_;
+      std::string owned_;
+      bool isOwned_;
+
+      ArgText(const char* text, size_t size):
+	  text_(text), size_(size), owned_(), isOwned_(false) {
+	// Intentionally left blank
+      }
+    };
+
+    inline std::ostream& operator<<(std::ostream& out, const ArgText& text) {
+      return out.write(text.data(), text.size());
+    }
+
+    template <>
+    struct SeededHash<ArgText> {
+      size_t operator()(const ArgText& text) const {
+	return (size_t)seededHash(text.data(), text.size());
+      }
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,139 @@
+#ifndef __PISTIS__ARG_PARSER__BATCHCMDLINEPARSER_HPP__
+#define __PISTIS__ARG_PARSER__BATCHCMDLINEPARSER_HPP__
+
+#include <pistis/arg_parser/CmdLineArgError.hpp>
+#include <pistis/arg_parser/CmdLineTokenizer.hpp>
+#include <pistis/arg_parser/WorkStealingScheduler.hpp>
+#include <exception>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pistis {
+  namespace arg_parser {
+
+    template <typename Target>
+    class BatchParseResult {
+    public:
+      BatchParseResult(): value_(), ok_(false), error_() { }
+
+      bool ok() const { return ok_; }
+      const Target& value() const { return value_; }
+      Target& value() { return value_; }
+      const std::string& error() const { return error_; }
+
+      void setOk() { ok_= true; }
+      void setError(const std::string& msg) {
+	ok_= false;
+	error_= msg;
+      }
+
+    private:
+      Target value_;
+      bool ok_;
+      std::string error_;
+    };
+
+    /** Parses a batch of command lines against a CmdLineSchema.
+     *
+     *  Schema must be a CmdLineSchema<Target> subclass.  The lines are
+     *  divided among the threads of a WorkStealingScheduler, and each
+     *  line produces a BatchParseResult holding either the parsed target or
+     *  the error message, at the same index as the line.  Parsing a line
+     *  never throws.
+     *
+     *  A schema holds per-parse state, so each worker thread gets its own
+     *  instance from the factory.  The factory runs once per worker, not
+     *  once per line.
+     */
+    template <typename Schema>
+    class BatchCmdLineParser {
+    public:
+      typedef typename Schema::TargetType TargetType;
+      typedef BatchParseResult<TargetType> ResultType;
+      typedef std::function<std::unique_ptr<Schema> ()> SchemaFactory;
+
+    public:
+      BatchCmdLineParser(size_t numThreads = 0, size_t chunkSize = 1024):
+	  BatchCmdLineParser(
+	      []() { return std::unique_ptr<Schema>(new Schema()); },
+	      numThreads, chunkSize
+	  ) {
+      }
+
+      BatchCmdLineParser(const SchemaFactory& factory,
+			 size_t numThreads = 0, size_t chunkSize = 1024):
+	  factory_(factory), scheduler_(numThreads), chunkSize_(chunkSize) {
+      }
+
+      size_t numThreads() const { return scheduler_.numThreads(); }
+      size_t chunkSize() const { return chunkSize_; }
+
+      std::vector<ResultType> parse(
+	  const std::vector<std::string>& lines
+      ) const {
+	std::vector<ResultType> results(lines.size());
+	std::vector<Worker_> workers(scheduler_.numThreads());
+
+	scheduler_.run(lines.size(), chunkSize_,
+		       [this, &lines, &results, &workers](
+			   size_t worker, size_t begin, size_t end
+		       ) {
+	  Worker_& w= workers[worker];
+	  if (!w.schema) {
+	    w.schema= factory_();
+	  }
+	  for (size_t i= begin; i < end; ++i) {
+	    parseLine_(w, lines[i], results[i]);
+	  }
+	});
+	return results;
+      }
+
+      /** Parse one command per line of input.  Blank lines produce an
+       *  error result, so results stay aligned with line numbers.
+       */
+      std::vector<ResultType> parse(std::istream& input) const {
+	std::vector<std::string> lines;
+	std::string line;
+	while (std::getline(input, line)) {
+	  lines.push_back(line);
+	}
+	return parse(lines);
+      }
+
+    private:
+      struct Worker_ {
+	std::unique_ptr<Schema> schema;
+	CmdLineTokenizer tokenizer;
+      };
+
+      SchemaFactory factory_;
+      WorkStealingScheduler scheduler_;
+      size_t chunkSize_;
+
+      static void parseLine_(Worker_& w, const std::string& line,
+			     ResultType& result) {
+	try {
+	  if (!w.tokenizer.tokenize(line)) {
+	    result.setError("Empty command line");
+	  } else {
+	    w.schema->parse(w.tokenizer.argc(), w.tokenizer.argv(),
+			    result.value());
+	    result.setOk();
+	  }
+	} catch(const CmdLineArgError& e) {
+	  result.setError(e.what());
+	} catch(const std::exception& e) {
+	  result.setError(e.what());
+	} catch(...) {
+	  result.setError("Unknown error");
+	}
+      }
+    };
+
+  }
+}
+#endif
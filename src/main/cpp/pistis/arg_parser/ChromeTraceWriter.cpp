@@ -0,0 +1,214 @@
+#include "ChromeTraceWriter.hpp"
+#include "ParseStats.hpp"
+#include <pistis/exceptions/IllegalValueError.hpp>
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  // Identifies writers to the per-thread cache of rings.  Unlike their
+  // addresses, identifiers are never reused.
+  std::atomic<uint64_t> nextWriterId(1);
+
+  struct RingCache {
+    uint64_t writerId;
+    void* ring;
+  };
+
+  thread_local RingCache ringCache= { 0, nullptr };
+
+  void throwWriteError(const std::string& path, const char* what) {
+    std::string details(what);
+    details += ": ";
+    details += strerror(errno);
+    throw pistis::exceptions::IllegalValueError("path", path, details,
+						PISTIS_EX_HERE);
+  }
+
+  const char* categoryFor(ParseObserver::Event event) {
+    switch (event) {
+      case ParseObserver::Event::HANDLE_VALUE:
+	return "handleValue";
+
+      case ParseObserver::Event::INIT_VALUES:
+	return "initValues";
+
+      case ParseObserver::Event::CHECK_VALUES:
+	return "checkValues";
+    }
+    return "";
+  }
+
+  void appendJsonString(std::string& out, const char* s) {
+    out.push_back('"');
+    for (; *s; ++s) {
+      const unsigned char c= (unsigned char)*s;
+      if ((c == '"') || (c == '\\')) {
+	out.push_back('\\');
+	out.push_back((char)c);
+      } else if (c < 0x20) {
+	char escape[8];
+	snprintf(escape, sizeof(escape), "\\u%04x", c);
+	out += escape;
+      } else {
+	out.push_back((char)c);
+      }
+    }
+    out.push_back('"');
+  }
+}
+
+const size_t ChromeTraceWriter::MAX_NAME_SIZE;
+const size_t ChromeTraceWriter::RING_SIZE;
+
+ChromeTraceWriter::ChromeTraceWriter(const std::string& path):
+    path_(path), fd_(-1), id_(nextWriterId.fetch_add(1)),
+    start_(ParseStats::now()), pid_((int)getpid()), ringsMutex_(), rings_(),
+    outputMutex_(), output_("{\"traceEvents\":[\n"), first_(true) {
+  fd_= ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    throwWriteError(path, "Cannot create trace file");
+  }
+}
+
+ChromeTraceWriter::~ChromeTraceWriter() {
+  try {
+    flush();
+    std::lock_guard<std::mutex> lock(outputMutex_);
+    output_ += "\n]}\n";
+    writeOutput_();
+  } catch(...) {
+    // Nothing more can be written
+  }
+  ::close(fd_);
+}
+
+void ChromeTraceWriter::begin(Event event, const std::string& name) {
+  try {
+    record_('B', event, name);
+  } catch(...) {
+    // Observers may not throw, so the event is lost
+  }
+}
+
+void ChromeTraceWriter::end(Event event, const std::string& name) {
+  try {
+    record_('E', event, name);
+  } catch(...) {
+    // Observers may not throw, so the event is lost
+  }
+}
+
+void ChromeTraceWriter::flush() {
+  std::vector<Ring_*> rings;
+  {
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    for (auto i= rings_.begin(); i != rings_.end(); ++i) {
+      rings.push_back(i->get());
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(outputMutex_);
+  for (auto i= rings.begin(); i != rings.end(); ++i) {
+    drain_(**i);
+  }
+  writeOutput_();
+}
+
+ChromeTraceWriter::Ring_* ChromeTraceWriter::ring_() {
+  if (ringCache.writerId == id_) {
+    return static_cast<Ring_*>(ringCache.ring);
+  }
+
+  const std::thread::id self= std::this_thread::get_id();
+  Ring_* ring= nullptr;
+  {
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    for (auto i= rings_.begin(); i != rings_.end(); ++i) {
+      if ((*i)->owner == self) {
+	ring= i->get();
+	break;
+      }
+    }
+    if (!ring) {
+      rings_.emplace_back(new Ring_);
+      ring= rings_.back().get();
+      ring->owner= self;
+      ring->tid= (uint32_t)rings_.size();
+      ring->head.store(0, std::memory_order_relaxed);
+      ring->tail.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  ringCache.writerId= id_;
+  ringCache.ring= ring;
+  return ring;
+}
+
+void ChromeTraceWriter::record_(char phase, Event event,
+				const std::string& name) {
+  const uint64_t now= ParseStats::now();
+  Ring_& ring= *ring_();
+  const size_t head= ring.head.load(std::memory_order_relaxed);
+  if ((head - ring.tail.load(std::memory_order_acquire)) == RING_SIZE) {
+    // Make room by moving the ring's contents to the output buffer.  The
+    // file is only written by flush(), which can report errors.
+    std::lock_guard<std::mutex> lock(outputMutex_);
+    drain_(ring);
+  }
+
+  Record_& r= ring.records[head % RING_SIZE];
+  const size_t n= std::min(name.size(), MAX_NAME_SIZE);
+  r.time= now;
+  r.phase= phase;
+  r.event= event;
+  memcpy(r.name, name.data(), n);
+  r.name[n]= 0;
+  ring.head.store(head + 1, std::memory_order_release);
+}
+
+void ChromeTraceWriter::drain_(Ring_& ring) {
+  const size_t head= ring.head.load(std::memory_order_acquire);
+  size_t tail= ring.tail.load(std::memory_order_relaxed);
+  char buffer[96];
+
+  for (; tail != head; ++tail) {
+    const Record_& r= ring.records[tail % RING_SIZE];
+    const uint64_t t= (r.time > start_) ? (r.time - start_) : 0;
+    if (!first_) {
+      output_ += ",\n";
+    }
+    first_= false;
+    output_ += "{\"name\":";
+    appendJsonString(output_, r.name);
+    snprintf(buffer, sizeof(buffer),
+	     ",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%llu.%03u,"
+	     "\"pid\":%d,\"tid\":%u}",
+	     categoryFor(r.event), r.phase, (unsigned long long)(t / 1000),
+	     (unsigned)(t % 1000), pid_, ring.tid);
+    output_ += buffer;
+  }
+  ring.tail.store(tail, std::memory_order_release);
+}
+
+void ChromeTraceWriter::writeOutput_() {
+  const char* p= output_.data();
+  size_t remaining= output_.size();
+  while (remaining) {
+    const ssize_t n= ::write(fd_, p, remaining);
+    if (n < 0) {
+      if (errno == EINTR) {
+	continue;
+      }
+      throwWriteError(path_, "Cannot write trace file");
+    }
+    p += n;
+    remaining -= (size_t)n;
+  }
+  output_.clear();
+}
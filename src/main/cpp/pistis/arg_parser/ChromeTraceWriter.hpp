@@ -0,0 +1,93 @@
+#ifndef __PISTIS__ARG_PARSER__CHROMETRACEWRITER_HPP__
+#define __PISTIS__ARG_PARSER__CHROMETRACEWRITER_HPP__
+
+#include <pistis/arg_parser/ParseObserver.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Writes the events it observes to a file in Chrome's trace-event
+     *  format, which chrome://tracing and Perfetto display as a timeline.
+     *
+     *  Each thread records its events into a ring of its own without
+     *  taking a lock.  The rings are copied into the file by flush(), by
+     *  the destructor, and by a thread whose ring is full, which waits for
+     *  any other flush in progress.  Names longer than MAX_NAME_SIZE
+     *  bytes are truncated.  begin() and end() never throw; an event that
+     *  cannot be recorded, because memory for a ring or the output buffer
+     *  runs out, is dropped.
+     */
+    class ChromeTraceWriter : public ParseObserver {
+    public:
+      static const size_t MAX_NAME_SIZE= 47;
+      static const size_t RING_SIZE= 1024;
+
+    public:
+      /** Throws pistis::exceptions::IllegalValueError if the file cannot
+       *  be created.
+       */
+      ChromeTraceWriter(const std::string& path);
+      ChromeTraceWriter(const ChromeTraceWriter&) = delete;
+
+      /** Flushes the remaining events and completes the file.  No thread
+       *  may be recording events when the writer is destroyed.
+       */
+      virtual ~ChromeTraceWriter();
+
+      const std::string& path() const { return path_; }
+
+      virtual void begin(Event event, const std::string& name);
+      virtual void end(Event event, const std::string& name);
+
+      /** Write the events recorded so far by all threads.  Throws
+       *  pistis::exceptions::IllegalValueError if the file cannot be
+       *  written.
+       */
+      void flush();
+
+      ChromeTraceWriter& operator=(const ChromeTraceWriter&) = delete;
+
+    private:
+      struct Record_ {
+	uint64_t time;
+	char phase;
+	Event event;
+	char name[MAX_NAME_SIZE + 1];
+      };
+
+      struct Ring_ {
+	std::thread::id owner;
+	uint32_t tid;
+	std::atomic<size_t> head;
+	std::atomic<size_t> tail;
+	Record_ records[RING_SIZE];
+      };
+
+      std::string path_;
+      int fd_;
+      uint64_t id_;
+      uint64_t start_;
+      int pid_;
+      std::mutex ringsMutex_;
+      std::vector< std::unique_ptr<Ring_> > rings_;
+      std::mutex outputMutex_;
+      std::string output_;
+      bool first_;
+
+      Ring_* ring_();
+      void record_(char phase, Event event, const std::string& name);
+      void drain_(Ring_& ring);
+      void writeOutput_();
+    };
+
+  }
+}
+#endif
@@ -29,6 +29,13 @@ std::string CmdLineArgGenerator::next(const std::string& argName) {
   return std::string(*current_++);
 }
 
+const char* CmdLineArgGenerator::nextToken(const std::string& argName) {
+  if (current_ == end_) {
+    throw ValueMissingError(appName(), argName);
+  }
+  return *current_++;
+}
+
 int64_t CmdLineArgGenerator::nextAsInt(const std::string& argName) {
   try {
     return nextAs(argName, [](const std::string& argName,
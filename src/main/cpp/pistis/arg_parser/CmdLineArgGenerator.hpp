@@ -23,6 +23,14 @@ namespace pistis {
       std::string current(const std::string& argName = std::string()) const;
       std::string next(const std::string& arg = std::string());
 
+      /** Like next(), but returns the argument itself, without copying
+       *  it.
+       */
+      const char* nextToken(const std::string& arg = std::string());
+
+      char** remainingArgv() const { return current_; }
+      void skipRemaining() { current_= end_; }
+
       template <typename Converter>
       double foo(const std::string& argName, Converter convert) {
 	return convert(argName, next(argName));
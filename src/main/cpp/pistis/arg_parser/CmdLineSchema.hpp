@@ -0,0 +1,347 @@
+#ifndef __PISTIS__ARG_PARSER__CMDLINESCHEMA_HPP__
+#define __PISTIS__ARG_PARSER__CMDLINESCHEMA_HPP__
+
+#include <pistis/exceptions/IllegalStateError.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Command-line arguments bound to pointers-to-member of Target.
+     *
+     *  Handlers are registered once, in the subclass' constructor, against
+     *  members of Target rather than against references to variables.
+     *  Each call to parse() fills in the Target passed to it, so one schema
+     *  can fill any number of target objects without re-registering its
+     *  options.  A schema holds per-parse state and must not be used by
+     *  more than one thread at a time.
+     */
+    template <typename Target>
+    class CmdLineSchema : public SimpleCmdLineArgs {
+    public:
+      typedef Target TargetType;
+
+    public:
+      CmdLineSchema(): SimpleCmdLineArgs(), currentTarget_(nullptr) { }
+
+      void parse(int argc, char** argv, Target& target) {
+	TargetGuard_ guard(currentTarget_, &target);
+	AbstractCmdLineArgs::parse(argc, argv);
+      }
+
+    protected:
+      template <typename Destination>
+      struct DestinationTraits_ {
+	typedef Destination ValueType;
+	static const bool REPEATABLE = false;
+
+	static void store(CmdLineSchema& /* schema */, Destination& d,
+			  const ValueType& v) {
+	  d= v;
+	}
+      };
+
+      template <typename Value>
+      struct DestinationTraits_< std::vector<Value> > {
+	typedef Value ValueType;
+	static const bool REPEATABLE = true;
+
+	static void store(CmdLineSchema& schema, std::vector<Value>& d,
+			  const Value& v) {
+	  schema.addTo_(d, v);
+	}
+      };
+
+      template <typename Value, typename Hash, typename Equal>
+      struct DestinationTraits_< std::unordered_set<Value, Hash, Equal> > {
+	typedef Value ValueType;
+	static const bool REPEATABLE = true;
+
+	static void store(CmdLineSchema& schema,
+			  std::unordered_set<Value, Hash, Equal>& d,
+			  const Value& v) {
+	  schema.addTo_(d, v);
+	}
+      };
+
+      Target& currentTarget() const {
+	if (!currentTarget_) {
+	  throw pistis::exceptions::IllegalStateError(
+	      "No target object is being parsed", PISTIS_EX_HERE
+	  );
+	}
+	return *currentTarget_;
+      }
+
+      using SimpleCmdLineArgs::registerNamedArg_;
+      using SimpleCmdLineArgs::registerNamedArgInRange_;
+      using SimpleCmdLineArgs::registerNamedArgInSet_;
+      using SimpleCmdLineArgs::registerUnnamedArg_;
+      using SimpleCmdLineArgs::registerUnnamedArgInRange_;
+      using SimpleCmdLineArgs::registerUnnamedArgInSet_;
+
+      template <typename Destination>
+      void registerNamedArg_(const ArgText& argName,
+			     const ArgText& description,
+			     bool required,
+			     Destination Target::* member) {
+	ArgHandler* h=
+	  createDelegate_(argName, description, required, true,
+			  [this, member](CmdLineArgGenerator& args,
+					 const std::string& argName) -> void {
+	    convertInto_(this->currentTarget().*member, args.next(argName));
+	  });
+	registerHandler_(h);
+      }
+
+      template <typename Destination>
+      void registerNamedArg_(const ArgText& argName,
+			     const ArgText& description,
+			     bool required,
+			     const std::string& separator,
+			     bool allowEmpty,
+			     Destination Target::* member) {
+	typedef DestinationTraits_<Destination> Traits;
+	static_assert(Traits::REPEATABLE,
+		      "Separated values require a container destination");
+	ArgHandler* h=
+	  createDelegate_(
+	      argName, description, required, true,
+	      [this, member, separator, allowEmpty](
+		  CmdLineArgGenerator& args, const std::string& argName
+	      ) -> void {
+		Destination& d= this->currentTarget().*member;
+		applyToItems_(args.next(argName), separator, allowEmpty,
+			      [&d, this](const std::string& value) -> void {
+		  convertInto_(d, value);
+		});
+	      }
+	  );
+	registerHandler_(h);
+      }
+
+      template <typename Value, typename Destination>
+      void registerNamedArgInRange_(const ArgText& argName,
+				    const ArgText& description,
+				    bool required, Value minValue,
+				    Value maxValue,
+				    Destination Target::* member) {
+	typedef DestinationTraits_<Destination> Traits;
+	ArgHandler* h=
+	  createDelegate_(argName, description, required, true,
+			  [this, member, minValue, maxValue](
+			      CmdLineArgGenerator& args,
+			      const std::string& argName
+			  ) -> void {
+	    Traits::store(*this, this->currentTarget().*member,
+			  ArgFormatter<Value>::format(args.next(argName),
+						      minValue, maxValue));
+	  });
+	registerHandler_(h);
+      }
+
+      template <typename Value, typename Destination>
+      void registerNamedArgInSet_(const ArgText& argName,
+				  const ArgText& description,
+				  bool required,
+				  const std::unordered_set<Value>& legalValues,
+				  Destination Target::* member) {
+	typedef DestinationTraits_<Destination> Traits;
+	ArgHandler* h=
+	  createDelegate_(argName, description, required, true,
+			  [this, member, legalValues](
+			      CmdLineArgGenerator& args,
+			      const std::string& argName
+			  ) -> void {
+	    Traits::store(*this, this->currentTarget().*member,
+			  ArgFormatter<Value>::format(args.next(argName),
+						      legalValues));
+	  });
+	addCompletions_(h, legalValues);
+	registerHandler_(h);
+      }
+
+      template <typename Value, typename Destination>
+      void registerNamedArg_(const ArgText& argName,
+			     const ArgText& description,
+			     bool required,
+			     const ValueMap<Value>& valueMap,
+			     Destination Target::* member) {
+	typedef DestinationTraits_<Destination> Traits;
+	ArgHandler* h=
+	  createDelegate_(argName, description, required, true,
+			  [this, member, valueMap](
+			      CmdLineArgGenerator& args,
+			      const std::string& argName
+			  ) -> void {
+	    Traits::store(*this, this->currentTarget().*member,
+			  valueMap[args.next(argName)]);
+	  });
+	addCompletions_(h, valueMap);
+	registerHandler_(h);
+      }
+
+      template <typename Value, typename Destination>
+      void registerNamedArg_(const ArgText& argName,
+			     const ArgText& description,
+			     bool required,
+			     const std::function<Value (const std::string&)>&
+			         format,
+			     Destination Target::* member) {
+	typedef DestinationTraits_<Destination> Traits;
+	ArgHandler* h=
+	  createDelegate_(argName, description, required, true,
+			  [this, member, format](
+			      CmdLineArgGenerator& args,
+			      const std::string& argName
+			  ) -> void {
+	    Traits::store(*this, this->currentTarget().*member,
+			  formatUsingFn(args.next(argName), format));
+	  });
+	registerHandler_(h);
+      }
+
+      template <typename Destination>
+      void registerUnnamedArg_(const ArgText& description,
+			       bool required,
+			       Destination Target::* member) {
+	typedef DestinationTraits_<Destination> Traits;
+	ArgHandler* h=
+	  createDelegate_(std::string(), description, required,
+			  Traits::REPEATABLE,
+			  [this, member](CmdLineArgGenerator& /* args */,
+					 const std::string& argValue) -> void {
+	    convertInto_(this->currentTarget().*member, argValue);
+	  });
+	registerHandler_(h);
+      }
+
+      template <typename Destination>
+      void registerUnnamedArg_(const ArgText& description,
+			       bool required,
+			       const std::string& separator,
+			       Destination Target::* member) {
+	typedef DestinationTraits_<Destination> Traits;
+	static_assert(Traits::REPEATABLE,
+		      "Separated values require a container destination");
+	ArgHandler* h=
+	  createDelegate_(std::string(), description, required, false,
+			  [this, member, separator](
+			      CmdLineArgGenerator& args,
+			      const std::string& argValue
+			  ) -> void {
+	    Destination& d= this->currentTarget().*member;
+	    applyToItems_(argValue, separator, false,
+			  [&d, this](const std::string& value) -> void {
+	      convertInto_(d, value);
+	    });
+	  });
+	registerHandler_(h);
+      }
+
+      template <typename Value, typename Destination>
+      void registerUnnamedArgInRange_(const ArgText& description,
+				      bool required,
+				      Value minValue, Value maxValue,
+				      Destination Target::* member) {
+	typedef DestinationTraits_<Destination> Traits;
+	ArgHandler* h=
+	  createDelegate_(std::string(), description, required,
+			  Traits::REPEATABLE,
+			  [this, member, minValue, maxValue](
+			      CmdLineArgGenerator& args,
+			      const std::string& argValue
+			  ) -> void {
+	    Traits::store(*this, this->currentTarget().*member,
+			  ArgFormatter<Value>::format(argValue, minValue,
+						      maxValue));
+	  });
+	registerHandler_(h);
+      }
+
+      template <typename Value, typename Destination>
+      void registerUnnamedArgInSet_(const ArgText& description,
+				    bool required,
+				    const std::unordered_set<Value>&
+				        legalValues,
+				    Destination Target::* member) {
+	typedef DestinationTraits_<Destination> Traits;
+	ArgHandler* h=
+	  createDelegate_(std::string(), description, required,
+			  Traits::REPEATABLE,
+			  [this, member, legalValues](
+			      CmdLineArgGenerator& args,
+			      const std::string& argValue
+			  ) -> void {
+	    Traits::store(*this, this->currentTarget().*member,
+			  ArgFormatter<Value>::format(argValue, legalValues));
+	  });
+	addCompletions_(h, legalValues);
+	registerHandler_(h);
+      }
+
+      template <typename Value, typename Destination>
+      void registerUnnamedArg_(const ArgText& description,
+			       bool required,
+			       const ValueMap<Value>& valueMap,
+			       Destination Target::* member) {
+	typedef DestinationTraits_<Destination> Traits;
+	ArgHandler* h=
+	  createDelegate_(std::string(), description, required,
+			  Traits::REPEATABLE,
+			  [this, member, valueMap](
+			      CmdLineArgGenerator& args,
+			      const std::string& argValue
+			  ) -> void {
+	    Traits::store(*this, this->currentTarget().*member,
+			  valueMap[argValue]);
+	  });
+	addCompletions_(h, valueMap);
+	registerHandler_(h);
+      }
+
+      template <typename Value, typename Destination>
+      void registerUnnamedArg_(const ArgText& description,
+			       bool required,
+			       const std::function<
+			           Value (const std::string&)
+			       >& format,
+			       Destination Target::* member) {
+	typedef DestinationTraits_<Destination> Traits;
+	ArgHandler* h=
+	  createDelegate_(std::string(), description, required,
+			  Traits::REPEATABLE,
+			  [this, member, format](
+			      CmdLineArgGenerator& args,
+			      const std::string& argValue
+			  ) -> void {
+	    Traits::store(*this, this->currentTarget().*member,
+			  formatUsingFn(argValue, format));
+	  });
+	registerHandler_(h);
+      }
+
+    private:
+      class TargetGuard_ {
+      public:
+	TargetGuard_(Target*& current, Target* target):
+	    current_(current), previous_(current) {
+	  current_= target;
+	}
+	~TargetGuard_() { current_= previous_; }
+
+      private:
+	Target*& current_;
+	Target* previous_;
+      };
+
+      Target* currentTarget_;
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,73 @@
+#include "CmdLineTokenizer.hpp"
+#include <pistis/exceptions/IllegalValueError.hpp>
+#include <ctype.h>
+
+using namespace pistis::arg_parser;
+
+CmdLineTokenizer::CmdLineTokenizer():
+    buffer_(), offsets_(), argv_(1, nullptr) {
+  // Intentionally left blank
+}
+
+int CmdLineTokenizer::tokenize(const std::string& line) {
+  const char* p= line.c_str();
+  const char* const end= p + line.size();
+
+  buffer_.clear();
+  offsets_.clear();
+  argv_.clear();
+
+  while (p != end) {
+    while ((p != end) && isspace((unsigned char)*p)) {
+      ++p;
+    }
+    if (p == end) {
+      break;
+    }
+
+    offsets_.push_back(buffer_.size());
+    while ((p != end) && !isspace((unsigned char)*p)) {
+      if (*p == '\'') {
+	const char* q= ++p;
+	while ((q != end) && (*q != '\'')) {
+	  ++q;
+	}
+	if (q == end) {
+	  throw pistis::exceptions::IllegalValueError(
+	      "line", line, "Unterminated single quote", PISTIS_EX_HERE
+	  );
+	}
+	buffer_.insert(buffer_.end(), p, q);
+	p= q + 1;
+      } else if (*p == '"') {
+	++p;
+	while ((p != end) && (*p != '"')) {
+	  if ((*p == '\\') && ((p + 1) != end) &&
+	      ((p[1] == '"') || (p[1] == '\\'))) {
+	    ++p;
+	  }
+	  buffer_.push_back(*p++);
+	}
+	if (p == end) {
+	  throw pistis::exceptions::IllegalValueError(
+	      "line", line, "Unterminated double quote", PISTIS_EX_HERE
+	  );
+	}
+	++p;
+      } else if ((*p == '\\') && ((p + 1) != end)) {
+	buffer_.push_back(p[1]);
+	p += 2;
+      } else {
+	buffer_.push_back(*p++);
+      }
+    }
+    buffer_.push_back('\0');
+  }
+
+  // Pointers into buffer_ are taken only after it has stopped growing
+  for (auto i= offsets_.begin(); i != offsets_.end(); ++i) {
+    argv_.push_back(buffer_.data() + *i);
+  }
+  argv_.push_back(nullptr);
+  return argc();
+}
@@ -0,0 +1,42 @@
+#ifndef __PISTIS__ARG_PARSER__CMDLINETOKENIZER_HPP__
+#define __PISTIS__ARG_PARSER__CMDLINETOKENIZER_HPP__
+
+#include <string>
+#include <vector>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Splits a command line into the argv vector a shell would pass.
+     *
+     *  Tokens are separated by unquoted whitespace.  Single quotes preserve
+     *  everything up to the closing quote, double quotes preserve everything
+     *  except backslash escapes of '"' and '\', and an unquoted backslash
+     *  escapes the next character.  The token and pointer buffers are
+     *  reused from one call to the next, so tokenizing many lines with the
+     *  same tokenizer does not allocate once the buffers have grown.
+     */
+    class CmdLineTokenizer {
+    public:
+      CmdLineTokenizer();
+      CmdLineTokenizer(const CmdLineTokenizer&) = delete;
+
+      /** Tokenize line, returning the number of tokens.  Throws
+       *  pistis::exceptions::IllegalValueError if a quote is not closed.
+       */
+      int tokenize(const std::string& line);
+
+      int argc() const { return (int)argv_.size() - 1; }
+      char** argv() { return argv_.data(); }
+
+      CmdLineTokenizer& operator=(const CmdLineTokenizer&) = delete;
+
+    private:
+      std::vector<char> buffer_;
+      std::vector<size_t> offsets_;
+      std::vector<char*> argv_;
+    };
+
+  }
+}
+#endif
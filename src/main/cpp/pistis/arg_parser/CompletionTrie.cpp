@@ -0,0 +1,76 @@
+#include "CompletionTrie.hpp"
+
+using namespace pistis::arg_parser;
+
+CompletionTrie::CompletionTrie(): nodes_(1, Node_{ 0, false, 0, 0 }),
+				  numWords_(0) {
+  // Intentionally left blank
+}
+
+void CompletionTrie::insert(const std::string& word) {
+  uint32_t node= 0;
+  for (auto i= word.begin(); i != word.end(); ++i) {
+    const unsigned char c= (unsigned char)*i;
+
+    // Find c among the children of node, or the place to insert it
+    uint32_t prev= 0;
+    uint32_t next= nodes_[node].child;
+    while (next && (nodes_[next].c < c)) {
+      prev= next;
+      next= nodes_[next].sibling;
+    }
+
+    if (next && (nodes_[next].c == c)) {
+      node= next;
+    } else {
+      const uint32_t n= (uint32_t)nodes_.size();
+      nodes_.push_back(Node_{ c, false, 0, next });
+      if (prev) {
+	nodes_[prev].sibling= n;
+      } else {
+	nodes_[node].child= n;
+      }
+      node= n;
+    }
+  }
+
+  if (!nodes_[node].terminal) {
+    nodes_[node].terminal= true;
+    ++numWords_;
+  }
+}
+
+size_t CompletionTrie::complete(const std::string& prefix,
+				std::string& out) const {
+  uint32_t node= 0;
+  for (auto i= prefix.begin(); i != prefix.end(); ++i) {
+    const unsigned char c= (unsigned char)*i;
+    node= nodes_[node].child;
+    while (node && (nodes_[node].c < c)) {
+      node= nodes_[node].sibling;
+    }
+    if (!node || (nodes_[node].c != c)) {
+      return 0;
+    }
+  }
+
+  std::string word(prefix);
+  return appendAll_(node, word, out);
+}
+
+size_t CompletionTrie::appendAll_(uint32_t node, std::string& word,
+				  std::string& out) const {
+  size_t n= 0;
+  if (nodes_[node].terminal) {
+    out.append(word);
+    out.push_back('\n');
+    ++n;
+  }
+  for (uint32_t child= nodes_[node].child; child;
+       child= nodes_[child].sibling) {
+    word.push_back((char)nodes_[child].c);
+    n += appendAll_(child, word, out);
+    word.pop_back();
+  }
+  return n;
+}
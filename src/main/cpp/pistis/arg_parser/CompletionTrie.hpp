@@ -0,0 +1,51 @@
+#ifndef __PISTIS__ARG_PARSER__COMPLETIONTRIE_HPP__
+#define __PISTIS__ARG_PARSER__COMPLETIONTRIE_HPP__
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** A set of words that can list every word beginning with a prefix.
+     *
+     *  Nodes are kept in one vector and linked by index, with the
+     *  children of each node in byte order, so completions come out
+     *  sorted without a separate sort.
+     */
+    class CompletionTrie {
+    public:
+      CompletionTrie();
+
+      bool empty() const { return !numWords_; }
+      size_t size() const { return numWords_; }
+
+      void insert(const std::string& word);
+
+      /** Append every word beginning with prefix to out, each followed by
+       *  '\n', in byte order.  Returns the number of words appended.
+       */
+      size_t complete(const std::string& prefix, std::string& out) const;
+
+    private:
+      struct Node_ {
+	unsigned char c;
+	bool terminal;
+	uint32_t child;
+	uint32_t sibling;
+      };
+
+      // nodes_[0] is the root.  A child or sibling index of zero means
+      // there is none, since the root is never anyone's child.
+      std::vector<Node_> nodes_;
+      size_t numWords_;
+
+      size_t appendAll_(uint32_t node, std::string& word,
+			std::string& out) const;
+    };
+
+  }
+}
+#endif
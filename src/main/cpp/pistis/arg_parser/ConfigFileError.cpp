@@ -0,0 +1,27 @@
+#include "ConfigFileError.hpp"
+#include <sstream>
+
+using namespace pistis::arg_parser;
+
+ConfigFileError::ConfigFileError(const std::string& appName,
+				 const std::string& fileName,
+				 size_t line,
+				 const std::string& details):
+    CmdLineArgError(appName, createMessage_(fileName, line, details)),
+    fileName_(fileName), line_(line), details_(details) {
+  // Intentionally left blank
+}
+
+std::string ConfigFileError::createMessage_(const std::string& fileName,
+					    size_t line,
+					    const std::string& details) {
+  std::ostringstream msg;
+  msg << "Error in configuration file " << fileName;
+  if (line) {
+    msg << ", line " << line;
+  }
+  if (!details.empty()) {
+    msg << " (" << details << ")";
+  }
+  return msg.str();
+}
@@ -0,0 +1,34 @@
+#ifndef __PISTIS__ARG_PARSER__CONFIGFILEERROR_HPP__
+#define __PISTIS__ARG_PARSER__CONFIGFILEERROR_HPP__
+
+#include <pistis/arg_parser/CmdLineArgError.hpp>
+#include <string>
+#include <stddef.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    class ConfigFileError : public CmdLineArgError {
+    public:
+      ConfigFileError(const std::string& appName,
+		      const std::string& fileName,
+		      size_t line,
+		      const std::string& details);
+
+      const std::string& fileName() const { return fileName_; }
+      size_t line() const { return line_; }
+      const std::string& details() const { return details_; }
+
+    private:
+      std::string fileName_;
+      size_t line_;
+      std::string details_;
+
+      static std::string createMessage_(const std::string& fileName,
+					size_t line,
+					const std::string& details);
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,88 @@
+#include "ConfigFileReader.hpp"
+#include "ConfigFileError.hpp"
+#include <string.h>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  inline bool isBlank(char c) {
+    return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\f') ||
+           (c == '\v');
+  }
+
+  inline void trim(const char*& begin, const char*& end) {
+    while ((begin != end) && isBlank(*begin)) {
+      ++begin;
+    }
+    while ((end != begin) && isBlank(end[-1])) {
+      --end;
+    }
+  }
+}
+
+ConfigFileReader::ConfigFileReader(const std::string& fileName,
+				   const char* begin, const char* end):
+    fileName_(fileName), current_(begin), end_(end), line_(0),
+    section_(begin), sectionSize_(0) {
+  // Intentionally left blank
+}
+
+bool ConfigFileReader::next(ConfigEntry& entry) {
+  while (current_ != end_) {
+    const char* eol= (const char*)memchr(current_, '\n', end_ - current_);
+    if (!eol) {
+      eol= end_;
+    }
+
+    const char* p= current_;
+    const char* q= eol;
+    current_= (eol == end_) ? end_ : eol + 1;
+    ++line_;
+
+    trim(p, q);
+    if ((p == q) || (*p == '#') || (*p == ';')) {
+      continue;
+    }
+
+    if (*p == '[') {
+      if (q[-1] != ']') {
+	throw ConfigFileError(std::string(), fileName_, line_,
+			      "Section header is missing a closing ']'");
+      }
+      ++p;
+      --q;
+      trim(p, q);
+      section_= p;
+      sectionSize_= q - p;
+      continue;
+    }
+
+    const char* eq= (const char*)memchr(p, '=', q - p);
+    if (!eq) {
+      throw ConfigFileError(std::string(), fileName_, line_,
+			    "Expected \"key = value\"");
+    }
+
+    const char* keyEnd= eq;
+    const char* value= eq + 1;
+    trim(p, keyEnd);
+    trim(value, q);
+    if (p == keyEnd) {
+      throw ConfigFileError(std::string(), fileName_, line_, "Key is empty");
+    }
+    if (((q - value) >= 2) && (*value == '"') && (q[-1] == '"')) {
+      ++value;
+      --q;
+    }
+
+    entry.section= section_;
+    entry.sectionSize= sectionSize_;
+    entry.key= p;
+    entry.keySize= keyEnd - p;
+    entry.value= value;
+    entry.valueSize= q - value;
+    entry.line= line_;
+    return true;
+  }
+  return false;
+}
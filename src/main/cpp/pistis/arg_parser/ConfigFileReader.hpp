@@ -0,0 +1,53 @@
+#ifndef __PISTIS__ARG_PARSER__CONFIGFILEREADER_HPP__
+#define __PISTIS__ARG_PARSER__CONFIGFILEREADER_HPP__
+
+#include <string>
+#include <stddef.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** One "key = value" entry.  All pointers point into the text being
+     *  read and are not NUL-terminated.
+     */
+    struct ConfigEntry {
+      const char* section;
+      size_t sectionSize;
+      const char* key;
+      size_t keySize;
+      const char* value;
+      size_t valueSize;
+      size_t line;
+    };
+
+    /** Reads "key = value" entries and INI-style "[section]" headers from
+     *  text in memory, without copying it.
+     *
+     *  Leading and trailing whitespace is ignored, as are blank lines and
+     *  lines beginning with '#' or ';'.  A value enclosed in double quotes
+     *  has the quotes removed.  Syntax errors throw ConfigFileError with an
+     *  empty application name.
+     */
+    class ConfigFileReader {
+    public:
+      ConfigFileReader(const std::string& fileName, const char* begin,
+		       const char* end);
+
+      const std::string& fileName() const { return fileName_; }
+      size_t line() const { return line_; }
+
+      /** Read the next entry into entry, returning false at the end */
+      bool next(ConfigEntry& entry);
+
+    private:
+      std::string fileName_;
+      const char* current_;
+      const char* end_;
+      size_t line_;
+      const char* section_;
+      size_t sectionSize_;
+    };
+
+  }
+}
+#endif
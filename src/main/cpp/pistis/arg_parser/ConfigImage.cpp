@@ -0,0 +1,168 @@
+#include "ConfigImage.hpp"
+#include <pistis/exceptions/IllegalValueError.hpp>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+using pistis::exceptions::PistisException;
+using namespace pistis::arg_parser;
+
+namespace {
+  const char MAGIC[8]= { 'P', 'I', 'S', 'T', 'C', 'F', 'G', '\0' };
+  const uint32_t VERSION= 1;
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t fingerprint;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t numEntries;
+    uint64_t stringsSize;
+  };
+
+  void throwWriteError(const std::string& path) {
+    throw pistis::exceptions::IllegalValueError(
+        "path", path, std::string("Cannot write image: ") + strerror(errno),
+	PISTIS_EX_HERE
+    );
+  }
+
+  bool writeAll(int fd, const void* data, size_t size) {
+    const char* p= (const char*)data;
+    while (size) {
+      ssize_t n= ::write(fd, p, size);
+      if (n < 0) {
+	if (errno == EINTR) {
+	  continue;
+	}
+	return false;
+      }
+      p += n;
+      size -= n;
+    }
+    return true;
+  }
+}
+
+ConfigImage::ConfigImage():
+    file_(), entries_(nullptr), numEntries_(0), strings_(nullptr) {
+  // Intentionally left blank
+}
+
+bool ConfigImage::load(const std::string& path, uint64_t fingerprint,
+		       size_t numHandlers, uint64_t sourceSize,
+		       int64_t sourceMtime) {
+  file_= MappedFile();
+  entries_= nullptr;
+  numEntries_= 0;
+  strings_= nullptr;
+
+  if (access(path.c_str(), R_OK) < 0) {
+    return false;
+  }
+
+  MappedFile file;
+  try {
+    file= MappedFile(path);
+  } catch(const PistisException&) {
+    return false;
+  }
+
+  if (file.size() < sizeof(Header)) {
+    return false;
+  }
+
+  const Header* h= (const Header*)file.data();
+  if (memcmp(h->magic, MAGIC, sizeof(MAGIC)) || (h->version != VERSION) ||
+      (h->fingerprint != fingerprint) || (h->sourceSize != sourceSize) ||
+      (h->sourceMtime != sourceMtime)) {
+    return false;
+  }
+
+  const uint64_t available= file.size() - sizeof(Header);
+  if ((h->numEntries > available / sizeof(Entry)) ||
+      (h->stringsSize != available - h->numEntries * sizeof(Entry))) {
+    return false;
+  }
+
+  // Check every entry once here so replaying it needs no checks
+  const Entry* entries= (const Entry*)(file.data() + sizeof(Header));
+  const char* strings= (const char*)(entries + h->numEntries);
+  for (const Entry* e= entries; e != entries + h->numEntries; ++e) {
+    if ((e->handler >= numHandlers) || (e->value >= h->stringsSize) ||
+	(e->valueSize >= h->stringsSize - e->value) ||
+	strings[e->value + e->valueSize]) {
+      return false;
+    }
+  }
+
+  numEntries_= h->numEntries;
+  file_= std::move(file);
+  entries_= (const Entry*)(file_.data() + sizeof(Header));
+  strings_= (const char*)(entries_ + numEntries_);
+  return true;
+}
+
+ConfigImageWriter::ConfigImageWriter(): entries_(), strings_() {
+  // Intentionally left blank
+}
+
+void ConfigImageWriter::add(size_t handler, size_t line, const char* value,
+			    size_t valueSize) {
+  ConfigImage::Entry e;
+  e.handler= (uint32_t)handler;
+  e.line= (uint32_t)line;
+  e.value= strings_.size();
+  e.valueSize= valueSize;
+  entries_.push_back(e);
+  strings_.insert(strings_.end(), value, value + valueSize);
+  strings_.push_back('\0');
+}
+
+void ConfigImageWriter::write(const std::string& path, uint64_t fingerprint,
+			      uint64_t sourceSize,
+			      int64_t sourceMtime) const {
+  Header h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, MAGIC, sizeof(MAGIC));
+  h.version= VERSION;
+  h.fingerprint= fingerprint;
+  h.sourceSize= sourceSize;
+  h.sourceMtime= sourceMtime;
+  h.numEntries= entries_.size();
+  h.stringsSize= strings_.size();
+
+  std::string tmpPath(path);
+  tmpPath += ".XXXXXX";
+  int fd= mkstemp(&tmpPath[0]);
+  if (fd < 0) {
+    throwWriteError(path);
+  }
+
+  bool ok= writeAll(fd, &h, sizeof(h)) &&
+            writeAll(fd, entries_.data(),
+		     entries_.size() * sizeof(ConfigImage::Entry)) &&
+            writeAll(fd, strings_.data(), strings_.size());
+  int err= errno;
+  if ((::close(fd) < 0) && ok) {
+    ok= false;
+    err= errno;
+  }
+  if (!ok) {
+    ::unlink(tmpPath.c_str());
+    errno= err;
+    throwWriteError(path);
+  }
+
+  if (::rename(tmpPath.c_str(), path.c_str()) < 0) {
+    err= errno;
+    ::unlink(tmpPath.c_str());
+    errno= err;
+    throwWriteError(path);
+  }
+}
@@ -0,0 +1,85 @@
+#ifndef __PISTIS__ARG_PARSER__CONFIGIMAGE_HPP__
+#define __PISTIS__ARG_PARSER__CONFIGIMAGE_HPP__
+
+#include <pistis/arg_parser/MappedFile.hpp>
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** A configuration file compiled into a binary image.
+     *
+     *  The image holds the entries of a configuration file with the
+     *  argument names already resolved to handler indices and the values
+     *  already unquoted and NUL-terminated, so replaying it needs neither
+     *  tokenizing nor a handler lookup.  It records the fingerprint of
+     *  the handlers it was compiled against and the size and modification
+     *  time of the text it was compiled from.  load() rejects the image
+     *  if any of these have changed, and the caller falls back to the
+     *  text.
+     *
+     *  The image is in the host's byte order and is not meant to be
+     *  moved between machines.
+     */
+    class ConfigImage {
+    public:
+      struct Entry {
+	uint32_t handler;
+	uint32_t line;
+	uint64_t value;
+	uint64_t valueSize;
+      };
+
+    public:
+      ConfigImage();
+      ConfigImage(const ConfigImage&) = delete;
+
+      /** Map the image at path.  Returns false, leaving the image empty,
+       *  if the file does not exist, is not a valid image or does not
+       *  match the fingerprint, handler count or source.
+       */
+      bool load(const std::string& path, uint64_t fingerprint,
+		size_t numHandlers, uint64_t sourceSize,
+		int64_t sourceMtime);
+
+      size_t size() const { return numEntries_; }
+      const Entry* begin() const { return entries_; }
+      const Entry* end() const { return entries_ + numEntries_; }
+      const char* value(const Entry& e) const { return strings_ + e.value; }
+
+      ConfigImage& operator=(const ConfigImage&) = delete;
+
+    private:
+      MappedFile file_;
+      const Entry* entries_;
+      size_t numEntries_;
+      const char* strings_;
+    };
+
+    /** Collects entries and writes them out as a ConfigImage */
+    class ConfigImageWriter {
+    public:
+      ConfigImageWriter();
+
+      void add(size_t handler, size_t line, const char* value,
+	       size_t valueSize);
+
+      /** Write the image to path.  The image is written to a temporary
+       *  file that is renamed over path, so readers never see a partial
+       *  image.  Throws pistis::exceptions::IllegalValueError if the image
+       *  cannot be written.
+       */
+      void write(const std::string& path, uint64_t fingerprint,
+		 uint64_t sourceSize, int64_t sourceMtime) const;
+
+    private:
+      std::vector<ConfigImage::Entry> entries_;
+      std::vector<char> strings_;
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,193 @@
+#ifndef __PISTIS__ARG_PARSER__CONFIGWATCHER_HPP__
+#define __PISTIS__ARG_PARSER__CONFIGWATCHER_HPP__
+
+#include <pistis/arg_parser/FileWatcher.hpp>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Re-parses a command line whenever its configuration files change.
+     *
+     *  Schema must be a CmdLineSchema<Target> subclass.  The constructor
+     *  parses the command line once, throwing if it is invalid.  A
+     *  background thread then watches the configuration files the parse
+     *  read and parses the same command line again each time one of them
+     *  changes.  The environment and the files are read again, and
+     *  checkValues_() runs as it does for any parse.  A parse that fails
+     *  is reported to the error handler and the current snapshot is kept.
+     *  If the files can no longer be watched, that is reported too and
+     *  the snapshot current then is kept for good.
+     *
+     *  Each successful parse fills in a new Target, which is published
+     *  with a single atomic pointer store.  Readers get the current
+     *  snapshot with snapshot(), which is one atomic load and takes no
+     *  locks.  Snapshots are never modified once published.  A replaced
+     *  snapshot is deleted once gracePeriod has passed, so a reader must
+     *  not use a snapshot pointer for longer than that; reading
+     *  snapshot() again for each unit of work is enough.
+     */
+    template <typename Schema>
+    class ConfigWatcher {
+    public:
+      typedef typename Schema::TargetType TargetType;
+      typedef std::function<void (const std::string&)> ErrorHandler;
+
+    public:
+      ConfigWatcher(int argc, char** argv,
+		    const ErrorHandler& onError = ErrorHandler(),
+		    std::chrono::milliseconds gracePeriod =
+		        std::chrono::seconds(1)):
+	  ConfigWatcher(std::unique_ptr<Schema>(new Schema()), argc, argv,
+			onError, gracePeriod) {
+      }
+
+      ConfigWatcher(std::unique_ptr<Schema> schema, int argc, char** argv,
+		    const ErrorHandler& onError = ErrorHandler(),
+		    std::chrono::milliseconds gracePeriod =
+		        std::chrono::seconds(1)):
+	  schema_(std::move(schema)), args_(argv, argv + argc), argv_(),
+	  onError_(onError), gracePeriod_(gracePeriod), current_(nullptr),
+	  version_(0), retired_(), watcher_(), thread_() {
+	for (auto i= args_.begin(); i != args_.end(); ++i) {
+	  argv_.push_back(&(*i)[0]);
+	}
+	argv_.push_back(nullptr);
+
+	std::unique_ptr<TargetType> initial(new TargetType());
+	schema_->parse((int)args_.size(), argv_.data(), *initial);
+	watcher_.reset(new FileWatcher(schema_->configFilePaths()));
+
+	// The watcher thread may replace the snapshot as soon as it starts,
+	// so it has to be visible first, but initial keeps owning it until
+	// the thread is known to exist
+	current_.store(initial.get(), std::memory_order_release);
+	try {
+	  thread_= std::thread([this]() { run_(); });
+	} catch(...) {
+	  current_.store(nullptr, std::memory_order_release);
+	  throw;
+	}
+	initial.release();
+      }
+
+      ConfigWatcher(const ConfigWatcher&) = delete;
+
+      ~ConfigWatcher() {
+	watcher_->stop();
+	thread_.join();
+	delete current_.load(std::memory_order_acquire);
+	for (auto i= retired_.begin(); i != retired_.end(); ++i) {
+	  delete i->first;
+	}
+      }
+
+      /** The most recently published snapshot.  Never null. */
+      const TargetType* snapshot() const {
+	return current_.load(std::memory_order_acquire);
+      }
+
+      /** Number of snapshots published since the initial parse */
+      uint64_t version() const {
+	return version_.load(std::memory_order_acquire);
+      }
+
+      ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    private:
+      typedef std::chrono::steady_clock ClockType;
+
+      std::unique_ptr<Schema> schema_;
+      std::vector<std::string> args_;
+      std::vector<char*> argv_;
+      ErrorHandler onError_;
+      std::chrono::milliseconds gracePeriod_;
+      std::atomic<const TargetType*> current_;
+      std::atomic<uint64_t> version_;
+
+      // Only touched by the watcher thread until it has been joined
+      std::deque< std::pair<const TargetType*, ClockType::time_point> >
+          retired_;
+      std::unique_ptr<FileWatcher> watcher_;
+      std::thread thread_;
+
+      // Nothing may escape the watcher thread, or std::terminate() would
+      // take the whole program down with it
+      void run_() {
+	try {
+	  while (true) {
+	    const int timeout=
+	        retired_.empty() ? -1 : (int)gracePeriod_.count();
+	    const FileWatcher::Event event= watcher_->wait(timeout);
+	    if (event == FileWatcher::Event::STOPPED) {
+	      return;
+	    }
+	    freeRetired_();
+	    if (event == FileWatcher::Event::CHANGED) {
+	      reload_();
+	    }
+	  }
+	} catch(const std::exception& e) {
+	  reportError_(std::string("Stopped watching configuration files: ") +
+		       e.what());
+	} catch(...) {
+	  reportError_("Stopped watching configuration files");
+	}
+      }
+
+      // A failed reload is reported and the next change tries again
+      void reload_() {
+	std::unique_ptr<TargetType> next;
+	try {
+	  next.reset(new TargetType());
+	  schema_->parse((int)args_.size(), argv_.data(), *next);
+
+	  // Make room for the old snapshot before it is replaced, so
+	  // nothing can fail once it has been
+	  retired_.push_back(std::make_pair(nullptr, ClockType::now()));
+	} catch(const std::exception& e) {
+	  reportError_(e.what());
+	  return;
+	} catch(...) {
+	  reportError_("Unknown error");
+	  return;
+	}
+
+	retired_.back().first=
+	    current_.exchange(next.release(), std::memory_order_acq_rel);
+	version_.fetch_add(1, std::memory_order_release);
+      }
+
+      void freeRetired_() {
+	const ClockType::time_point now= ClockType::now();
+	while (!retired_.empty() &&
+	       ((now - retired_.front().second) >= gracePeriod_)) {
+	  delete retired_.front().first;
+	  retired_.pop_front();
+	}
+      }
+
+      void reportError_(const std::string& msg) {
+	if (onError_) {
+	  try {
+	    onError_(msg);
+	  } catch(...) {
+	    // The watcher thread has nowhere to send it
+	  }
+	}
+      }
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,23 @@
+#ifndef __PISTIS__ARG_PARSER__DUPLICATEKEYPOLICY_HPP__
+#define __PISTIS__ARG_PARSER__DUPLICATEKEYPOLICY_HPP__
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** What to do when a key=value argument names a key that is already
+     *  in its map destination.
+     */
+    enum class DuplicateKeyPolicy {
+      /** Reject the value as illegal */
+      REJECT,
+
+      /** Keep the value the key already has */
+      KEEP_FIRST,
+
+      /** Replace the value the key already has */
+      KEEP_LAST
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,122 @@
+#include "FileWatcher.hpp"
+#include <pistis/exceptions/IllegalStateError.hpp>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  const uint32_t WATCHED_EVENTS=
+      IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_ATTRIB;
+
+  void throwSetupError(const char* what) {
+    std::string details(what);
+    details += ": ";
+    details += strerror(errno);
+    throw pistis::exceptions::IllegalStateError(details, PISTIS_EX_HERE);
+  }
+}
+
+FileWatcher::FileWatcher(const std::vector<std::string>& paths):
+    inotifyFd_(-1), stopFds_{ -1, -1 }, watched_() {
+  inotifyFd_= inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotifyFd_ < 0) {
+    throwSetupError("Cannot initialize inotify");
+  }
+  if (pipe2(stopFds_, O_NONBLOCK | O_CLOEXEC) < 0) {
+    int err= errno;
+    ::close(inotifyFd_);
+    errno= err;
+    throwSetupError("Cannot create pipe");
+  }
+
+  for (auto i= paths.begin(); i != paths.end(); ++i) {
+    size_t slash= i->rfind('/');
+    std::string dir= (slash == std::string::npos) ? std::string(".")
+	               : (slash == 0) ? std::string("/")
+	               : i->substr(0, slash);
+    std::string name= (slash == std::string::npos) ? *i
+	                : i->substr(slash + 1);
+    int wd= inotify_add_watch(inotifyFd_, dir.c_str(), WATCHED_EVENTS);
+    if (wd < 0) {
+      int err= errno;
+      ::close(inotifyFd_);
+      ::close(stopFds_[0]);
+      ::close(stopFds_[1]);
+      errno= err;
+      throwSetupError(("Cannot watch " + dir).c_str());
+    }
+    watched_[wd].insert(name);
+  }
+}
+
+FileWatcher::~FileWatcher() {
+  ::close(inotifyFd_);
+  ::close(stopFds_[0]);
+  ::close(stopFds_[1]);
+}
+
+FileWatcher::Event FileWatcher::wait(int timeoutMs) {
+  struct pollfd fds[2];
+  fds[0].fd= stopFds_[0];
+  fds[0].events= POLLIN;
+  fds[1].fd= inotifyFd_;
+  fds[1].events= POLLIN;
+
+  while (true) {
+    fds[0].revents= 0;
+    fds[1].revents= 0;
+    int n= poll(fds, 2, timeoutMs);
+    if (n < 0) {
+      if (errno == EINTR) {
+	continue;
+      }
+      throwSetupError("Cannot poll for file changes");
+    } else if (!n) {
+      return Event::TIMEOUT;
+    } else if (fds[0].revents) {
+      return Event::STOPPED;
+    } else if (readEvents_()) {
+      return Event::CHANGED;
+    }
+    // Only other files in the watched directories changed.  Waiting
+    // again restarts the timeout, which only makes the caller's periodic
+    // work a little later.
+  }
+}
+
+void FileWatcher::stop() {
+  const char c= 0;
+  while ((::write(stopFds_[1], &c, 1) < 0) && (errno == EINTR)) {
+    // Try again
+  }
+}
+
+bool FileWatcher::readEvents_() {
+  alignas(struct inotify_event) char buffer[4096];
+  bool changed= false;
+
+  while (true) {
+    ssize_t n= ::read(inotifyFd_, buffer, sizeof(buffer));
+    if (n <= 0) {
+      // EAGAIN once the queue is empty
+      return changed;
+    }
+    for (char* p= buffer; p < buffer + n; ) {
+      const struct inotify_event* e= (const struct inotify_event*)p;
+      if (e->mask & IN_Q_OVERFLOW) {
+	changed= true;
+      } else if (e->len) {
+	auto i= watched_.find(e->wd);
+	if ((i != watched_.end()) && i->second.count(e->name)) {
+	  changed= true;
+	}
+      }
+      p += sizeof(struct inotify_event) + e->len;
+    }
+  }
+}
@@ -0,0 +1,59 @@
+#ifndef __PISTIS__ARG_PARSER__FILEWATCHER_HPP__
+#define __PISTIS__ARG_PARSER__FILEWATCHER_HPP__
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Waits for changes to a set of files using inotify.
+     *
+     *  The directories containing the files are watched rather than the
+     *  files themselves, so files replaced by renaming a new file over
+     *  them, as most editors and deployment tools do, are still noticed.
+     *  A file that does not exist yet is noticed when it is created.
+     */
+    class FileWatcher {
+    public:
+      enum class Event {
+	CHANGED,
+	TIMEOUT,
+	STOPPED
+      };
+
+    public:
+      /** Throws pistis::exceptions::IllegalStateError if inotify cannot
+       *  be set up.
+       */
+      FileWatcher(const std::vector<std::string>& paths);
+      FileWatcher(const FileWatcher&) = delete;
+      ~FileWatcher();
+
+      /** Wait until one of the files changes, timeoutMs milliseconds pass
+       *  or stop() is called.  A negative timeout waits indefinitely.
+       *  All changes pending when the call returns CHANGED are consumed,
+       *  so a burst of writes to a file is reported once.
+       */
+      Event wait(int timeoutMs);
+
+      /** Wake up a thread in wait() and make every subsequent call to
+       *  wait() return STOPPED.  May be called from any thread.
+       */
+      void stop();
+
+      FileWatcher& operator=(const FileWatcher&) = delete;
+
+    private:
+      int inotifyFd_;
+      int stopFds_[2];
+      std::unordered_map<int, std::unordered_set<std::string> > watched_;
+
+      bool readEvents_();
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,239 @@
+#include "FlagAdminServer.hpp"
+#include <pistis/exceptions/IllegalStateError.hpp>
+#include <vector>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  // Longest command accepted.  Longer lines close the connection.
+  const size_t MAX_COMMAND_SIZE= 65536;
+
+  void throwSocketError(const std::string& path, const char* what) {
+    std::string details(what);
+    details += " ";
+    details += path;
+    details += ": ";
+    details += strerror(errno);
+    throw pistis::exceptions::IllegalStateError(details, PISTIS_EX_HERE);
+  }
+
+  bool writeAll(int fd, const char* p, size_t size) {
+    while (size) {
+      ssize_t n= ::send(fd, p, size, MSG_NOSIGNAL);
+      if (n < 0) {
+	if (errno == EINTR) {
+	  continue;
+	}
+	return false;
+      }
+      p += n;
+      size -= n;
+    }
+    return true;
+  }
+
+  // Limit how long each send on fd may block to timeout milliseconds,
+  // which must be positive
+  void setSendTimeout(int fd, int64_t timeout) {
+    struct timeval sendTimeout;
+    sendTimeout.tv_sec= timeout / 1000;
+    sendTimeout.tv_usec= (timeout % 1000) * 1000;
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout,
+		 sizeof(sendTimeout));
+  }
+
+  void splitWord(const std::string& text, std::string& word,
+		 std::string& rest) {
+    size_t i= text.find(' ');
+    if (i == std::string::npos) {
+      word= text;
+      rest.clear();
+    } else {
+      size_t j= text.find_first_not_of(' ', i);
+      word= text.substr(0, i);
+      rest= (j == std::string::npos) ? std::string() : text.substr(j);
+    }
+  }
+}
+
+FlagAdminServer::FlagAdminServer(const RuntimeFlagRegistry& flags,
+				 const std::string& socketPath,
+				 std::chrono::milliseconds clientTimeout):
+    flags_(flags), socketPath_(socketPath), clientTimeout_(clientTimeout),
+    listenFd_(-1), stopFds_{ -1, -1 }, thread_() {
+  struct sockaddr_un addr;
+  if (socketPath.size() >= sizeof(addr.sun_path)) {
+    errno= ENAMETOOLONG;
+    throwSocketError(socketPath, "Cannot listen on");
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family= AF_UNIX;
+  memcpy(addr.sun_path, socketPath.c_str(), socketPath.size());
+
+  // Only replace a stale socket, never some other kind of file
+  struct stat info;
+  if ((lstat(socketPath.c_str(), &info) == 0) && S_ISSOCK(info.st_mode)) {
+    ::unlink(socketPath.c_str());
+  }
+
+  listenFd_= ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (listenFd_ < 0) {
+    throwSocketError(socketPath, "Cannot create socket for");
+  }
+
+  const mode_t oldMask= umask(0177);
+  const int bound= ::bind(listenFd_, (struct sockaddr*)&addr, sizeof(addr));
+  umask(oldMask);
+  if ((bound < 0) || (::listen(listenFd_, 4) < 0) ||
+      (pipe2(stopFds_, O_NONBLOCK | O_CLOEXEC) < 0)) {
+    int err= errno;
+    ::close(listenFd_);
+    errno= err;
+    throwSocketError(socketPath, "Cannot listen on");
+  }
+
+  thread_= std::thread([this]() { run_(); });
+}
+
+FlagAdminServer::~FlagAdminServer() {
+  const char c= 0;
+  while ((::write(stopFds_[1], &c, 1) < 0) && (errno == EINTR)) {
+    // Try again
+  }
+  thread_.join();
+  ::close(listenFd_);
+  ::close(stopFds_[0]);
+  ::close(stopFds_[1]);
+  ::unlink(socketPath_.c_str());
+}
+
+std::string FlagAdminServer::execute(const std::string& command) const {
+  std::string cmd;
+  std::string args;
+  std::string name;
+  std::string value;
+
+  splitWord(command, cmd, args);
+  try {
+    if (cmd == "list") {
+      std::string response;
+      std::vector<RuntimeFlagRegistry::FlagValue> values= flags_.values();
+      for (auto i= values.begin(); i != values.end(); ++i) {
+	response += i->name;
+	response += " ";
+	response += i->value;
+	response += "\n";
+      }
+      return response + "ok\n";
+    } else if (cmd == "get") {
+      return flags_.get(args) + "\nok\n";
+    } else if (cmd == "set") {
+      splitWord(args, name, value);
+      flags_.set(name, value);
+      return "ok\n";
+    } else {
+      return "error Unknown command \"" + cmd + "\"\n";
+    }
+  } catch(const std::exception& e) {
+    return std::string("error ") + e.what() + "\n";
+  }
+}
+
+void FlagAdminServer::run_() {
+  while (waitForInput_(listenFd_, -1)) {
+    int fd= ::accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd >= 0) {
+      serveClient_(fd);
+      ::close(fd);
+    }
+  }
+}
+
+void FlagAdminServer::serveClient_(int fd) {
+  // Every wait for a command or send of a response is bounded by the
+  // time left until the deadline, so the connection as a whole lasts no
+  // longer than clientTimeout_, however the client paces its traffic
+  typedef std::chrono::steady_clock ClockType;
+  const ClockType::time_point deadline= ClockType::now() + clientTimeout_;
+  auto timeLeft= [deadline]() {
+    return (int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+	deadline - ClockType::now()
+    ).count();
+  };
+  std::string buffer;
+  char data[4096];
+
+  while (true) {
+    int64_t timeout= timeLeft();
+    if ((timeout <= 0) || !waitForInput_(fd, (int)timeout)) {
+      return;
+    }
+
+    ssize_t n= ::read(fd, data, sizeof(data));
+    if (n < 0) {
+      if (errno == EINTR) {
+	continue;
+      }
+      return;
+    } else if (!n) {
+      return;
+    }
+    buffer.append(data, n);
+
+    size_t start= 0;
+    size_t eol;
+    while ((eol= buffer.find('\n', start)) != std::string::npos) {
+      size_t end= ((eol > start) && (buffer[eol - 1] == '\r')) ? eol - 1
+	            : eol;
+      std::string response= execute(buffer.substr(start, end - start));
+      timeout= timeLeft();
+      if (timeout <= 0) {
+	return;
+      }
+      setSendTimeout(fd, timeout);
+      if (!writeAll(fd, response.data(), response.size())) {
+	return;
+      }
+      start= eol + 1;
+    }
+    buffer.erase(0, start);
+    if (buffer.size() > MAX_COMMAND_SIZE) {
+      static const char TOO_LONG[]= "error Command is too long\n";
+      writeAll(fd, TOO_LONG, sizeof(TOO_LONG) - 1);
+      return;
+    }
+  }
+}
+
+// Returns false if the server is stopping or nothing arrives within
+// timeout milliseconds
+bool FlagAdminServer::waitForInput_(int fd, int timeout) {
+  struct pollfd fds[2];
+  fds[0].fd= stopFds_[0];
+  fds[0].events= POLLIN;
+  fds[1].fd= fd;
+  fds[1].events= POLLIN;
+
+  while (true) {
+    fds[0].revents= 0;
+    fds[1].revents= 0;
+    const int n= poll(fds, 2, timeout);
+    if (n < 0) {
+      if (errno == EINTR) {
+	continue;
+      }
+      return false;
+    }
+    return n && !fds[0].revents;
+  }
+}
@@ -0,0 +1,66 @@
+#ifndef __PISTIS__ARG_PARSER__FLAGADMINSERVER_HPP__
+#define __PISTIS__ARG_PARSER__FLAGADMINSERVER_HPP__
+
+#include <pistis/arg_parser/RuntimeFlagRegistry.hpp>
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Serves a RuntimeFlagRegistry on a Unix-domain socket.
+     *
+     *  Clients send one command per line:
+     *
+     *      list                 Prints "name value" for every flag
+     *      get <name>           Prints the value of the flag
+     *      set <name> <value>   Changes the flag; the value is the rest
+     *                           of the line
+     *
+     *  Every response ends with a line that is either "ok" or
+     *  "error <message>".  The socket is created with mode 0600, so only
+     *  the user running the program can connect.  Connections are served
+     *  one at a time on a background thread that never touches the
+     *  flags' readers.  Each connection is closed clientTimeout after
+     *  it was accepted, however busy or idle the client is, so no
+     *  client can hold up the others for longer than that.
+     */
+    class FlagAdminServer {
+    public:
+      /** Listen on socketPath, replacing any socket already there.
+       *  Throws pistis::exceptions::IllegalStateError if the socket cannot
+       *  be created.
+       */
+      FlagAdminServer(const RuntimeFlagRegistry& flags,
+		      const std::string& socketPath,
+		      std::chrono::milliseconds clientTimeout =
+		          std::chrono::seconds(5));
+      FlagAdminServer(const FlagAdminServer&) = delete;
+
+      /** Stops the server and removes the socket */
+      ~FlagAdminServer();
+
+      const std::string& socketPath() const { return socketPath_; }
+
+      /** Execute one command, returning the response */
+      std::string execute(const std::string& command) const;
+
+      FlagAdminServer& operator=(const FlagAdminServer&) = delete;
+
+    private:
+      const RuntimeFlagRegistry& flags_;
+      std::string socketPath_;
+      std::chrono::milliseconds clientTimeout_;
+      int listenFd_;
+      int stopFds_[2];
+      std::thread thread_;
+
+      void run_();
+      void serveClient_(int fd);
+      bool waitForInput_(int fd, int timeout);
+    };
+
+  }
+}
+#endif
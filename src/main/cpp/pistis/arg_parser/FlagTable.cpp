@@ -0,0 +1,45 @@
+#include "FlagTable.hpp"
+
+using namespace pistis::arg_parser;
+
+FlagTable::FlagTable(): flags_(), descriptions_(), names_(), index_() {
+  // Intentionally left blank
+}
+
+std::string FlagTable::fullNameOf(const Flag& flag) const {
+  const ArgText& name= names_[flag.name];
+  const ArgText& description= descriptions_[&flag - flags_.data()];
+  if (description.empty()) {
+    return name.str();
+  }
+
+  std::string fullName;
+  fullName.reserve(description.size() + name.size() + 3);
+  fullName.append(description.data(), description.size());
+  fullName.append(" (");
+  fullName.append(name.data(), name.size());
+  fullName.push_back(')');
+  return fullName;
+}
+
+std::string FlagTable::negatedName(const ArgText& name) {
+  std::string negated("--no-");
+  negated.append(name.data() + 2, name.size() - 2);
+  return negated;
+}
+
+void FlagTable::add(const ArgText& name, const ArgText& description,
+		    bool negatable, const Flag& flag) {
+  const uint32_t i= (uint32_t)flags_.size();
+  flags_.push_back(flag);
+  flags_.back().name= (uint32_t)names_.size();
+  descriptions_.push_back(description);
+
+  names_.push_back(name);
+  index_.insert(std::make_pair(ArgText::view(names_.back()), i << 1));
+  if (negatable) {
+    names_.push_back(ArgText(negatedName(name)));
+    index_.insert(std::make_pair(ArgText::view(names_.back()),
+				 (i << 1) | 1));
+  }
+}
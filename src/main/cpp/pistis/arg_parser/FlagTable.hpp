@@ -0,0 +1,161 @@
+#ifndef __PISTIS__ARG_PARSER__FLAGTABLE_HPP__
+#define __PISTIS__ARG_PARSER__FLAGTABLE_HPP__
+
+#include <pistis/arg_parser/ArgText.hpp>
+#include <pistis/arg_parser/SeededHash.hpp>
+#include <atomic>
+#include <bitset>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Arguments that take no value of their own, such as "--verbose".
+     *
+     *  Every flag of a SimpleCmdLineArgs is an entry in one FlagTable
+     *  rather than a handler of its own.  An entry is a few words that
+     *  say where the flag stores its value: a bool, one bit of a
+     *  std::bitset or a counter.  Several hundred flags kept in one
+     *  bitset therefore take up a single cache line, and looking up a
+     *  flag is one probe of a single hash table.
+     *
+     *  Negatable flags are also entered under "--no-" followed by the
+     *  name without its leading "--", which clears the flag.
+     */
+    class FlagTable {
+    public:
+      enum class Kind : uint8_t {
+	/** Sets or clears a bool */
+	BOOL,
+
+	/** Sets or clears one bit of a std::bitset */
+	BIT,
+
+	/** Adds one to an int every time it is given */
+	COUNT,
+
+	/** Sets or clears a std::atomic<bool> with a relaxed store */
+	ATOMIC_BOOL
+      };
+
+      typedef void (*SetBitFn)(void* bits, size_t bit, bool value);
+
+      struct Flag {
+	void* destination;
+	SetBitFn setBit;
+	uint32_t bit;
+	uint32_t name;
+	Kind kind;
+      };
+
+      /** A flag found by find(), or a null flag if there is none */
+      struct Match {
+	const Flag* flag;
+	bool negated;
+      };
+
+    public:
+      FlagTable();
+
+      size_t size() const { return flags_.size(); }
+      bool empty() const { return flags_.empty(); }
+      const Flag& operator[](size_t i) const { return flags_[i]; }
+      size_t indexOf(const Flag& flag) const { return &flag - flags_.data(); }
+
+      /** Every name flags are known by, including the "--no-" names of
+       *  negatable flags, in the order they were added.
+       */
+      const std::deque<ArgText>& names() const { return names_; }
+
+      const ArgText& nameOf(const Flag& flag) const {
+	return names_[flag.name];
+      }
+
+      /** "description (--name)", as in errors for other arguments */
+      std::string fullNameOf(const Flag& flag) const;
+
+      /** The name negatable flag name is cleared by */
+      static std::string negatedName(const ArgText& name);
+
+      bool contains(const ArgText& name) const {
+	return index_.find(ArgText::view(name)) != index_.end();
+      }
+
+      Match find(const ArgText& name) const {
+	auto i= index_.find(name);
+	if (i == index_.end()) {
+	  return Match{ nullptr, false };
+	}
+	return Match{ &flags_[i->second >> 1], (i->second & 1) != 0 };
+      }
+
+      /** Add a flag.  The caller makes sure none of its names are
+       *  already in use.
+       */
+      void add(const ArgText& name, const ArgText& description,
+	       bool negatable, const Flag& flag);
+
+      static Flag boolFlag(bool& value) {
+	return Flag{ &value, nullptr, 0, 0, Kind::BOOL };
+      }
+
+      template <size_t N>
+      static Flag bitFlag(std::bitset<N>& bits, size_t bit) {
+	return Flag{ &bits, &setBit_<N>, (uint32_t)bit, 0, Kind::BIT };
+      }
+
+      static Flag countingFlag(int& count) {
+	return Flag{ &count, nullptr, 0, 0, Kind::COUNT };
+      }
+
+      static Flag atomicFlag(std::atomic<bool>& value) {
+	return Flag{ &value, nullptr, 0, 0, Kind::ATOMIC_BOOL };
+      }
+
+      /** Set or clear flag, or count it once if it counts */
+      static void apply(const Flag& flag, bool value) {
+	switch (flag.kind) {
+	  case Kind::BOOL:
+	    *static_cast<bool*>(flag.destination)= value;
+	    break;
+
+	  case Kind::BIT:
+	    flag.setBit(flag.destination, flag.bit, value);
+	    break;
+
+	  case Kind::COUNT:
+	    ++*static_cast<int*>(flag.destination);
+	    break;
+
+	  case Kind::ATOMIC_BOOL:
+	    static_cast<std::atomic<bool>*>(flag.destination)->store(
+	        value, std::memory_order_relaxed
+	    );
+	    break;
+	}
+      }
+
+    private:
+      std::vector<Flag> flags_;
+      std::vector<ArgText> descriptions_;
+
+      // Keys of index_ refer to these names, which never move
+      std::deque<ArgText> names_;
+
+      // Index of the flag times two, plus one for "--no-" names
+      std::unordered_map<ArgText, uint32_t, SeededHash<ArgText> > index_;
+
+      template <size_t N>
+      static void setBit_(void* bits, size_t bit, bool value) {
+	(*static_cast<std::bitset<N>*>(bits))[bit]= value;
+      }
+    };
+
+  }
+}
+#endif
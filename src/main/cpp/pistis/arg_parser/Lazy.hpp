@@ -0,0 +1,139 @@
+#ifndef __PISTIS__ARG_PARSER__LAZY_HPP__
+#define __PISTIS__ARG_PARSER__LAZY_HPP__
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace pistis {
+  namespace arg_parser {
+
+    class SimpleCmdLineArgs;
+
+    /** Converts the tokens recorded for a Lazy value into that value */
+    class LazyConverter {
+    public:
+      virtual ~LazyConverter() { }
+      virtual void convert(const std::vector<const char*>& tokens) = 0;
+    };
+
+    /** The part of Lazy that does not depend on the type of its value */
+    class LazyBase {
+    public:
+      LazyBase(): tokens_(), copies_(), converter_(nullptr),
+		  converted_(false) {
+	// Intentionally left blank
+      }
+      LazyBase(const LazyBase&) = delete;
+      virtual ~LazyBase() { }
+
+      /** Whether the argument was given in the last parse */
+      bool given() const { return !tokens_.empty(); }
+
+      /** The text of every value given for the argument in the last
+       *  parse, in the order they were given.
+       */
+      const std::vector<const char*>& tokens() const { return tokens_; }
+
+      /** Whether the value has been converted since the last parse */
+      bool converted() const { return converted_; }
+
+      /** Convert the value if it has not been converted yet, throwing
+       *  IllegalValueError if any of its tokens is illegal.
+       */
+      virtual void validate() const = 0;
+
+      LazyBase& operator=(const LazyBase&) = delete;
+
+    protected:
+      void convert_() const {
+	if (converter_) {
+	  converter_->convert(tokens_);
+	}
+	converted_= true;
+      }
+
+    private:
+      std::vector<const char*> tokens_;
+
+      // Copies of tokens that do not come from the parsed argv
+      std::deque<std::string> copies_;
+      LazyConverter* converter_;
+      mutable bool converted_;
+
+      void reset_() {
+	tokens_.clear();
+	copies_.clear();
+	converted_= false;
+      }
+
+      void addToken_(const char* token) { tokens_.push_back(token); }
+
+      void addCopy_(const char* token) {
+	copies_.push_back(token);
+	tokens_.push_back(copies_.back().c_str());
+      }
+
+      friend class SimpleCmdLineArgs;
+    };
+
+    /** A destination whose value is converted when it is first used
+     *  rather than while parsing.
+     *
+     *  parse() only records where the text for a Lazy destination is.
+     *  The text is converted and checked the first time get() is
+     *  called, and the result is kept until the next parse, so a
+     *  program that uses a few of many arguments only pays to convert
+     *  those.  Errors in the text are thrown by get() as
+     *  IllegalValueError, just as parse() would throw them; call
+     *  SimpleCmdLineArgs::validateAll() to find them all at once.
+     *
+     *  ParseLimits::maxListElements is checked against the text during
+     *  parse().  ParseLimits::maxContainerBytes can only be checked once
+     *  the items are converted, so get() throws
+     *  ResourceLimitExceededError if the converted value, together with
+     *  everything stored by the last parse and by earlier conversions
+     *  since then, is over the limit.  ParseStats and ParseObserver
+     *  events for a Lazy argument cover recording its text during
+     *  parse(), not the conversion.
+     *
+     *  The recorded text refers to the argv given to parse(), which
+     *  must outlive any conversion, as must the SimpleCmdLineArgs the
+     *  destination was registered with.  Lazy values are not safe to
+     *  convert from several threads at once.
+     */
+    template <typename Value>
+    class Lazy : public LazyBase {
+    public:
+      Lazy(): LazyBase(), value_(), defaultValue_() {
+	// Intentionally left blank
+      }
+
+      explicit Lazy(const Value& defaultValue):
+	  LazyBase(), value_(defaultValue), defaultValue_(defaultValue) {
+	// Intentionally left blank
+      }
+
+      const Value& get() const {
+	if (!converted()) {
+	  value_= defaultValue_;
+	  convert_();
+	}
+	return value_;
+      }
+
+      const Value& operator*() const { return get(); }
+      const Value* operator->() const { return &get(); }
+
+      virtual void validate() const { get(); }
+
+    private:
+      mutable Value value_;
+      Value defaultValue_;
+
+      friend class SimpleCmdLineArgs;
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,57 @@
+#include "MappedArray.hpp"
+#include <pistis/exceptions/IllegalValueError.hpp>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  const std::string NO_PATH;
+
+  bool endsWith(const std::string& s, const std::string& suffix) {
+    return (s.size() >= suffix.size()) &&
+	   !s.compare(s.size() - suffix.size(), suffix.size(), suffix);
+  }
+
+  void throwArrayError(const std::string& path, const std::string& details) {
+    throw pistis::exceptions::IllegalValueError("path", path, details,
+						PISTIS_EX_HERE);
+  }
+}
+
+MappedArrayBase::MappedArrayBase(): file_(), size_(0) {
+  // Intentionally left blank
+}
+
+const std::string& MappedArrayBase::path() const {
+  return file_ ? file_->path() : NO_PATH;
+}
+
+void MappedArrayBase::map_(const std::string& path, const char* suffix,
+			   size_t elementSize) {
+  const std::string type= std::string(".") + suffix;
+  if (!endsWith(path, type)) {
+    throwArrayError(path, "File name must end in \"" + type + "\"");
+  }
+
+  // Single bytes have no byte order
+  const std::string order= path.substr(0, path.size() - type.size());
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  const bool bigEndian= true;
+#else
+  const bool bigEndian= false;
+#endif
+  if ((elementSize > 1) && (endsWith(order, ".be") != bigEndian)) {
+    throwArrayError(path, bigEndian
+		      ? "Elements are little-endian, but this machine is not"
+		      : "Elements are big-endian, but this machine is not");
+  }
+
+  std::shared_ptr<const MappedFile> file(new MappedFile(path));
+  if (file->size() % elementSize) {
+    throwArrayError(path, "File size " + std::to_string(file->size()) +
+			  " is not a multiple of " +
+			  std::to_string(elementSize) + " bytes");
+  }
+
+  file_= std::move(file);
+  size_= file_->size() / elementSize;
+}
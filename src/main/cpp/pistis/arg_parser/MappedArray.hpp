@@ -0,0 +1,154 @@
+#ifndef __PISTIS__ARG_PARSER__MAPPEDARRAY_HPP__
+#define __PISTIS__ARG_PARSER__MAPPEDARRAY_HPP__
+
+#include <pistis/arg_parser/MappedFile.hpp>
+#include <memory>
+#include <string>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Names the element type of a MappedArray in the suffix of its
+     *  file.  Only the types specialized here can be mapped.
+     */
+    template <typename T>
+    struct MappedArrayType {
+      static_assert(sizeof(T) == 0,
+		    "Unsupported MappedArray element type");
+    };
+
+    template <> struct MappedArrayType<int8_t> {
+      static const char* suffix() { return "i8"; }
+    };
+
+    template <> struct MappedArrayType<uint8_t> {
+      static const char* suffix() { return "u8"; }
+    };
+
+    template <> struct MappedArrayType<int16_t> {
+      static const char* suffix() { return "i16"; }
+    };
+
+    template <> struct MappedArrayType<uint16_t> {
+      static const char* suffix() { return "u16"; }
+    };
+
+    template <> struct MappedArrayType<int32_t> {
+      static const char* suffix() { return "i32"; }
+    };
+
+    template <> struct MappedArrayType<uint32_t> {
+      static const char* suffix() { return "u32"; }
+    };
+
+    template <> struct MappedArrayType<int64_t> {
+      static const char* suffix() { return "i64"; }
+    };
+
+    template <> struct MappedArrayType<uint64_t> {
+      static const char* suffix() { return "u64"; }
+    };
+
+    template <> struct MappedArrayType<float> {
+      static const char* suffix() { return "f32"; }
+    };
+
+    template <> struct MappedArrayType<double> {
+      static const char* suffix() { return "f64"; }
+    };
+
+    /** The part of MappedArray that does not depend on its element type */
+    class MappedArrayBase {
+    public:
+      /** Path of the mapped file, or empty if nothing is mapped */
+      const std::string& path() const;
+
+      size_t size() const { return size_; }
+      bool empty() const { return !size_; }
+
+    protected:
+      MappedArrayBase();
+
+      const void* data_() const { return file_ ? file_->data() : nullptr; }
+
+      /** Map the file at path, whose name must end in ".<suffix>",
+       *  ".le.<suffix>" or ".be.<suffix>".  The elements are little-endian
+       *  unless the name ends in ".be.<suffix>".  Throws
+       *  pistis::exceptions::IllegalValueError if the name does not name
+       *  the element type, the byte order is not that of this machine,
+       *  the size of the file is not a multiple of elementSize or the
+       *  file cannot be mapped.  Leaves the array unchanged on error.
+       */
+      void map_(const std::string& path, const char* suffix,
+		size_t elementSize);
+
+    private:
+      std::shared_ptr<const MappedFile> file_;
+      size_t size_;
+    };
+
+    /** A read-only array of numbers mapped from a binary file.
+     *
+     *  The elements are used in place, so an array of any size costs
+     *  no more to bind than to open its file.  The file holds nothing
+     *  but the elements: its name says their type and byte order, as in
+     *  "embedding.f32" or "ids.be.u64" (see MappedArrayBase::map_()).
+     *  Copies share the mapping, which is released when the last of
+     *  them is destroyed or maps another file.  The file must not be
+     *  changed while it is mapped.
+     */
+    template <typename T>
+    class MappedArray : public MappedArrayBase {
+    public:
+      typedef T value_type;
+      typedef const T* const_iterator;
+
+    public:
+      MappedArray(): MappedArrayBase() {
+	// Intentionally left blank
+      }
+
+      const T* data() const { return static_cast<const T*>(data_()); }
+      const T* begin() const { return data(); }
+      const T* end() const { return data() + size(); }
+      const T& operator[](size_t i) const { return data()[i]; }
+
+      /** Map the file at path in place of the current one */
+      void map(const std::string& path) {
+	map_(path, MappedArrayType<T>::suffix(), sizeof(T));
+      }
+
+      /** Index of the first element that is not between minValue and
+       *  maxValue (inclusive), or size() if there is none.  NaN is never
+       *  in range.
+       */
+      size_t findOutOfRange(T minValue, T maxValue) const {
+	// Test blocks of elements without branches, which compilers turn
+	// into vector instructions, and only look for the element itself
+	// in a block that fails
+	static const size_t BLOCK_SIZE= 4096;
+	const T* const p= data();
+	const size_t n= size();
+	for (size_t i= 0; i < n; i += BLOCK_SIZE) {
+	  const size_t end= (n - i < BLOCK_SIZE) ? n : i + BLOCK_SIZE;
+	  unsigned outside= 0;
+	  for (size_t j= i; j < end; ++j) {
+	    outside |= !(p[j] >= minValue) | !(p[j] <= maxValue);
+	  }
+	  if (outside) {
+	    for (size_t j= i; ; ++j) {
+	      if (!((p[j] >= minValue) && (p[j] <= maxValue))) {
+		return j;
+	      }
+	    }
+	  }
+	}
+	return n;
+      }
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,99 @@
+#include "MappedFile.hpp"
+#include <pistis/exceptions/IllegalValueError.hpp>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  // An empty file cannot be mapped, so empty files point here instead
+  const char EMPTY_FILE[]= "";
+
+  void throwMappingError(const std::string& path, const char* what) {
+    std::string details(what);
+    details += ": ";
+    details += strerror(errno);
+    throw pistis::exceptions::IllegalValueError("path", path, details,
+						PISTIS_EX_HERE);
+  }
+}
+
+MappedFile::MappedFile():
+    path_(), data_(EMPTY_FILE), size_(0), mtime_(0) {
+  // Intentionally left blank
+}
+
+MappedFile::MappedFile(const std::string& path):
+    path_(path), data_(EMPTY_FILE), size_(0), mtime_(0) {
+  int fd= ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throwMappingError(path, "Cannot open file");
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) < 0) {
+    int err= errno;
+    ::close(fd);
+    errno= err;
+    throwMappingError(path, "Cannot stat file");
+  }
+  // Pipes, devices and the like report a size of zero however much they
+  // hold, so mapping them would silently give an empty file
+  if (!S_ISREG(info.st_mode)) {
+    ::close(fd);
+    throw pistis::exceptions::IllegalValueError(
+        "path", path, "Not a regular file", PISTIS_EX_HERE
+    );
+  }
+  mtime_= (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+
+  if (info.st_size > 0) {
+    void* p= mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+      int err= errno;
+      ::close(fd);
+      errno= err;
+      throwMappingError(path, "Cannot map file");
+    }
+    madvise(p, info.st_size, MADV_SEQUENTIAL);
+    data_= (const char*)p;
+    size_= info.st_size;
+  }
+  ::close(fd);
+}
+
+MappedFile::MappedFile(MappedFile&& other):
+    path_(std::move(other.path_)), data_(other.data_), size_(other.size_),
+    mtime_(other.mtime_) {
+  other.data_= EMPTY_FILE;
+  other.size_= 0;
+}
+
+MappedFile::~MappedFile() {
+  unmap_();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+  if (this != &other) {
+    unmap_();
+    path_= std::move(other.path_);
+    data_= other.data_;
+    size_= other.size_;
+    mtime_= other.mtime_;
+    other.data_= EMPTY_FILE;
+    other.size_= 0;
+  }
+  return *this;
+}
+
+void MappedFile::unmap_() {
+  if (size_) {
+    munmap(const_cast<char*>(data_), size_);
+    data_= EMPTY_FILE;
+    size_= 0;
+  }
+}
@@ -0,0 +1,51 @@
+#ifndef __PISTIS__ARG_PARSER__MAPPEDFILE_HPP__
+#define __PISTIS__ARG_PARSER__MAPPEDFILE_HPP__
+
+#include <string>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** A file mapped read-only into memory */
+    class MappedFile {
+    public:
+      MappedFile();
+
+      /** Map the file at path.  Throws
+       *  pistis::exceptions::IllegalValueError if the file cannot be
+       *  opened or mapped, or is not a regular file.
+       */
+      MappedFile(const std::string& path);
+      MappedFile(const MappedFile&) = delete;
+      MappedFile(MappedFile&& other);
+      ~MappedFile();
+
+      const std::string& path() const { return path_; }
+      const char* data() const { return data_; }
+      const char* begin() const { return data_; }
+      const char* end() const { return data_ + size_; }
+      size_t size() const { return size_; }
+      bool empty() const { return !size_; }
+
+      /** Modification time of the file when it was mapped, in nanoseconds
+       *  since the epoch.
+       */
+      int64_t modificationTime() const { return mtime_; }
+
+      MappedFile& operator=(const MappedFile&) = delete;
+      MappedFile& operator=(MappedFile&& other);
+
+    private:
+      std::string path_;
+      const char* data_;
+      size_t size_;
+      int64_t mtime_;
+
+      void unmap_();
+    };
+
+  }
+}
+#endif
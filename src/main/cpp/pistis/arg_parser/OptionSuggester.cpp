@@ -0,0 +1,182 @@
+#include "OptionSuggester.hpp"
+#include <algorithm>
+#include <string.h>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  inline unsigned bucket(unsigned char c) {
+    if ((c >= 'a') && (c <= 'z')) {
+      return c - 'a';
+    } else if ((c >= 'A') && (c <= 'Z')) {
+      return 26 + (c - 'A');
+    } else if ((c >= '0') && (c <= '9')) {
+      return 52 + (c - '0');
+    } else {
+      return 62 + (c & 1);
+    }
+  }
+
+  /** Which buckets of characters occur in s.  One edit changes at most
+   *  two bits, so the edit distance between two strings is at least half
+   *  the number of bits in which their signatures differ.
+   */
+  uint64_t signatureOf(const char* s, size_t n) {
+    uint64_t sig= 0;
+    for (size_t i= 0; i < n; ++i) {
+      sig |= 1ULL << bucket((unsigned char)s[i]);
+    }
+    return sig;
+  }
+
+  size_t maxDistanceFor(const std::string& query) {
+    size_t n= query.size() - std::min(query.find_first_not_of('-'),
+				      query.size());
+    return (n <= 3) ? 1 : (n <= 6) ? 2 : 3;
+  }
+
+  /** Myers' algorithm, as reformulated by Hyyrö for edit distance rather
+   *  than approximate search.  Column j of the dynamic-programming
+   *  matrix is held as bit vectors of the vertical differences between
+   *  adjacent rows, and the whole column is updated with a handful of
+   *  word operations.  Requires 0 < m <= 64.
+   */
+  size_t myersDistance(const uint64_t* peq, size_t m, const char* text,
+		       size_t n, size_t maxDistance) {
+    const uint64_t last= 1ULL << (m - 1);
+    uint64_t pv= ~0ULL;
+    uint64_t mv= 0;
+    size_t score= m;
+
+    for (size_t j= 0; j < n; ++j) {
+      const uint64_t eq= peq[(unsigned char)text[j]];
+      const uint64_t xv= eq | mv;
+      const uint64_t xh= (((eq & pv) + pv) ^ pv) | eq;
+      uint64_t ph= mv | ~(xh | pv);
+      uint64_t mh= pv & xh;
+
+      if (ph & last) {
+	++score;
+      } else if (mh & last) {
+	--score;
+      }
+
+      // The first row of the matrix is 0, 1, 2, ..., so every horizontal
+      // difference entering from above is +1
+      ph= (ph << 1) | 1;
+      mh <<= 1;
+      pv= mh | ~(xv | ph);
+      mv= ph & xv;
+
+      // The score falls by at most one per remaining character
+      if (score > maxDistance + (n - j - 1)) {
+	return maxDistance + 1;
+      }
+    }
+    return (score <= maxDistance) ? score : maxDistance + 1;
+  }
+
+  size_t rowDistance(const std::string& a, const std::string& b,
+		     size_t maxDistance) {
+    std::vector<size_t> prev(a.size() + 1);
+    std::vector<size_t> cur(a.size() + 1);
+    for (size_t i= 0; i <= a.size(); ++i) {
+      prev[i]= i;
+    }
+    for (size_t j= 1; j <= b.size(); ++j) {
+      cur[0]= j;
+      size_t best= cur[0];
+      for (size_t i= 1; i <= a.size(); ++i) {
+	cur[i]= std::min(std::min(prev[i] + 1, cur[i - 1] + 1),
+			 prev[i - 1] + ((a[i - 1] == b[j - 1]) ? 0 : 1));
+	best= std::min(best, cur[i]);
+      }
+      if (best > maxDistance) {
+	return maxDistance + 1;
+      }
+      prev.swap(cur);
+    }
+    return std::min(prev[a.size()], maxDistance + 1);
+  }
+
+  void buildPeq(const std::string& pattern, uint64_t* peq) {
+    memset(peq, 0, 256 * sizeof(uint64_t));
+    for (size_t i= 0; i < pattern.size(); ++i) {
+      peq[(unsigned char)pattern[i]] |= 1ULL << i;
+    }
+  }
+}
+
+OptionSuggester::OptionSuggester(): names_(), lengths_(), signatures_() {
+  // Intentionally left blank
+}
+
+void OptionSuggester::add(const std::string& name) {
+  names_.push_back(name);
+  lengths_.push_back((uint32_t)name.size());
+  signatures_.push_back(signatureOf(name.data(), name.size()));
+}
+
+std::vector<std::string> OptionSuggester::suggest(const std::string& query,
+						  size_t maxResults) const {
+  std::vector<std::string> results;
+  if (query.empty() || !maxResults) {
+    return results;
+  }
+
+  const size_t maxDistance= maxDistanceFor(query);
+  const size_t m= query.size();
+  const uint64_t sig= signatureOf(query.data(), m);
+  uint64_t peq[256];
+  if (m <= 64) {
+    buildPeq(query, peq);
+  }
+
+  // Only names at the smallest distance seen so far are kept, so the
+  // bound tightens as closer names are found
+  size_t best= maxDistance;
+  std::vector<size_t> found;
+  for (size_t i= 0; i < names_.size(); ++i) {
+    const size_t n= lengths_[i];
+    if (((n > m) ? (n - m) : (m - n)) > best) {
+      continue;
+    }
+    if ((size_t)__builtin_popcountll(sig ^ signatures_[i]) > 2 * best) {
+      continue;
+    }
+
+    const std::string& name= names_[i];
+    const size_t d= (m <= 64) ? myersDistance(peq, m, name.data(), n, best)
+                              : rowDistance(query, name, best);
+    if (d < best) {
+      best= d;
+      found.clear();
+    }
+    if (d <= best) {
+      found.push_back(i);
+    }
+  }
+
+  for (auto i= found.begin(); i != found.end(); ++i) {
+    results.push_back(names_[*i]);
+  }
+  std::sort(results.begin(), results.end());
+  if (results.size() > maxResults) {
+    results.resize(maxResults);
+  }
+  return results;
+}
+
+size_t OptionSuggester::editDistance(const std::string& a,
+				     const std::string& b,
+				     size_t maxDistance) {
+  if (a.empty() || b.empty()) {
+    return std::min(std::max(a.size(), b.size()), maxDistance + 1);
+  } else if (a.size() > 64) {
+    return rowDistance(a, b, maxDistance);
+  }
+
+  uint64_t peq[256];
+  buildPeq(a, peq);
+  return myersDistance(peq, a.size(), b.data(), b.size(), maxDistance);
+}
@@ -0,0 +1,51 @@
+#ifndef __PISTIS__ARG_PARSER__OPTIONSUGGESTER_HPP__
+#define __PISTIS__ARG_PARSER__OPTIONSUGGESTER_HPP__
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Finds the registered option names closest to a mistyped one.
+     *
+     *  Names within a small edit distance of the query are found by a
+     *  scan over all names.  Most names are rejected by comparing their
+     *  length and a 64-bit signature of the characters they contain, which
+     *  are kept in arrays of their own so the scan touches little memory.
+     *  The remaining names are compared with Myers' bit-parallel edit
+     *  distance, which processes one character of the name per step and
+     *  stops once the distance bound cannot be met.
+     */
+    class OptionSuggester {
+    public:
+      OptionSuggester();
+
+      size_t size() const { return names_.size(); }
+
+      void add(const std::string& name);
+
+      /** The names at the smallest edit distance from query, up to
+       *  maxResults of them in byte order.  Names further away than a
+       *  bound that grows with the length of query are never suggested.
+       */
+      std::vector<std::string> suggest(const std::string& query,
+				       size_t maxResults = 5) const;
+
+      /** Edit distance between a and b, or maxDistance + 1 if it is
+       *  greater than maxDistance.
+       */
+      static size_t editDistance(const std::string& a, const std::string& b,
+				 size_t maxDistance);
+
+    private:
+      std::vector<std::string> names_;
+      std::vector<uint32_t> lengths_;
+      std::vector<uint64_t> signatures_;
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,5 @@
+#include "ParseLimits.hpp"
+
+using namespace pistis::arg_parser;
+
+const size_t ParseLimits::UNLIMITED;
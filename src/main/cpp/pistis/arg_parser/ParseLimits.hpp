@@ -0,0 +1,49 @@
+#ifndef __PISTIS__ARG_PARSER__PARSELIMITS_HPP__
+#define __PISTIS__ARG_PARSER__PARSELIMITS_HPP__
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Bounds on the work a single parse will do, for command lines that
+     *  come from sources that are not fully trusted.  A parse that would
+     *  exceed one throws ResourceLimitExceededError.  Every limit starts
+     *  out as UNLIMITED.
+     */
+    struct ParseLimits {
+      static const size_t UNLIMITED= SIZE_MAX;
+
+      /** Arguments after the program name */
+      size_t maxTokens;
+
+      /** Bytes in a single argument */
+      size_t maxTokenSize;
+
+      /** Items in a single separated list value */
+      size_t maxListElements;
+
+      /** Bytes added to vector and set destinations during one parse.
+       *  A value counts as its size, plus the length of its text for
+       *  strings.
+       */
+      size_t maxContainerBytes;
+
+      /** Times any one named argument may be given */
+      size_t maxOccurrences;
+
+      ParseLimits():
+	  maxTokens(UNLIMITED), maxTokenSize(UNLIMITED),
+	  maxListElements(UNLIMITED), maxContainerBytes(UNLIMITED),
+	  maxOccurrences(UNLIMITED) {
+      }
+
+      bool limitsTokens() const {
+	return (maxTokens != UNLIMITED) || (maxTokenSize != UNLIMITED);
+      }
+    };
+
+  }
+}
+#endif
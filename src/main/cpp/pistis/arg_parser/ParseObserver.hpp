@@ -0,0 +1,37 @@
+#ifndef __PISTIS__ARG_PARSER__PARSEOBSERVER_HPP__
+#define __PISTIS__ARG_PARSER__PARSEOBSERVER_HPP__
+
+#include <string>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Receives an event when SimpleCmdLineArgs starts and finishes each
+     *  call to an argument's handler and to its initValues_() and
+     *  checkValues_() hooks.
+     *
+     *  Every begin() is matched by an end(), even when the call throws.
+     *  end() may be called while an exception is propagating, so neither
+     *  method may throw.
+     */
+    class ParseObserver {
+    public:
+      enum class Event {
+	HANDLE_VALUE,
+	INIT_VALUES,
+	CHECK_VALUES
+      };
+
+    public:
+      virtual ~ParseObserver() { }
+
+      /** For HANDLE_VALUE, name is the name the argument was registered
+       *  with.  Otherwise it is the name of the hook.
+       */
+      virtual void begin(Event event, const std::string& name) = 0;
+      virtual void end(Event event, const std::string& name) = 0;
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,42 @@
+#include "ParseStats.hpp"
+#include <atomic>
+#include <chrono>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  std::atomic<ParseStats::AllocationCounter> allocationCounter_(nullptr);
+}
+
+ParseStats::ParseStats() {
+  reset();
+}
+
+void ParseStats::reset() {
+  parses= 0;
+  tokens= 0;
+  handlerInvocations= 0;
+  allocations= 0;
+  bytesAllocated= 0;
+  exceptions= 0;
+  initTime= 0;
+  tokenizeTime= 0;
+  dispatchTime= 0;
+  conversionTime= 0;
+  checkTime= 0;
+  checkValuesTime= 0;
+}
+
+ParseStats::AllocationCounter ParseStats::allocationCounter() {
+  return allocationCounter_.load(std::memory_order_acquire);
+}
+
+void ParseStats::setAllocationCounter(AllocationCounter counter) {
+  allocationCounter_.store(counter, std::memory_order_release);
+}
+
+uint64_t ParseStats::now() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()
+  ).count();
+}
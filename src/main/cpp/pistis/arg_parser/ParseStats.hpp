@@ -0,0 +1,71 @@
+#ifndef __PISTIS__ARG_PARSER__PARSESTATS_HPP__
+#define __PISTIS__ARG_PARSER__PARSESTATS_HPP__
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Counters and timings collected by AbstractCmdLineArgs::parse().
+     *
+     *  Collection is opt-in: pass a ParseStats to setParseStats() and
+     *  every following parse adds to it until setParseStats(nullptr) is
+     *  called.  Without one, parse() takes the same path it always has and
+     *  pays a single pointer test per handler invocation.  Times are in
+     *  nanoseconds of std::chrono::steady_clock.
+     *
+     *  Heap allocations can only be counted by the program, which must
+     *  replace operator new to do it.  It reports its running totals
+     *  through the function given to setAllocationCounter(), and each
+     *  parse records the difference between the totals before and after.
+     */
+    struct ParseStats {
+      /** Stores the number of allocations and bytes allocated so far */
+      typedef void (*AllocationCounter)(uint64_t& allocations,
+					uint64_t& bytes);
+
+      uint64_t parses;
+      uint64_t tokens;
+      uint64_t handlerInvocations;
+      uint64_t allocations;
+      uint64_t bytesAllocated;
+
+      /** Parses ended by an exception */
+      uint64_t exceptions;
+
+      uint64_t initTime;
+
+      /** Time spent splitting the command line into arguments */
+      uint64_t tokenizeTime;
+
+      /** Time spent finding the handler for each argument, excluding the
+       *  handler itself
+       */
+      uint64_t dispatchTime;
+
+      /** Time spent in handlers converting and storing values, including
+       *  values from the environment and configuration files
+       */
+      uint64_t conversionTime;
+
+      /** Time spent in check_(), including checkValues_() and values
+       *  applied from the environment and configuration files
+       */
+      uint64_t checkTime;
+      uint64_t checkValuesTime;
+
+      ParseStats();
+
+      void reset();
+
+      static AllocationCounter allocationCounter();
+      static void setAllocationCounter(AllocationCounter counter);
+
+      /** Current value of steady_clock in nanoseconds */
+      static uint64_t now();
+    };
+
+  }
+}
+#endif
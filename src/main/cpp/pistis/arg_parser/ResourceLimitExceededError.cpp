@@ -0,0 +1,25 @@
+#include "ResourceLimitExceededError.hpp"
+#include <sstream>
+
+using namespace pistis::arg_parser;
+
+ResourceLimitExceededError::ResourceLimitExceededError(
+    const std::string& appName, const std::string& argName,
+    const std::string& quantity, size_t limit
+):
+    CmdLineArgError(appName, createMessage_(argName, quantity, limit)),
+    argName_(argName), quantity_(quantity), limit_(limit) {
+  // Intentionally left blank
+}
+
+std::string ResourceLimitExceededError::createMessage_(
+    const std::string& argName, const std::string& quantity, size_t limit
+) {
+  std::ostringstream msg;
+  msg << quantity;
+  if (!argName.empty()) {
+    msg << " for command-line argument " << argName;
+  }
+  msg << " exceeds the limit of " << limit;
+  return msg.str();
+}
@@ -0,0 +1,39 @@
+#ifndef __PISTIS__ARG_PARSER__RESOURCELIMITEXCEEDEDERROR_HPP__
+#define __PISTIS__ARG_PARSER__RESOURCELIMITEXCEEDEDERROR_HPP__
+
+#include <pistis/arg_parser/CmdLineArgError.hpp>
+#include <string>
+#include <stddef.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Thrown when a parse exceeds one of its ParseLimits */
+    class ResourceLimitExceededError : public CmdLineArgError {
+    public:
+      /** quantity describes what was limited, e.g. "Number of list
+       *  elements".  argName is empty if the limit is not specific to
+       *  one argument.
+       */
+      ResourceLimitExceededError(const std::string& appName,
+				 const std::string& argName,
+				 const std::string& quantity,
+				 size_t limit);
+
+      const std::string& argName() const { return argName_; }
+      const std::string& quantity() const { return quantity_; }
+      size_t limit() const { return limit_; }
+
+    private:
+      std::string argName_;
+      std::string quantity_;
+      size_t limit_;
+
+      static std::string createMessage_(const std::string& argName,
+					const std::string& quantity,
+					size_t limit);
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,53 @@
+#include "RuntimeFlagRegistry.hpp"
+#include <pistis/exceptions/IllegalStateError.hpp>
+#include <pistis/exceptions/IllegalValueError.hpp>
+
+using namespace pistis::arg_parser;
+
+RuntimeFlagRegistry::RuntimeFlagRegistry(): flags_() {
+  // Intentionally left blank
+}
+
+void RuntimeFlagRegistry::add(const std::string& name,
+			      const std::string& description,
+			      const Getter& getter, const Setter& setter) {
+  if (!flags_.insert(std::make_pair(name,
+				    Flag_{ description, getter, setter }))
+             .second) {
+    throw pistis::exceptions::IllegalStateError(
+        "Flag \"" + name + "\" is already registered", PISTIS_EX_HERE
+    );
+  }
+}
+
+std::string RuntimeFlagRegistry::get(const std::string& name) const {
+  return find_(name).getter();
+}
+
+void RuntimeFlagRegistry::set(const std::string& name,
+			      const std::string& value) const {
+  find_(name).setter(value);
+}
+
+std::vector<RuntimeFlagRegistry::FlagValue>
+    RuntimeFlagRegistry::values() const {
+  std::vector<FlagValue> result;
+  result.reserve(flags_.size());
+  for (auto i= flags_.begin(); i != flags_.end(); ++i) {
+    result.push_back(FlagValue{ i->first, i->second.description,
+	                        i->second.getter() });
+  }
+  return result;
+}
+
+const RuntimeFlagRegistry::Flag_& RuntimeFlagRegistry::find_(
+    const std::string& name
+) const {
+  auto i= flags_.find(name);
+  if (i == flags_.end()) {
+    throw pistis::exceptions::IllegalValueError(
+        "name", name, "No such flag", PISTIS_EX_HERE
+    );
+  }
+  return i->second;
+}
@@ -0,0 +1,78 @@
+#ifndef __PISTIS__ARG_PARSER__RUNTIMEFLAGREGISTRY_HPP__
+#define __PISTIS__ARG_PARSER__RUNTIMEFLAGREGISTRY_HPP__
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Options whose values can be listed and changed while the program
+     *  runs.
+     *
+     *  SimpleCmdLineArgs adds every option registered with a std::atomic
+     *  destination.  Setting a flag converts and checks the new value with
+     *  the same formatter the option uses on the command line, then stores
+     *  it with a single atomic store, so code reading the destination
+     *  needs nothing more than a relaxed atomic load.  Flags are added
+     *  while the options are registered; once that is done, get(), set()
+     *  and values() may be called from any thread.
+     */
+    class RuntimeFlagRegistry {
+    public:
+      typedef std::function<std::string ()> Getter;
+
+      /** Converts, checks and stores a new value.  Throws
+       *  pistis::exceptions::IllegalValueError if the value is not legal.
+       */
+      typedef std::function<void (const std::string&)> Setter;
+
+      struct FlagValue {
+	std::string name;
+	std::string description;
+	std::string value;
+      };
+
+    public:
+      RuntimeFlagRegistry();
+
+      bool empty() const { return flags_.empty(); }
+      size_t size() const { return flags_.size(); }
+      bool has(const std::string& name) const {
+	return flags_.find(name) != flags_.end();
+      }
+
+      void add(const std::string& name, const std::string& description,
+	       const Getter& getter, const Setter& setter);
+
+      /** Current value of the flag.  Throws
+       *  pistis::exceptions::IllegalValueError if there is no such flag.
+       */
+      std::string get(const std::string& name) const;
+
+      /** Change the value of the flag.  Throws
+       *  pistis::exceptions::IllegalValueError if there is no such flag or
+       *  the value is not legal, in which case the flag is unchanged.
+       */
+      void set(const std::string& name, const std::string& value) const;
+
+      /** Current values of all flags, in order by name */
+      std::vector<FlagValue> values() const;
+
+    private:
+      struct Flag_ {
+	std::string description;
+	Getter getter;
+	Setter setter;
+      };
+
+      std::map<std::string, Flag_> flags_;
+
+      const Flag_& find_(const std::string& name) const;
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,87 @@
+#include "SeededHash.hpp"
+#include <random>
+#include <string.h>
+
+namespace {
+  struct Key {
+    uint64_t k0;
+    uint64_t k1;
+
+    Key() {
+      std::random_device random;
+      k0= ((uint64_t)random() << 32) | random();
+      k1= ((uint64_t)random() << 32) | random();
+    }
+  };
+
+  const Key& key() {
+    static const Key KEY;
+    return KEY;
+  }
+
+  inline uint64_t rotl(uint64_t x, int b) {
+    return (x << b) | (x >> (64 - b));
+  }
+
+  inline void sipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2,
+		       uint64_t& v3) {
+    v0 += v1; v1= rotl(v1, 13); v1 ^= v0; v0= rotl(v0, 32);
+    v2 += v3; v3= rotl(v3, 16); v3 ^= v2;
+    v0 += v3; v3= rotl(v3, 21); v3 ^= v0;
+    v2 += v1; v1= rotl(v1, 17); v1 ^= v2; v2= rotl(v2, 32);
+  }
+
+  // SipHash with compressionRounds rounds per block and
+  // finalizationRounds rounds at the end
+  template <int compressionRounds, int finalizationRounds>
+  inline uint64_t sipHash(const void* data, size_t size, uint64_t k0,
+			  uint64_t k1) {
+    uint64_t v0= k0 ^ 0x736f6d6570736575ULL;
+    uint64_t v1= k1 ^ 0x646f72616e646f6dULL;
+    uint64_t v2= k0 ^ 0x6c7967656e657261ULL;
+    uint64_t v3= k1 ^ 0x7465646279746573ULL;
+
+    const unsigned char* p= static_cast<const unsigned char*>(data);
+    const unsigned char* end= p + (size & ~(size_t)7);
+    for (; p != end; p += 8) {
+      uint64_t m;
+      memcpy(&m, p, 8);
+      v3 ^= m;
+      for (int i= 0; i < compressionRounds; ++i) {
+	sipRound(v0, v1, v2, v3);
+      }
+      v0 ^= m;
+    }
+
+    uint64_t last= (uint64_t)size << 56;
+    for (size_t i= 0; i < (size & 7); ++i) {
+      last |= (uint64_t)p[i] << (8 * i);
+    }
+    v3 ^= last;
+    for (int i= 0; i < compressionRounds; ++i) {
+      sipRound(v0, v1, v2, v3);
+    }
+    v0 ^= last;
+
+    v2 ^= 0xff;
+    for (int i= 0; i < finalizationRounds; ++i) {
+      sipRound(v0, v1, v2, v3);
+    }
+    return v0 ^ v1 ^ v2 ^ v3;
+  }
+}
+
+uint64_t pistis::arg_parser::seededHash(const void* data, size_t size) {
+  const Key& k= key();
+  return sipHash<1, 3>(data, size, k.k0, k.k1);
+}
+
+uint64_t pistis::arg_parser::sipHash13(const void* data, size_t size,
+				       uint64_t k0, uint64_t k1) {
+  return sipHash<1, 3>(data, size, k0, k1);
+}
+
+uint64_t pistis::arg_parser::sipHash24(const void* data, size_t size,
+				       uint64_t k0, uint64_t k1) {
+  return sipHash<2, 4>(data, size, k0, k1);
+}
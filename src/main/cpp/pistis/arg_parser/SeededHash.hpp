@@ -0,0 +1,55 @@
+#ifndef __PISTIS__ARG_PARSER__SEEDEDHASH_HPP__
+#define __PISTIS__ARG_PARSER__SEEDEDHASH_HPP__
+
+#include <functional>
+#include <string>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** SipHash-1-3 of the bytes at data, keyed with a random key chosen
+     *  once per process.  Without the key, nobody can construct values
+     *  that collide, so hash tables filled from untrusted input keep
+     *  their expected performance.
+     */
+    uint64_t seededHash(const void* data, size_t size);
+
+    /** SipHash-1-3 of the bytes at data with the key whose first and last
+     *  eight bytes, read as little-endian integers, are k0 and k1.
+     *  seededHash() is this with its per-process key.
+     */
+    uint64_t sipHash13(const void* data, size_t size, uint64_t k0,
+		       uint64_t k1);
+
+    /** As sipHash13(), but SipHash-2-4, the variant the SipHash paper
+     *  gives test vectors for.  Shares all but the number of rounds with
+     *  sipHash13().
+     */
+    uint64_t sipHash24(const void* data, size_t size, uint64_t k0,
+		       uint64_t k1);
+
+    /** Hash function for std::unordered_set and std::unordered_map built
+     *  on seededHash().  Strings are hashed directly; other values hash
+     *  the result of std::hash, which is enough for integers because
+     *  std::hash does not merge distinct integers.
+     */
+    template <typename Value>
+    struct SeededHash {
+      size_t operator()(const Value& v) const {
+	const size_t h= std::hash<Value>()(v);
+	return (size_t)seededHash(&h, sizeof(h));
+      }
+    };
+
+    template <>
+    struct SeededHash<std::string> {
+      size_t operator()(const std::string& s) const {
+	return (size_t)seededHash(s.data(), s.size());
+      }
+    };
+
+  }
+}
+#endif
@@ -1,13 +1,106 @@
 #include "SimpleCmdLineArgs.hpp"
+#include "ConfigFileError.hpp"
+#include "ConfigFileReader.hpp"
+#include "ConfigImage.hpp"
+#include "MappedFile.hpp"
+#include "ParseStats.hpp"
 #include "RequiredCmdLineArgMissingError.hpp"
+#include "ResourceLimitExceededError.hpp"
 #include <pistis/exceptions/IllegalStateError.hpp>
 #include <pistis/exceptions/IllegalValueError.hpp>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern char** environ;
 
 using pistis::exceptions::PistisException;
 using namespace pistis::arg_parser;
 
+namespace {
+  const char COMPLETE_ARG[]= "--__complete";
+  const std::string INIT_VALUES_NAME("initValues_");
+  const std::string CHECK_VALUES_NAME("checkValues_");
+
+  /** Tells an observer, if there is one, about the call made during the
+   *  lifetime of this object.
+   */
+  class ObservedCall {
+  public:
+    ObservedCall(ParseObserver* observer, ParseObserver::Event event,
+		 const std::string& name):
+	observer_(observer), event_(event), name_(name) {
+      if (observer_) {
+	observer_->begin(event_, name_);
+      }
+    }
+    ObservedCall(const ObservedCall&) = delete;
+    ~ObservedCall() {
+      if (observer_) {
+	try {
+	  observer_->end(event_, name_);
+	} catch(...) {
+	  // Observers must not throw, and this may run while another
+	  // exception is propagating
+	}
+      }
+    }
+
+    ObservedCall& operator=(const ObservedCall&) = delete;
+
+  private:
+    ParseObserver* observer_;
+    ParseObserver::Event event_;
+    const std::string& name_;
+  };
+
+  /** Closes a file descriptor when it goes out of scope */
+  class FileCloser {
+  public:
+    FileCloser(int fd): fd_(fd) { }
+    FileCloser(const FileCloser&) = delete;
+    ~FileCloser() { ::close(fd_); }
+
+    FileCloser& operator=(const FileCloser&) = delete;
+
+  private:
+    int fd_;
+  };
+
+  std::string envVarFor(const std::string& prefix,
+			const std::string& argName) {
+    std::string envVar(prefix);
+    size_t i= argName.find_first_not_of('-');
+    for (; i < argName.size(); ++i) {
+      envVar.push_back((argName[i] == '-') ? '_' : toupper(argName[i]));
+    }
+    return envVar;
+  }
+}
+
+const size_t SimpleCmdLineArgs::LIST_FILE_CHUNK_SIZE;
+const size_t SimpleCmdLineArgs::MAX_LIST_FILE_LINE_SIZE;
+
 SimpleCmdLineArgs::SimpleCmdLineArgs():
-    AbstractCmdLineArgs(), namedArgs_(), unnamedArgs_(), currentUnnamedArg_() {
+    AbstractCmdLineArgs(), namedArgs_(), unnamedArgs_(), currentUnnamedArg_(),
+    envBound_(false), envPrefix_(), envArgs_(), numEnvBindings_(0),
+    envKeyPrefix_(),
+    namedArgList_(), flags_(), flagOccurrences_(), flagsFound_(),
+    namedArgNames_(), suggester_(),
+    numIndexedNames_(0), numIndexedFlagNames_(0),
+    runtimeFlags_(), parseObserver_(nullptr), preScan_(false),
+    appName_(), currentHandler_(nullptr), containerBytes_(0), configFiles_(),
+    cmdLineConfigFiles_(), lazyValues_(), argvBegin_(nullptr),
+    argvEnd_(nullptr), parallelMinSize_(SIZE_MAX), scheduler_(),
+    listFiles_(false) {
+  // Intentionally left blank
 }
 
 SimpleCmdLineArgs::~SimpleCmdLineArgs() {
@@ -19,8 +112,8 @@ SimpleCmdLineArgs::~SimpleCmdLineArgs() {
   }
 }
 
-void SimpleCmdLineArgs::registerNamedArg_(const std::string& argName,
-					  const std::string& description,
+void SimpleCmdLineArgs::registerNamedArg_(const ArgText& argName,
+					  const ArgText& description,
 					  bool required,
 					  const std::function<
 					      void (CmdLineArgGenerator&,
@@ -45,7 +138,7 @@ void SimpleCmdLineArgs::registerNamedArg_(const std::string& argName,
   registerHandler_(h);
 }
 
-void SimpleCmdLineArgs::registerUnnamedArg_(const std::string& description,
+void SimpleCmdLineArgs::registerUnnamedArg_(const ArgText& description,
 					    bool required,
 					    const std::function<
 					        void (CmdLineArgGenerator&,
@@ -83,31 +176,882 @@ void SimpleCmdLineArgs::registerHandler_(ArgHandler* handler) {
     unnamedArgs_.push_back(h.release());
   } else if (h->argName()[0] != '-') {
     throw pistis::exceptions::IllegalValueError(
-        "handler->argName()",  h->argName(),
+        "handler->argName()",  h->argName().str(),
 	"Named arguments must begin with a '-'", PISTIS_EX_HERE
     );
-  } else if (namedArgs_.find(h->argName()) != namedArgs_.end()) {
+  } else if ((namedArgs_.find(h->argName()) != namedArgs_.end()) ||
+	     flags_.contains(h->argName())) {
     throw pistis::exceptions::IllegalStateError(
-        "Argument \"" + h->argName() +
+        "Argument \"" + h->argName().str() +
 	"\" already has a handler registered for it",
 	PISTIS_EX_HERE
     );
   } else {
-    namedArgs_.insert(std::make_pair(h->argName(), h.get()));
+    namedArgs_.insert(std::make_pair(ArgText::view(h->argName()), h.get()));
+    namedArgList_.push_back(h.get());
+    if (envBound_) {
+      addEnvVar_(envVarFor(envPrefix_, h->argName().str()),
+		 NamedTarget_(h.get()));
+    }
     h.release();
   }
 }
 
+void SimpleCmdLineArgs::registerLazy_(LazyBase& lazy,
+				      LazyArgHandler* handler) {
+  registerHandler_(handler);
+  lazy.converter_= handler;
+  lazyValues_.push_back(&lazy);
+}
+
+void SimpleCmdLineArgs::setParallelConversion(size_t minSize,
+					      size_t numThreads) {
+  parallelMinSize_= minSize;
+  if (minSize == SIZE_MAX) {
+    scheduler_.reset();
+  } else if (!scheduler_ || (numThreads != scheduler_->numThreads())) {
+    scheduler_.reset(new WorkStealingScheduler(numThreads));
+  }
+}
+
+void SimpleCmdLineArgs::validateAll() const {
+  for (auto i= lazyValues_.begin(); i != lazyValues_.end(); ++i) {
+    (*i)->validate();
+  }
+}
+
+void SimpleCmdLineArgs::indexNames_() const {
+  if (!numIndexedNames_) {
+    // Handled by AbstractCmdLineArgs
+    namedArgNames_.insert("-h");
+    namedArgNames_.insert("--help");
+  }
+  for (; numIndexedNames_ < namedArgList_.size(); ++numIndexedNames_) {
+    const std::string name= namedArgList_[numIndexedNames_]->argName().str();
+    namedArgNames_.insert(name);
+    suggester_.add(name);
+  }
+  for (; numIndexedFlagNames_ < flags_.names().size();
+       ++numIndexedFlagNames_) {
+    const std::string name= flags_.names()[numIndexedFlagNames_].str();
+    namedArgNames_.insert(name);
+    suggester_.add(name);
+  }
+}
+
+void SimpleCmdLineArgs::registerFlag_(const ArgText& argName,
+				      const ArgText& description,
+				      bool negatable, bool& value) {
+  addFlag_(argName, description, negatable, FlagTable::boolFlag(value));
+}
+
+void SimpleCmdLineArgs::registerFlag_(const ArgText& argName,
+				      const ArgText& description,
+				      bool negatable,
+				      std::atomic<bool>& value) {
+  addFlag_(argName, description, negatable, FlagTable::atomicFlag(value));
+  const std::string name= argName.str();
+  runtimeFlags_.add(
+      name, description.str(),
+      [&value]() {
+	return std::string(value.load(std::memory_order_relaxed) ? "true"
+			                                          : "false");
+      },
+      [&value, name](const std::string& v) {
+	if (v == "true") {
+	  value.store(true, std::memory_order_relaxed);
+	} else if (v == "false") {
+	  value.store(false, std::memory_order_relaxed);
+	} else {
+	  throw pistis::exceptions::IllegalValueError(
+	      name, v, "Value must be \"true\" or \"false\"", PISTIS_EX_HERE
+	  );
+	}
+      }
+  );
+}
+
+void SimpleCmdLineArgs::registerCountingFlag_(const ArgText& argName,
+					      const ArgText& description,
+					      int& count) {
+  addFlag_(argName, description, false, FlagTable::countingFlag(count));
+}
+
+void SimpleCmdLineArgs::addFlag_(const ArgText& argName,
+				 const ArgText& description,
+				 bool negatable, const FlagTable::Flag& flag) {
+  if ((argName.size() < 2) || (argName[0] != '-') ||
+      memchr(argName.data(), '=', argName.size())) {
+    throw pistis::exceptions::IllegalValueError(
+        "argName", argName.str(),
+	"Flags must begin with a '-' and cannot contain a '='",
+	PISTIS_EX_HERE
+    );
+  } else if (negatable && ((argName.size() < 3) || (argName[1] != '-'))) {
+    throw pistis::exceptions::IllegalValueError(
+        "argName", argName.str(), "Negatable flags must begin with \"--\"",
+	PISTIS_EX_HERE
+    );
+  }
+
+  auto checkUnused= [this](const ArgText& name) {
+    if ((namedArgs_.find(name) != namedArgs_.end()) ||
+	flags_.contains(name)) {
+      throw pistis::exceptions::IllegalStateError(
+          "Argument \"" + name.str() +
+	  "\" already has a handler registered for it",
+	  PISTIS_EX_HERE
+      );
+    }
+  };
+  checkUnused(argName);
+  if (negatable) {
+    checkUnused(ArgText::view(FlagTable::negatedName(argName)));
+  }
+  flags_.add(argName, description, negatable, flag);
+  flagOccurrences_.push_back(0);
+  flagsFound_.push_back(false);
+  if (envBound_) {
+    addEnvVar_(envVarFor(envPrefix_, argName.str()),
+	       NamedTarget_((uint32_t)(flags_.size() - 1), false));
+  }
+}
+
+bool SimpleCmdLineArgs::handleFlag_(const std::string& appName,
+				    const std::string& arg) {
+  if (flags_.empty()) {
+    return false;
+  }
+
+  const size_t eq= arg.find('=');
+  if (eq == std::string::npos) {
+    const FlagTable::Match m= flags_.find(ArgText::view(arg));
+    if (!m.flag) {
+      return handleShortFlags_(appName, arg);
+    }
+    applyFlagArg_(appName, m, nullptr);
+    return true;
+  }
+
+  const std::string name(arg, 0, eq);
+  const FlagTable::Match m= flags_.find(ArgText::view(name));
+  if (!m.flag) {
+    return false;
+  }
+  applyFlagArg_(appName, m, arg.c_str() + eq + 1);
+  return true;
+}
+
+bool SimpleCmdLineArgs::handleShortFlags_(const std::string& appName,
+					  const std::string& arg) {
+  // A combination such as "-xvf" is only applied if every character in
+  // it is a flag, so an unknown argument has no partial effect.
+  if ((arg.size() < 3) || (arg[1] == '-')) {
+    return false;
+  }
+
+  char name[]= "-?";
+  for (size_t i= 1; i < arg.size(); ++i) {
+    name[1]= arg[i];
+    if (!flags_.find(ArgText::view(name)).flag) {
+      return false;
+    }
+  }
+  for (size_t i= 1; i < arg.size(); ++i) {
+    name[1]= arg[i];
+    applyFlagArg_(appName, flags_.find(ArgText::view(name)), nullptr);
+  }
+  return true;
+}
+
+void SimpleCmdLineArgs::applyFlagArg_(const std::string& appName,
+				      const FlagTable::Match& match,
+				      const char* value) {
+  const size_t i= flags_.indexOf(*match.flag);
+  const uint32_t occurrences= flagOccurrences_[i] + 1;
+  if (occurrences > parseLimits().maxOccurrences) {
+    throw ResourceLimitExceededError(appName, flags_.fullNameOf(*match.flag),
+				     "Number of occurrences",
+				     parseLimits().maxOccurrences);
+  }
+  flagOccurrences_[i]= occurrences;
+
+  try {
+    invokeFlag_(i, match.negated, value);
+  } catch(const FormatError& e) {
+    throw IllegalValueError(appName, flags_.fullNameOf(*match.flag),
+			    e.value().c_str(), e.details());
+  }
+  flagsFound_[i]= true;
+}
+
+void SimpleCmdLineArgs::setFlag_(const FlagTable::Flag& flag, bool negated,
+				 const char* value) {
+  if (!value) {
+    FlagTable::apply(flag, !negated);
+  } else if (negated) {
+    throw FormatError(value, "Flag does not take a value");
+  } else if (flag.kind == FlagTable::Kind::COUNT) {
+    char* end;
+    errno= 0;
+    const long n= strtol(value, &end, 10);
+    if (!isdigit(*value) || *end || errno || (n > INT_MAX)) {
+      throw FormatError(value, "Value must be a non-negative integer");
+    }
+    *static_cast<int*>(flag.destination) += (int)n;
+  } else if (!strcmp(value, "true")) {
+    FlagTable::apply(flag, true);
+  } else if (!strcmp(value, "false")) {
+    FlagTable::apply(flag, false);
+  } else {
+    throw FormatError(value, "Value must be \"true\" or \"false\"");
+  }
+}
+
+void SimpleCmdLineArgs::reserveContainers_(int argc, char** argv) {
+  // Mirrors the way parse() assigns values to handlers, but only for
+  // handlers that can say how many values they take.  Few handlers have
+  // containers and the same option tends to be repeated, so the counts
+  // are kept in a short list searched from the last one used.
+  std::vector< std::pair<ArgHandler*, size_t> > numItems;
+  size_t last= 0;
+  auto count= [&numItems, &last](ArgHandler* h, size_t n) {
+    if (!n) {
+      return;
+    } else if ((last >= numItems.size()) || (numItems[last].first != h)) {
+      for (last= 0; (last < numItems.size()) && (numItems[last].first != h);
+	   ++last) {
+      }
+      if (last == numItems.size()) {
+	numItems.push_back(std::make_pair(h, (size_t)0));
+      }
+    }
+    numItems[last].second += n;
+  };
+
+  auto nextUnnamed= unnamedArgs_.begin();
+  ArgHandler* previous= nullptr;
+  size_t n= 0;
+  for (int i= 1; i < argc; ++i) {
+    if (argv[i][0] == '-') {
+      ArgHandler* h= previous;
+      if (!h || strcmp(argv[i], h->argName().c_str())) {
+	HandlerMapType::const_iterator j=
+	    namedArgs_.find(ArgText::view(argv[i]));
+	h= (j != namedArgs_.end()) ? j->second : nullptr;
+      }
+      if (h && (i + 1 < argc) && h->countItems(argv[i + 1], n)) {
+	count(h, n);
+	previous= h;
+	++i;
+      }
+    } else if (nextUnnamed != unnamedArgs_.end()) {
+      if ((*nextUnnamed)->countItems(argv[i], n)) {
+	count(*nextUnnamed, n);
+      }
+      if (!(*nextUnnamed)->final()) {
+	++nextUnnamed;
+      }
+    }
+  }
+
+  const size_t maxItems= parseLimits().maxListElements;
+  for (auto i= numItems.begin(); i != numItems.end(); ++i) {
+    i->first->reserve(std::min(i->second, maxItems));
+  }
+}
+
+void SimpleCmdLineArgs::addCompletions_(
+    const std::string& argName, const std::vector<std::string>& values
+) {
+  HandlerMapType::iterator i= namedArgs_.find(ArgText::view(argName));
+  if (i == namedArgs_.end()) {
+    throw pistis::exceptions::IllegalValueError(
+        "argName", argName, "No such argument", PISTIS_EX_HERE
+    );
+  }
+  for (auto j= values.begin(); j != values.end(); ++j) {
+    i->second->addCompletion(*j);
+  }
+}
+
+bool SimpleCmdLineArgs::complete(int argc, char** argv, int fd) const {
+  if ((argc < 3) || strcmp(argv[1], COMPLETE_ARG)) {
+    return false;
+  }
+
+  char* end;
+  const long cword= strtol(argv[2], &end, 10);
+  std::string out;
+  if (!*end && (cword > 0) && (cword <= argc - 3)) {
+    completeWord_(argv + 3, argc - 3, (int)cword, out);
+  }
+
+  const char* p= out.data();
+  size_t n= out.size();
+  while (n) {
+    ssize_t written= ::write(fd, p, n);
+    if (written < 0) {
+      if (errno == EINTR) {
+	continue;
+      }
+      break;
+    }
+    p += written;
+    n -= written;
+  }
+  return true;
+}
+
+void SimpleCmdLineArgs::completeWord_(char** words, int numWords, int cword,
+				      std::string& out) const {
+  const std::string current((cword < numWords) ? words[cword] : "");
+
+  // Work out which argument the word belongs to.  Named arguments are
+  // assumed to take one value.
+  const ArgHandler* owner= nullptr;
+  size_t numUnnamed= 0;
+  for (int i= 1; i < cword; ++i) {
+    if (owner) {
+      owner= nullptr;
+    } else if (words[i][0] == '-') {
+      HandlerMapType::const_iterator j=
+	  namedArgs_.find(ArgText::view(words[i]));
+      if (j != namedArgs_.end()) {
+	owner= j->second;
+      }
+    } else {
+      ++numUnnamed;
+    }
+  }
+
+  if (owner) {
+    owner->completions().complete(current, out);
+  } else if (!current.empty() && (current[0] == '-')) {
+    indexNames_();
+    namedArgNames_.complete(current, out);
+  } else if (numUnnamed < unnamedArgs_.size()) {
+    unnamedArgs_[numUnnamed]->completions().complete(current, out);
+  } else if (!unnamedArgs_.empty() && unnamedArgs_.back()->final()) {
+    unnamedArgs_.back()->completions().complete(current, out);
+  }
+}
+
+void SimpleCmdLineArgs::bindEnvironment_(const std::string& prefix) {
+  envBound_= true;
+  envPrefix_= prefix;
+  for (auto i= namedArgs_.begin(); i != namedArgs_.end(); ++i) {
+    addEnvVar_(envVarFor(prefix, i->first.str()), NamedTarget_(i->second));
+  }
+  for (size_t i= 0; i < flags_.size(); ++i) {
+    addEnvVar_(envVarFor(prefix, flags_.nameOf(flags_[i]).str()),
+	       NamedTarget_((uint32_t)i, false));
+  }
+}
+
+void SimpleCmdLineArgs::bindEnvVar_(const std::string& argName,
+				    const std::string& envVar) {
+  NamedTarget_ target(nullptr);
+  if (!findTarget_(ArgText::view(argName), target)) {
+    throw pistis::exceptions::IllegalValueError(
+        "argName", argName, "No such argument", PISTIS_EX_HERE
+    );
+  }
+  addEnvVar_(envVar, target);
+}
+
+void SimpleCmdLineArgs::addEnvVar_(const std::string& envVar,
+				   const NamedTarget_& target) {
+  if (envVar.empty() || (envVar.find('=') != std::string::npos)) {
+    throw pistis::exceptions::IllegalValueError(
+        "envVar", envVar, "Not a legal environment variable name",
+	PISTIS_EX_HERE
+    );
+  }
+  if (envArgs_.empty()) {
+    envKeyPrefix_= envVar;
+  } else {
+    size_t n= 0;
+    while ((n < envKeyPrefix_.size()) && (n < envVar.size()) &&
+	   (envKeyPrefix_[n] == envVar[n])) {
+      ++n;
+    }
+    envKeyPrefix_.resize(n);
+  }
+  envArgs_.erase(ArgText::view(envVar));
+  envArgs_.insert(std::make_pair(ArgText(envVar),
+				 EnvTarget_{ target, numEnvBindings_++ }));
+}
+
+void SimpleCmdLineArgs::applyEnvironment_(const std::string& appName) {
+  if (envArgs_.empty() || !environ) {
+    return;
+  }
+
+  // One pass over the environment.  Variables that do not begin with
+  // the common prefix of all bound names are rejected without a lookup,
+  // and the lookup key is built in a buffer reused across variables.
+  // Matches are applied in the order they were bound, so when two
+  // variables bound to one argument are set, the first bound wins.
+  const char* prefix= envKeyPrefix_.c_str();
+  const size_t prefixSize= envKeyPrefix_.size();
+  std::string name;
+  typedef std::pair<EnvMapType::const_iterator, const char*> Match;
+  std::vector<Match> matches;
+
+  for (char** p= environ; *p; ++p) {
+    if (strncmp(*p, prefix, prefixSize)) {
+      continue;
+    }
+    const char* eq= strchr(*p + prefixSize, '=');
+    if (!eq) {
+      continue;
+    }
+    name.assign(*p, eq - *p);
+
+    EnvMapType::const_iterator i= envArgs_.find(ArgText::view(name));
+    if (i != envArgs_.end()) {
+      matches.push_back(Match(i, eq + 1));
+    }
+  }
+
+  std::sort(matches.begin(), matches.end(),
+	    [](const Match& x, const Match& y) {
+    return x.first->second.order < y.first->second.order;
+  });
+  for (auto i= matches.begin(); i != matches.end(); ++i) {
+    const NamedTarget_& target= i->first->second.target;
+    if (!found_(target)) {
+      applyValue_(target, appName, i->second, "environment variable",
+		  i->first->first.str(), 0);
+    }
+  }
+}
+
+void SimpleCmdLineArgs::compileConfigFile(
+    const std::string& path, const std::string& imagePath
+) const {
+  struct stat info;
+  if (stat(path.c_str(), &info) < 0) {
+    throw ConfigFileError(std::string(), path, 0, strerror(errno));
+  }
+
+  const std::unordered_map<const ArgHandler*, size_t> indices=
+      handlerIndices_();
+  ConfigImageWriter writer;
+  readConfigFile_(std::string(), path,
+		  [this, &writer, &indices](const ConfigEntry& entry,
+					    const NamedTarget_& target,
+					    const std::string& value) {
+    writer.add(indexOf_(target, indices), entry.line, value.data(),
+	       value.size());
+  });
+  writer.write(imagePath, schemaFingerprint_(), info.st_size,
+	       (int64_t)info.st_mtim.tv_sec * 1000000000 +
+	           info.st_mtim.tv_nsec);
+}
+
+std::vector<std::string> SimpleCmdLineArgs::configFilePaths() const {
+  std::vector<std::string> paths;
+  for (auto i= configFiles_.begin(); i != configFiles_.end(); ++i) {
+    paths.push_back(i->path);
+  }
+  paths.insert(paths.end(), cmdLineConfigFiles_.begin(),
+	       cmdLineConfigFiles_.end());
+  return paths;
+}
+
+void SimpleCmdLineArgs::addConfigFile_(const std::string& path,
+				       bool required) {
+  addConfigFile_(path, required, std::string());
+}
+
+void SimpleCmdLineArgs::addConfigFile_(const std::string& path,
+				       bool required,
+				       const std::string& imagePath) {
+  configFiles_.push_back(ConfigFile_{ path, required, imagePath });
+}
+
+void SimpleCmdLineArgs::registerConfigFileArg_(
+    const ArgText& argName, const ArgText& description
+) {
+  registerNamedArg_(argName, description, false,
+		    [this](CmdLineArgGenerator& args,
+			   const std::string& argName) {
+    cmdLineConfigFiles_.push_back(args.next(argName));
+  });
+}
+
+void SimpleCmdLineArgs::applyConfigFiles_(const std::string& appName) {
+  if (configFiles_.empty() && cmdLineConfigFiles_.empty()) {
+    return;
+  }
+
+  std::unordered_set<const void*> setByFiles;
+  for (auto i= configFiles_.begin(); i != configFiles_.end(); ++i) {
+    applyConfigFile_(appName, *i, setByFiles);
+  }
+  for (auto i= cmdLineConfigFiles_.begin(); i != cmdLineConfigFiles_.end();
+       ++i) {
+    applyConfigFile_(appName, ConfigFile_{ *i, true, std::string() },
+		     setByFiles);
+  }
+}
+
+void SimpleCmdLineArgs::applyConfigFile_(
+    const std::string& appName, const ConfigFile_& file,
+    std::unordered_set<const void*>& setByFiles
+) {
+  struct stat info;
+  if (stat(file.path.c_str(), &info) < 0) {
+    if (!file.required && (errno == ENOENT)) {
+      return;
+    }
+    throw ConfigFileError(appName, file.path, 0, strerror(errno));
+  }
+
+  // Values from the command line and the environment take precedence,
+  // but a later entry for the same argument adds to or replaces an
+  // earlier one.
+  auto apply= [this, &appName, &file, &setByFiles](
+      const NamedTarget_& target, const char* value, size_t line
+  ) {
+    const void* key= keyOf_(target);
+    if (!found_(target) || setByFiles.count(key)) {
+      applyValue_(target, appName, value, "configuration file", file.path,
+		  line);
+      setByFiles.insert(key);
+    }
+  };
+
+  if (file.imagePath.empty()) {
+    readConfigFile_(appName, file.path,
+		    [&apply](const ConfigEntry& entry,
+			     const NamedTarget_& target,
+			     const std::string& value) {
+      apply(target, value.c_str(), entry.line);
+    });
+    return;
+  }
+
+  const uint64_t fingerprint= schemaFingerprint_();
+  const int64_t mtime=
+      (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+  ConfigImage image;
+
+  if (image.load(file.imagePath, fingerprint, numTargets_(), info.st_size,
+		 mtime)) {
+    for (auto e= image.begin(); e != image.end(); ++e) {
+      apply(targetAt_(e->handler), image.value(*e), e->line);
+    }
+    return;
+  }
+
+  // The image is missing or stale, so read the text and compile a new
+  // image while doing so
+  const std::unordered_map<const ArgHandler*, size_t> indices=
+      handlerIndices_();
+  ConfigImageWriter writer;
+  readConfigFile_(appName, file.path,
+		  [this, &apply, &writer, &indices](
+		      const ConfigEntry& entry, const NamedTarget_& target,
+		      const std::string& value
+		  ) {
+    writer.add(indexOf_(target, indices), entry.line, value.data(),
+	       value.size());
+    apply(target, value.c_str(), entry.line);
+  });
+
+  try {
+    writer.write(file.imagePath, fingerprint, info.st_size, mtime);
+  } catch(const PistisException&) {
+    // The image only saves time on the next parse, so failing to write
+    // it is not an error
+  }
+}
+
+template <typename Function>
+void SimpleCmdLineArgs::readConfigFile_(const std::string& appName,
+					const std::string& path,
+					const Function& f) const {
+  MappedFile file;
+  try {
+    file= MappedFile(path);
+  } catch(const PistisException& e) {
+    throw ConfigFileError(appName, path, 0, e.what());
+  }
+
+  ConfigFileReader reader(path, file.begin(), file.end());
+  ConfigEntry entry;
+  std::string argName;
+  std::string value;
+
+  try {
+    while (reader.next(entry)) {
+      argName.clear();
+      if (*entry.key != '-') {
+	argName.append("--");
+	if (entry.sectionSize) {
+	  argName.append(entry.section, entry.sectionSize);
+	  argName.push_back('.');
+	}
+      }
+      argName.append(entry.key, entry.keySize);
+
+      NamedTarget_ target(nullptr);
+      if (!findTarget_(ArgText::view(argName), target)) {
+	throw ConfigFileError(appName, path, entry.line,
+			      "Unknown argument " + argName);
+      }
+      value.assign(entry.value, entry.valueSize);
+      f(entry, target, value);
+    }
+  } catch(const ConfigFileError& e) {
+    // The reader does not know the application name
+    throw ConfigFileError(appName, e.fileName(), e.line(), e.details());
+  }
+}
+
+template <typename Function>
+void SimpleCmdLineArgs::readListFile_(const std::string& value,
+				      const Function& f) const {
+  const std::string path= value.substr(1);
+  const int fd= ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw FormatError(value, std::string("Cannot open file: ") +
+			     strerror(errno));
+  }
+  FileCloser closer(fd);
+
+  std::unique_ptr<char[]> chunk(new char[LIST_FILE_CHUNK_SIZE]);
+  std::string item;
+  size_t line= 0;
+  size_t numItems= 0;
+  const size_t maxLineSize= std::min(MAX_LIST_FILE_LINE_SIZE,
+				     parseLimits().maxTokenSize);
+
+  // A line that spans chunks is collected in item, which may not grow
+  // past maxLineSize
+  auto collect= [&](const char* begin, const char* end) {
+    if ((size_t)(end - begin) > (maxLineSize - item.size())) {
+      throw FormatError(value, "Line " + std::to_string(line + 1) + " of " +
+			       path + " is longer than " +
+			       std::to_string(maxLineSize) + " bytes");
+    }
+    item.append(begin, end);
+  };
+
+  auto apply= [&](const char* begin, const char* end) {
+    collect(begin, end);
+    ++line;
+    if (!item.empty() && (item.back() == '\r')) {
+      item.pop_back();
+    }
+    if (item.empty()) {
+      return;
+    }
+    if (++numItems > parseLimits().maxListElements) {
+      tooManyListElements_();
+    }
+
+    try {
+      f(item);
+    } catch(const FormatError& e) {
+      throw FormatError(e.value(), "Line " + std::to_string(line) + " of " +
+			           path + ": " + e.details());
+    } catch(const CmdLineArgError& e) {
+      throw;
+    } catch(const std::exception& e) {
+      throw FormatError(item, "Line " + std::to_string(line) + " of " +
+			      path + ": " + e.what());
+    } catch(...) {
+      throw FormatError(item, "Line " + std::to_string(line) + " of " +
+			      path);
+    }
+    item.clear();
+  };
+
+  while (true) {
+    const ssize_t n= ::read(fd, chunk.get(), LIST_FILE_CHUNK_SIZE);
+    if (n < 0) {
+      if (errno == EINTR) {
+	continue;
+      }
+      throw FormatError(value, std::string("Cannot read file: ") +
+			       strerror(errno));
+    } else if (!n) {
+      break;
+    }
+
+    const char* p= chunk.get();
+    const char* const end= p + n;
+    for (const char* q= (const char*)memchr(p, '\n', end - p);
+	 q;
+	 q= (const char*)memchr(p, '\n', end - p)) {
+      apply(p, q);
+      p= q + 1;
+    }
+    collect(p, end);
+  }
+
+  // The last line need not end with a newline
+  if (!item.empty()) {
+    apply(chunk.get(), chunk.get());
+  }
+}
+
+uint64_t SimpleCmdLineArgs::schemaFingerprint_() const {
+  // FNV-1a over the names of the named arguments in registration order
+  uint64_t h= 14695981039346656037ULL;
+  for (auto i= namedArgList_.begin(); i != namedArgList_.end(); ++i) {
+    const ArgText& name= (*i)->argName();
+    for (size_t j= 0; j <= name.size(); ++j) {
+      h= (h ^ (unsigned char)name.c_str()[j]) * 1099511628211ULL;
+    }
+  }
+  for (auto i= flags_.names().begin(); i != flags_.names().end(); ++i) {
+    for (size_t j= 0; j <= i->size(); ++j) {
+      h= (h ^ (unsigned char)i->c_str()[j]) * 1099511628211ULL;
+    }
+  }
+  return h;
+}
+
+std::unordered_map<const SimpleCmdLineArgs::ArgHandler*, size_t>
+    SimpleCmdLineArgs::handlerIndices_() const {
+  std::unordered_map<const ArgHandler*, size_t> indices;
+  for (size_t i= 0; i < namedArgList_.size(); ++i) {
+    indices[namedArgList_[i]]= i;
+  }
+  return indices;
+}
+
+bool SimpleCmdLineArgs::findTarget_(const ArgText& argName,
+				    NamedTarget_& target) const {
+  HandlerMapType::const_iterator i= namedArgs_.find(argName);
+  if (i != namedArgs_.end()) {
+    target= NamedTarget_(i->second);
+    return true;
+  }
+  const FlagTable::Match m= flags_.find(argName);
+  if (m.flag) {
+    target= NamedTarget_((uint32_t)flags_.indexOf(*m.flag), m.negated);
+    return true;
+  }
+  return false;
+}
+
+bool SimpleCmdLineArgs::found_(const NamedTarget_& target) const {
+  return target.handler ? target.handler->found()
+                        : flagsFound_[target.flag];
+}
+
+const void* SimpleCmdLineArgs::keyOf_(const NamedTarget_& target) const {
+  return target.handler ? (const void*)target.handler
+                        : (const void*)&flags_[target.flag];
+}
+
+// Compiled configuration files refer to handlers by their index in
+// namedArgList_, and to flags by the indices that follow, two per flag
+// so a "--no-" name is kept as such
+size_t SimpleCmdLineArgs::indexOf_(
+    const NamedTarget_& target,
+    const std::unordered_map<const ArgHandler*, size_t>& indices
+) const {
+  if (target.handler) {
+    return indices.find(target.handler)->second;
+  }
+  return namedArgList_.size() + 2 * target.flag + (target.negated ? 1 : 0);
+}
+
+SimpleCmdLineArgs::NamedTarget_ SimpleCmdLineArgs::targetAt_(
+    size_t index
+) const {
+  if (index < namedArgList_.size()) {
+    return NamedTarget_(namedArgList_[index]);
+  }
+  index -= namedArgList_.size();
+  return NamedTarget_((uint32_t)(index >> 1), (index & 1) != 0);
+}
+
+size_t SimpleCmdLineArgs::numTargets_() const {
+  return namedArgList_.size() + 2 * flags_.size();
+}
+
+void SimpleCmdLineArgs::applyValue_(const NamedTarget_& target,
+				    const std::string& appName,
+				    const char* value,
+				    const char* sourceType,
+				    const std::string& sourceName,
+				    size_t line) {
+  // The description of the source is only built if there is an error
+  auto argName= [this, &target, sourceType, &sourceName, line]() {
+    std::ostringstream tmp;
+    tmp << (target.handler ? target.handler->fullName()
+	                   : flags_.fullNameOf(flags_[target.flag]))
+	<< " (from " << sourceType << " " << sourceName;
+    if (line) {
+      tmp << ", line " << line;
+    }
+    tmp << ")";
+    return tmp.str();
+  };
+
+  try {
+    if (target.handler) {
+      const char* argv[]= { appName.c_str(), value, nullptr };
+      CmdLineArgGenerator args(2, const_cast<char**>(argv));
+      invokeHandler_(target.handler, args,
+		     target.handler->argName().str());
+      target.handler->setFound(true);
+    } else {
+      // An empty value works like the flag given without one, so
+      // "no-color =" in a file clears a flag
+      invokeFlag_(target.flag, target.negated, *value ? value : nullptr);
+      flagsFound_[target.flag]= true;
+    }
+  } catch(const FormatError& e) {
+    throw IllegalValueError(appName, argName(), e.value().c_str(),
+			    e.details());
+  } catch(const CmdLineArgError& e) {
+    throw;
+  } catch(const std::exception& e) {
+    throw IllegalValueError(appName, argName(), value, e.what());
+  } catch(...) {
+    throw IllegalValueError(appName, argName(), value);
+  }
+}
+
 void SimpleCmdLineArgs::init_(int argc, char** argv) {
   AbstractCmdLineArgs::init_(argc, argv);
   for (auto i= namedArgs_.begin(); i != namedArgs_.end(); ++i) {
     i->second->setFound(false);
+    i->second->setOccurrences(0);
   }
   for (auto i= unnamedArgs_.begin(); i != unnamedArgs_.end(); ++i) {
     (*i)->setFound(false);
   }
+  std::fill(flagOccurrences_.begin(), flagOccurrences_.end(), 0);
+  std::fill(flagsFound_.begin(), flagsFound_.end(), false);
   currentUnnamedArg_= unnamedArgs_.begin();
-  initValues_();
+  cmdLineConfigFiles_.clear();
+  appName_= (argc > 0) ? argv[0] : "";
+  currentHandler_= nullptr;
+  containerBytes_= 0;
+  argvBegin_= argv;
+  argvEnd_= argv + argc;
+  for (auto i= lazyValues_.begin(); i != lazyValues_.end(); ++i) {
+    (*i)->reset_();
+  }
+
+  {
+    ObservedCall call(parseObserver_, ParseObserver::Event::INIT_VALUES,
+		      INIT_VALUES_NAME);
+    initValues_();
+  }
+  if (preScan_) {
+    reserveContainers_(argc, argv);
+  }
 }
 
 bool SimpleCmdLineArgs::handleNamedArg_(CmdLineArgGenerator& args,
@@ -115,10 +1059,17 @@ bool SimpleCmdLineArgs::handleNamedArg_(CmdLineArgGenerator& args,
   if (AbstractCmdLineArgs::handleNamedArg_(args, argName)) {
     return true;
   } else {
-    HandlerMapType::iterator i= namedArgs_.find(argName);
+    HandlerMapType::iterator i= namedArgs_.find(ArgText::view(argName));
     if (i != namedArgs_.end()) {
+      const size_t occurrences= i->second->occurrences() + 1;
+      if (occurrences > parseLimits().maxOccurrences) {
+	throw ResourceLimitExceededError(args.appName(), i->second->fullName(),
+					 "Number of occurrences",
+					 parseLimits().maxOccurrences);
+      }
+      i->second->setOccurrences(occurrences);
       try {
-	i->second->handleValue(args, argName);
+	invokeHandler_(i->second, args, argName);
 	i->second->setFound(true);
 	return true;
       } catch(const FormatError& e) {
@@ -133,10 +1084,17 @@ bool SimpleCmdLineArgs::handleNamedArg_(CmdLineArgGenerator& args,
 	throw IllegalValueError(args.appName(), i->second->fullName(), "");
       }
     }
-    return false;
+    return handleFlag_(args.appName(), argName);
   }
 }
 
+std::vector<std::string> SimpleCmdLineArgs::suggestionsFor_(
+    const std::string& argName
+) const {
+  indexNames_();
+  return suggester_.suggest(argName);
+}
+
 bool SimpleCmdLineArgs::handleUnnamedArg_(CmdLineArgGenerator& args,
 					  const std::string& argValue) {
   if (AbstractCmdLineArgs::handleUnnamedArg_(args, argValue)) {
@@ -146,7 +1104,7 @@ bool SimpleCmdLineArgs::handleUnnamedArg_(CmdLineArgGenerator& args,
   } else {
     ArgHandler* h= *currentUnnamedArg_;
     try {
-      h->handleValue(args, argValue);
+      invokeHandler_(h, args, argValue);
       h->setFound(true);
       if (!h->final()) {
 	++currentUnnamedArg_;
@@ -167,6 +1125,8 @@ bool SimpleCmdLineArgs::handleUnnamedArg_(CmdLineArgGenerator& args,
 
 void SimpleCmdLineArgs::check_(const std::string& appName) {
   AbstractCmdLineArgs::check_(appName);
+  applyEnvironment_(appName);
+  applyConfigFiles_(appName);
   for (auto i= namedArgs_.begin(); i != namedArgs_.end(); ++i) {
     if (i->second->required() && !i->second->found()) {
 
@@ -179,7 +1139,61 @@ void SimpleCmdLineArgs::check_(const std::string& appName) {
       throw RequiredCmdLineArgMissingError(appName, h->fullName());
     }
   }
-  checkValues_();
+
+  ObservedCall call(parseObserver_, ParseObserver::Event::CHECK_VALUES,
+		    CHECK_VALUES_NAME);
+  ParseStats* stats= parseStats();
+  if (stats) {
+    const uint64_t start= ParseStats::now();
+    checkValues_();
+    stats->checkValuesTime += ParseStats::now() - start;
+  } else {
+    checkValues_();
+  }
+}
+
+void SimpleCmdLineArgs::invokeHandler_(ArgHandler* handler,
+				       CmdLineArgGenerator& args,
+				       const std::string& arg) {
+  currentHandler_= handler;
+  observeValue_(handler->argName(), [handler, &args, &arg]() {
+    handler->handleValue(args, arg);
+  });
+}
+
+void SimpleCmdLineArgs::invokeFlag_(size_t flag, bool negated,
+				    const char* value) {
+  const FlagTable::Flag& f= flags_[flag];
+  observeValue_(flags_.nameOf(f), [&f, negated, value]() {
+    setFlag_(f, negated, value);
+  });
+}
+
+template <typename Function>
+void SimpleCmdLineArgs::observeValue_(const ArgText& argName,
+				      const Function& f) {
+  ParseStats* stats= parseStats();
+  if (!stats && !parseObserver_) {
+    f();
+    return;
+  }
+
+  const std::string name= parseObserver_ ? argName.str() : std::string();
+  ObservedCall call(parseObserver_, ParseObserver::Event::HANDLE_VALUE, name);
+  if (!stats) {
+    f();
+    return;
+  }
+
+  ++stats->handlerInvocations;
+  const uint64_t start= ParseStats::now();
+  try {
+    f();
+  } catch(...) {
+    stats->conversionTime += ParseStats::now() - start;
+    throw;
+  }
+  stats->conversionTime += ParseStats::now() - start;
 }
 
 void SimpleCmdLineArgs::initValues_() {
@@ -190,6 +1204,178 @@ void SimpleCmdLineArgs::checkValues_() {
   // Default implementation does nothing
 }
 
+void SimpleCmdLineArgs::addContainerBytes_(size_t n) {
+  containerBytes_ += n;
+  if (containerBytes_ > parseLimits().maxContainerBytes) {
+    tooManyContainerBytes_();
+  }
+}
+
+void SimpleCmdLineArgs::tooManyContainerBytes_() const {
+  throw ResourceLimitExceededError(
+      appName_, currentHandler_ ? currentHandler_->fullName() : "",
+      "Number of bytes stored", parseLimits().maxContainerBytes
+  );
+}
+
+void SimpleCmdLineArgs::checkListSize_(const std::string& value,
+				       const std::string& separator) const {
+  if (!separator.empty() && !value.empty()) {
+    const char* const end= value.data() + value.size();
+    size_t n= 1;
+    for (const char* p= findSeparator_(value.data(), end, separator);
+	 p != end;
+	 p= findSeparator_(p + separator.size(), end, separator)) {
+      if (++n > parseLimits().maxListElements) {
+	tooManyListElements_();
+      }
+    }
+  }
+}
+
+const char* SimpleCmdLineArgs::findSeparator_(const char* begin,
+					      const char* end,
+					      const std::string& separator) {
+  const size_t n= separator.size();
+  if (!n) {
+    return end;
+  }
+  for (const char* p= begin; (end - p) >= (ptrdiff_t)n; ++p) {
+    p= (const char*)memchr(p, separator[0], end - p - n + 1);
+    if (!p) {
+      break;
+    } else if ((n == 1) || !memcmp(p + 1, separator.data() + 1, n - 1)) {
+      return p;
+    }
+  }
+  return end;
+}
+
+void SimpleCmdLineArgs::convertInParallel_(const std::string& value,
+					   char separator,
+					   ParallelSink_& sink) {
+  struct Chunk {
+    const char* begin;
+    const char* end;
+    size_t firstItem;
+    size_t failedItem;
+    std::exception_ptr error;
+  };
+
+  // Cut the value into a few chunks per thread, each ending just before
+  // a separator
+  const size_t numChunks= 4 * scheduler_->numThreads();
+  const size_t chunkSize= std::max(value.size() / numChunks, (size_t)4096);
+  const char* const end= value.data() + value.size();
+  std::vector<Chunk> chunks;
+  chunks.reserve(numChunks + 1);
+  for (const char* p= value.data(); ; ) {
+    const char* q= (p + chunkSize < end) ? p + chunkSize : end;
+    q= (const char*)memchr(q, separator, end - q);
+    chunks.push_back(Chunk{ p, q ? q : end, 0, 0, std::exception_ptr() });
+    if (!q) {
+      break;
+    }
+    p= q + 1;
+  }
+
+  // Count the items in each chunk to find the slot of its first item.
+  // Counting runs at the speed of memory, so it is not worth handing to
+  // the scheduler.
+  size_t total= 0;
+  for (auto i= chunks.begin(); i != chunks.end(); ++i) {
+    i->firstItem= total;
+    total += 1 + std::count(i->begin, i->end, separator);
+  }
+  if (total > parseLimits().maxListElements) {
+    tooManyListElements_();
+  }
+
+  // Every item takes at least its slot, so a list whose slots alone are
+  // over the byte limit fails before they are allocated.  Otherwise each
+  // chunk adds its bytes to a running total once it is converted, and a
+  // chunk that takes the total over the limit fails.
+  const bool limitBytes=
+      parseLimits().maxContainerBytes != ParseLimits::UNLIMITED;
+  const size_t maxBytes=
+      limitBytes ? parseLimits().maxContainerBytes - containerBytes_ : 0;
+  if (limitBytes && (total > maxBytes / sink.slotSize())) {
+    tooManyContainerBytes_();
+  }
+  std::atomic<size_t> numBytes(0);
+  sink.resize(total);
+
+  // Chunks after one with an illegal item are skipped, since only the
+  // first illegal item is reported
+  std::atomic<size_t> firstFailed(chunks.size());
+  scheduler_->run(chunks.size(), 1,
+		  [this, &chunks, &sink, &firstFailed, &numBytes, limitBytes,
+		   maxBytes, separator](size_t /* worker */, size_t begin,
+					size_t end) {
+    std::string item;
+    for (size_t i= begin; i < end; ++i) {
+      if (i > firstFailed.load(std::memory_order_relaxed)) {
+	continue;
+      }
+      Chunk& c= chunks[i];
+      size_t n= 0;
+      size_t bytes= 0;
+      for (const char* p= c.begin; ; ++n) {
+	const char* q= (const char*)memchr(p, separator, c.end - p);
+	item.assign(p, q ? q : c.end);
+	try {
+	  bytes += sink.convert(c.firstItem + n, item);
+	  if (!q && limitBytes &&
+	      ((numBytes.fetch_add(bytes, std::memory_order_relaxed) +
+		bytes) > maxBytes)) {
+	    tooManyContainerBytes_();
+	  }
+	} catch(const FormatError& e) {
+	  c.error= std::current_exception();
+	} catch(const CmdLineArgError& e) {
+	  c.error= std::current_exception();
+	} catch(const std::exception& e) {
+	  c.error= std::make_exception_ptr(FormatError(item, e.what()));
+	} catch(...) {
+	  c.error= std::make_exception_ptr(FormatError(item, std::string()));
+	}
+	if (c.error) {
+	  c.failedItem= n;
+	  size_t failed= firstFailed.load(std::memory_order_relaxed);
+	  while ((i < failed) &&
+		 !firstFailed.compare_exchange_weak(failed, i)) {
+	  }
+	  break;
+	} else if (!q) {
+	  break;
+	}
+	p= q + 1;
+      }
+    }
+  });
+
+  const size_t failed= firstFailed.load();
+  if (failed < chunks.size()) {
+    sink.truncate(chunks[failed].firstItem + chunks[failed].failedItem);
+    std::rethrow_exception(chunks[failed].error);
+  }
+  containerBytes_ += numBytes.load();
+}
+
+std::string SimpleCmdLineArgs::mappedPath_(const std::string& value) {
+  if ((value.size() < 2) || (value[0] != '@')) {
+    throw FormatError(value, "Expected @ followed by the path of a file");
+  }
+  return value.substr(1);
+}
+
+void SimpleCmdLineArgs::tooManyListElements_() const {
+  throw ResourceLimitExceededError(
+      appName_, currentHandler_ ? currentHandler_->fullName() : "",
+      "Number of list elements", parseLimits().maxListElements
+  );
+}
+
 SimpleCmdLineArgs::FormatError::FormatError(const std::string& details):
     PistisException(createMessage_("", details)), value_(), details_(details) {
   // Intentionally left blank
@@ -216,24 +1402,318 @@ std::string SimpleCmdLineArgs::FormatError::createMessage_(
   return msg.str();
 }
 
-SimpleCmdLineArgs::ArgHandler::ArgHandler(const std::string& argName,
-					  const std::string& description,
+SimpleCmdLineArgs::ArgHandler::ArgHandler(const ArgText& argName,
+					  const ArgText& description,
 					  bool isRequired,
 					  bool isFinal):
     argName_(argName), description_(description), required_(isRequired),
-    final_(isFinal), found_(false) {
+    final_(isFinal), found_(false), occurrences_(0), completions_() {
+  // Intentionally left blank
+}
+
+bool SimpleCmdLineArgs::ArgHandler::countItems(
+    const char* /* value */, size_t& /* numItems */
+) const {
+  return false;
+}
+
+void SimpleCmdLineArgs::ArgHandler::reserve(size_t /* numItems */) {
   // Intentionally left blank
 }
 
+const CompletionTrie& SimpleCmdLineArgs::ArgHandler::completions() const {
+  static const CompletionTrie NO_COMPLETIONS;
+  return completions_ ? *completions_ : NO_COMPLETIONS;
+}
+
+void SimpleCmdLineArgs::ArgHandler::addCompletion(const std::string& value) {
+  if (!completions_) {
+    completions_.reset(new CompletionTrie());
+  }
+  completions_->insert(value);
+}
+
 std::string SimpleCmdLineArgs::ArgHandler::fullName() const {
-  if (!argName_.empty() && !description_.empty()) {
-    std::ostringstream tmp;
-    tmp << description_ << " (" << argName_ << ")";
-    return tmp.str();
-  } else if (!description_.empty()) {
-    return description_;
+  if (argName_.empty() || description_.empty()) {
+    return description_.empty() ? argName_.str() : description_.str();
+  }
+
+  std::string name;
+  name.reserve(description_.size() + argName_.size() + 3);
+  name.append(description_.data(), description_.size());
+  name.append(" (");
+  name.append(argName_.data(), argName_.size());
+  name.push_back(')');
+  return name;
+}
+
+SimpleCmdLineArgs::KernelArgHandler::KernelArgHandler(
+    const ArgText& argName, const ArgText& description,
+    bool isRequired, bool isFinal, SimpleCmdLineArgs& owner,
+    void* destination, StoreFn store, ReserveFn reserve,
+    const std::shared_ptr<const void>& constraint
+):
+    ArgHandler(argName, description, isRequired, isFinal), owner_(owner),
+    destination_(destination), store_(store), reserve_(reserve),
+    parallelStore_(nullptr), constraint_(constraint),
+    split_(false), separator_(), allowEmpty_(false) {
+  // Intentionally left blank
+}
+
+SimpleCmdLineArgs::KernelArgHandler::KernelArgHandler(
+    const ArgText& argName, const ArgText& description,
+    bool isRequired, bool isFinal, SimpleCmdLineArgs& owner,
+    void* destination, StoreFn store, ReserveFn reserve,
+    const std::shared_ptr<const void>& constraint,
+    const std::string& separator, bool allowEmpty
+):
+    ArgHandler(argName, description, isRequired, isFinal), owner_(owner),
+    destination_(destination), store_(store), reserve_(reserve),
+    parallelStore_(nullptr), constraint_(constraint),
+    split_(true), separator_(separator), allowEmpty_(allowEmpty) {
+  // Intentionally left blank
+}
+
+void SimpleCmdLineArgs::KernelArgHandler::handleValue(
+    CmdLineArgGenerator& args, const std::string& arg
+) {
+  store(argName().empty() ? arg : args.next(arg));
+}
+
+void SimpleCmdLineArgs::KernelArgHandler::store(const std::string& value) {
+  // Only vector and unordered_set destinations have a reserve_, and they
+  // read list files whether or not their values are split
+  if (owner_.listFiles_ && (split_ || reserve_) && (value.size() > 1) &&
+      (value[0] == '@')) {
+    owner_.readListFile_(value, [this](const std::string& item) {
+      store_(owner_, destination_, constraint_.get(), item);
+    });
+  } else if (!split_) {
+    store_(owner_, destination_, constraint_.get(), value);
+  } else if (parallelStore_ && (value.size() >= owner_.parallelMinSize_) &&
+	     (separator_.size() == 1) && !value.empty()) {
+    parallelStore_(owner_, destination_, constraint_.get(), value,
+		   separator_[0]);
+  } else {
+    owner_.applyToItems_(value, separator_, allowEmpty_,
+			 [this](const std::string& item) {
+      store_(owner_, destination_, constraint_.get(), item);
+    });
+  }
+}
+
+bool SimpleCmdLineArgs::KernelArgHandler::countItems(const char* value,
+						     size_t& numItems) const {
+  if (!reserve_) {
+    numItems= 0;
+  } else if (!split_ || separator_.empty()) {
+    numItems= 1;
+  } else if (!*value) {
+    numItems= 0;
+  } else if (separator_.size() == 1) {
+    const char* end= value + strlen(value);
+    numItems= 1 + std::count(value, end, separator_[0]);
   } else {
-    return argName_;
+    numItems= 1;
+    for (const char* p= strstr(value, separator_.c_str()); p;
+	 p= strstr(p + separator_.size(), separator_.c_str())) {
+      ++numItems;
+    }
   }
+  return true;
 }
 
+void SimpleCmdLineArgs::KernelArgHandler::reserve(size_t numItems) {
+  if (reserve_) {
+    reserve_(destination_, numItems, owner_.parseLimits().maxContainerBytes);
+  }
+}
+
+SimpleCmdLineArgs::LazyArgHandler::LazyArgHandler(
+    const ArgText& argName, const ArgText& description, bool isRequired,
+    SimpleCmdLineArgs& owner, LazyBase& lazy, void* destination,
+    StoreFn store, const std::shared_ptr<const void>& constraint
+):
+    KernelArgHandler(argName, description, isRequired, true, owner,
+		     destination, store, nullptr, constraint),
+    lazy_(lazy) {
+  // Intentionally left blank
+}
+
+SimpleCmdLineArgs::LazyArgHandler::LazyArgHandler(
+    const ArgText& argName, const ArgText& description, bool isRequired,
+    SimpleCmdLineArgs& owner, LazyBase& lazy, void* destination,
+    StoreFn store, const std::shared_ptr<const void>& constraint,
+    const std::string& separator, bool allowEmpty
+):
+    KernelArgHandler(argName, description, isRequired, true, owner,
+		     destination, store, nullptr, constraint, separator,
+		     allowEmpty),
+    lazy_(lazy) {
+  // Intentionally left blank
+}
+
+void SimpleCmdLineArgs::LazyArgHandler::handleValue(
+    CmdLineArgGenerator& args, const std::string& arg
+) {
+  // Values from the parsed argv are recorded where they are.  Values
+  // from the environment or configuration files are copied, since
+  // their text does not outlive the parse.
+  char** const p= args.remainingArgv();
+  const char* token= args.nextToken(arg);
+
+  // The number of items can be checked without converting them, so a
+  // list that is too long fails the parse as it would for other
+  // destinations
+  if (owner().parseLimits().maxListElements != ParseLimits::UNLIMITED) {
+    owner().checkListSize_(token, separator());
+  }
+  if ((p >= owner().argvBegin_) && (p < owner().argvEnd_)) {
+    lazy_.addToken_(token);
+  } else {
+    lazy_.addCopy_(token);
+  }
+}
+
+void SimpleCmdLineArgs::LazyArgHandler::convert(
+    const std::vector<const char*>& tokens
+) {
+  SimpleCmdLineArgs& args= owner();
+  args.currentHandler_= this;
+  for (auto i= tokens.begin(); i != tokens.end(); ++i) {
+    try {
+      store(*i);
+    } catch(const FormatError& e) {
+      throw IllegalValueError(args.appName_, fullName(), e.value().c_str(),
+			      e.details());
+    } catch(const CmdLineArgError& e) {
+      throw;
+    } catch(const std::exception& e) {
+      throw IllegalValueError(args.appName_, fullName(), *i, e.what());
+    } catch(...) {
+      throw IllegalValueError(args.appName_, fullName(), *i);
+    }
+  }
+}
+
+int SimpleCmdLineArgs::ArgFormatter<int>::format(const std::string& value) {
+  std::pair<int64_t, util::NumConversionResult> v =
+    util::toInt64Quietly(value);
+  if (v.second != util::NumConversionResult::OK) {
+    throw FormatError(value, descriptionFor(v.second));
+  }
+  return v.first;
+}
+
+int SimpleCmdLineArgs::ArgFormatter<int>::format(const std::string& value,
+						  int minValue, int maxValue) {
+  int v= format(value);
+  if ((v < minValue) || (v > maxValue)) {
+    std::ostringstream msg;
+    if (minValue == INT_MIN) {
+      msg << "Value must be less than or equal to " << maxValue;
+    } else if (maxValue == INT_MAX) {
+      msg << "Value must be greater than or equal to " << maxValue;
+    } else {
+      msg << "Value must be between " << minValue << "and "
+	  << maxValue << " (inclusive)";
+    }
+    throw FormatError(value, msg.str());
+  }
+  return v;
+}
+
+int SimpleCmdLineArgs::ArgFormatter<int>::format(
+    const std::string& value, const std::unordered_set<int>& legalValues
+) {
+  int v= format(value);
+  if (legalValues.find(v) == legalValues.end()) {
+    std::ostringstream msg;
+    msg << "Legal values are "
+	<< util::join(legalValues.begin(), legalValues.end(), ", ");
+    throw FormatError(value, msg.str());
+  }
+  return v;
+}
+
+double SimpleCmdLineArgs::ArgFormatter<double>::format(
+    const std::string& value
+) {
+  std::pair<double, util::NumConversionResult> v=
+    util::toDoubleQuietly(value);
+  if (v.second != util::NumConversionResult::OK) {
+    throw FormatError(value, descriptionFor(v.second));
+  }
+  return v.first;
+}
+
+double SimpleCmdLineArgs::ArgFormatter<double>::format(
+    const std::string& value, double minValue, double maxValue
+) {
+  double v= format(value);
+  if ((v < minValue) || (v > maxValue)) {
+    std::ostringstream msg;
+    if (minValue == -DBL_MAX) {
+      msg << "Value must be less than or equal to " << maxValue;
+    } else if (maxValue == DBL_MAX) {
+      msg << "Value must be greater than or equal to " << maxValue;
+    } else {
+      msg << "Value must be between " << minValue << "and "
+	  << maxValue << " (inclusive)";
+    }
+    throw FormatError(value, msg.str());
+  }
+  return v;
+}
+
+double SimpleCmdLineArgs::ArgFormatter<double>::format(
+    const std::string& value, const std::unordered_set<double>& legalValues
+) {
+  double v= format(value);
+  if (legalValues.find(v) == legalValues.end()) {
+    std::ostringstream msg;
+    msg << "Legal values are "
+	<< util::join(legalValues.begin(), legalValues.end(), ", ");
+    throw FormatError(value, msg.str());
+  }
+  return v;
+}
+
+const std::string& SimpleCmdLineArgs::ArgFormatter<std::string>::format(
+    const std::string& value, const std::string& minValue,
+    const std::string& maxValue
+) {
+  if ((value < minValue) || (value > maxValue)) {
+    std::ostringstream msg;
+    msg << "Value must be between \"" << minValue << "\" and \""
+	<< maxValue << "\" (inclusive)";
+    throw FormatError(value, msg.str());
+  }
+  return value;
+}
+
+const std::string& SimpleCmdLineArgs::ArgFormatter<std::string>::format(
+    const std::string& value,
+    const std::unordered_set<std::string>& legalValues
+) {
+  if (legalValues.find(value) == legalValues.end()) {
+    std::ostringstream msg;
+    msg << "Legal values are \""
+	<< util::join(legalValues.begin(), legalValues.end(),
+		      "\", \"")
+	<< "\"";
+    throw FormatError(value, msg.str());
+  }
+  return value;
+}
+
+namespace pistis {
+  namespace arg_parser {
+    PISTIS_ARG_PARSER_KERNELS_(, int)
+    PISTIS_ARG_PARSER_KERNELS_(, double)
+    PISTIS_ARG_PARSER_KERNELS_(, std::string)
+    PISTIS_ARG_PARSER_PARALLELS_(, int)
+    PISTIS_ARG_PARSER_PARALLELS_(, double)
+    PISTIS_ARG_PARSER_PARALLELS_(, std::string)
+  }
+}
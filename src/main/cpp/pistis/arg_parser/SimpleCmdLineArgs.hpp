@@ -1,18 +1,40 @@
 #ifndef __PISTIS__ARG_PARSER__SIMPLECMDLINEARGS_HPP__
 #define __PISTIS__ARG_PARSER__SIMPLECMDLINEARGS_HPP__
 
+#include <pistis/exceptions/IllegalValueError.hpp>
 #include <pistis/exceptions/ItemExistsError.hpp>
 #include <pistis/exceptions/NoSuchItem.hpp>
 #include <pistis/util/NumUtil.hpp>
 #include <pistis/util/StringUtil.hpp>
 #include <pistis/arg_parser/AbstractCmdLineArgs.hpp>
+#include <pistis/arg_parser/ArgConversion.hpp>
+#include <pistis/arg_parser/ArgText.hpp>
 #include <pistis/arg_parser/CmdLineArgGenerator.hpp>
+#include <pistis/arg_parser/CompletionTrie.hpp>
+#include <pistis/arg_parser/DuplicateKeyPolicy.hpp>
+#include <pistis/arg_parser/FlagTable.hpp>
+#include <pistis/arg_parser/Lazy.hpp>
+#include <pistis/arg_parser/MappedArray.hpp>
+#include <pistis/arg_parser/OptionSuggester.hpp>
+#include <pistis/arg_parser/ParseObserver.hpp>
+#include <pistis/arg_parser/RuntimeFlagRegistry.hpp>
+#include <pistis/arg_parser/SeededHash.hpp>
+#include <pistis/arg_parser/WorkStealingScheduler.hpp>
+#include <algorithm>
+#include <atomic>
+#include <bitset>
 #include <exception>
 #include <functional>
+#include <limits>
+#include <map>
+#include <memory>
 #include <sstream>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#include <stdint.h>
+#include <string.h>
 
 namespace pistis {
   namespace arg_parser {
@@ -62,15 +84,20 @@ namespace pistis {
 	  Value operator[](const std::string& key) const {
 	    auto i= values_.find(key);
 	    if (i == values_.end()) {
-	      std::vector<std::string> keys(allKeys());
-	      std::ostringstream msg;
-	      msg << "Legal values are \""
-		  << util::join(keys.begin(), keys.end(), "\", \"")
-		  << "\"";
-	      throw FormatError(key, msg.str());
+	      throw FormatError(key, legalValues());
 	    }
 	    return i->second;
 	  }
+
+	  /** Message listing the keys, for values that are not one */
+	  std::string legalValues() const {
+	    std::vector<std::string> keys(allKeys());
+	    std::ostringstream msg;
+	    msg << "Legal values are \""
+		<< util::join(keys.begin(), keys.end(), "\", \"")
+		<< "\"";
+	    return msg.str();
+	  }
 	  void setValue(const std::string& key, const Value& value) {
 	    if (hasValue(key)) {
 	      throw exceptions::ItemExistsError(key, PISTIS_EX_HERE);
@@ -94,34 +121,59 @@ namespace pistis {
 
 	class ArgHandler {
 	public:
-	  ArgHandler(const std::string& argName, const std::string& description,
+	  ArgHandler(const ArgText& argName, const ArgText& description,
 		     bool isRequired, bool isFinal);
 
-	  const std::string& argName() const { return argName_; }
-	  const std::string& description() const { return description_; }
+	  const ArgText& argName() const { return argName_; }
+	  const ArgText& description() const { return description_; }
 	  bool required() const { return required_; }
 	  bool final() const { return final_; }
 	  bool found() const { return found_; }
+	  size_t occurrences() const { return occurrences_; }
+	  const CompletionTrie& completions() const;
 
+	  /** The description followed by the name in parentheses, built
+	   *  only when needed, which is mostly for error messages.
+	   */
 	  std::string fullName() const;
 
 	  void setFound(bool v) { found_= v; }
+	  void setOccurrences(size_t n) { occurrences_= n; }
+	  void addCompletion(const std::string& value);
 	  virtual void handleValue(CmdLineArgGenerator& args,
 				   const std::string& arg) = 0;
 
+	  /** If the handler always takes exactly one value, set numItems
+	   *  to the number of items value would add to the container it
+	   *  stores them in, or to 0 if it stores no container, and return
+	   *  true.  Handlers that cannot tell return false, which is the
+	   *  default.
+	   */
+	  virtual bool countItems(const char* value, size_t& numItems) const;
+
+	  /** Make room for numItems more items in the handler's container.
+	   *  Does nothing by default.
+	   */
+	  virtual void reserve(size_t numItems);
+
 	private:
-	  std::string argName_;
-	  std::string description_;
+	  ArgText argName_;
+	  ArgText description_;
 	  bool required_;
 	  bool final_;
 	  bool found_;
+	  size_t occurrences_;
+
+	  // Most arguments have no completions, so the trie is only created
+	  // when the first one is added
+	  std::unique_ptr<CompletionTrie> completions_;
 	};
 
 	template <typename Delegate>
 	class DelegatingArgHandler : public ArgHandler {
 	public:
-	  DelegatingArgHandler(const std::string& argName,
-			       const std::string& description,
+	  DelegatingArgHandler(const ArgText& argName,
+			       const ArgText& description,
 			       bool isRequired,
 			       bool isFinal,
 			       const Delegate& delegate):
@@ -138,20 +190,321 @@ namespace pistis {
 	  Delegate delegate_;
 	};
 
+	/** Handler for arguments registered with a destination.
+	 *
+	 *  The value, or each item of it if it is a separated list, is
+	 *  converted, checked and stored by a function chosen by the types
+	 *  of the destination and of the constraint on the value.  Handlers
+	 *  with the same types share that function, and the functions for
+	 *  int, double and std::string destinations are compiled into the
+	 *  library, so registering an argument generates almost no code.
+	 */
+	class KernelArgHandler : public ArgHandler {
+	public:
+	  typedef void (*StoreFn)(SimpleCmdLineArgs& owner, void* destination,
+				  const void* constraint,
+				  const std::string& value);
+	  typedef void (*ReserveFn)(void* destination, size_t numItems,
+				    size_t maxBytes);
+	  typedef void (*ParallelStoreFn)(SimpleCmdLineArgs& owner,
+					  void* destination,
+					  const void* constraint,
+					  const std::string& value,
+					  char separator);
+
+	public:
+	  KernelArgHandler(const ArgText& argName,
+			   const ArgText& description,
+			   bool isRequired, bool isFinal,
+			   SimpleCmdLineArgs& owner, void* destination,
+			   StoreFn store, ReserveFn reserve,
+			   const std::shared_ptr<const void>& constraint);
+	  KernelArgHandler(const ArgText& argName,
+			   const ArgText& description,
+			   bool isRequired, bool isFinal,
+			   SimpleCmdLineArgs& owner, void* destination,
+			   StoreFn store, ReserveFn reserve,
+			   const std::shared_ptr<const void>& constraint,
+			   const std::string& separator, bool allowEmpty);
+
+	  virtual void handleValue(CmdLineArgGenerator& args,
+				   const std::string& arg);
+	  virtual bool countItems(const char* value, size_t& numItems) const;
+	  virtual void reserve(size_t numItems);
+
+	  /** Function that converts the items of long list values on
+	   *  several threads, or nullptr if they are always converted on
+	   *  the calling thread.
+	   */
+	  void setParallelStore(ParallelStoreFn f) { parallelStore_= f; }
+
+	protected:
+	  SimpleCmdLineArgs& owner() const { return owner_; }
+
+	  /** Separator list values are split at, or "" if they are not */
+	  const std::string& separator() const { return separator_; }
+
+	  /** Convert value, or each item in it if it is a list, and store
+	   *  the result in the destination.
+	   */
+	  void store(const std::string& value);
+
+	private:
+	  SimpleCmdLineArgs& owner_;
+	  void* destination_;
+	  StoreFn store_;
+	  ReserveFn reserve_;
+	  ParallelStoreFn parallelStore_;
+	  std::shared_ptr<const void> constraint_;
+	  bool split_;
+	  std::string separator_;
+	  bool allowEmpty_;
+	};
+
+	/** Handles a named argument with a Lazy destination.  Values are
+	 *  recorded by handleValue() and converted by convert() the first
+	 *  time the destination is used.
+	 */
+	class LazyArgHandler : public KernelArgHandler, public LazyConverter {
+	public:
+	  LazyArgHandler(const ArgText& argName,
+			 const ArgText& description,
+			 bool isRequired, SimpleCmdLineArgs& owner,
+			 LazyBase& lazy, void* destination,
+			 StoreFn store,
+			 const std::shared_ptr<const void>& constraint);
+	  LazyArgHandler(const ArgText& argName,
+			 const ArgText& description,
+			 bool isRequired, SimpleCmdLineArgs& owner,
+			 LazyBase& lazy, void* destination,
+			 StoreFn store,
+			 const std::shared_ptr<const void>& constraint,
+			 const std::string& separator, bool allowEmpty);
+
+	  virtual void handleValue(CmdLineArgGenerator& args,
+				   const std::string& arg);
+	  virtual void convert(const std::vector<const char*>& tokens);
+
+	private:
+	  LazyBase& lazy_;
+	};
+
+	/** Constraints on the values of arguments handled by a
+	 *  KernelArgHandler.  Sets of legal values, ValueMaps and
+	 *  std::functions are constraints as they are.
+	 */
+	struct NoConstraint_ { };
+
+	/** The bits that names of enum values set in a bitmask.  The
+	 *  ValueMap is indexed once, when the argument is registered, and
+	 *  only consulted again to report a name it does not have.
+	 */
+	template <typename Value>
+	struct EnumBits_ {
+	  ValueMap<Value> values;
+	  std::unordered_map<std::string, uint32_t,
+			     SeededHash<std::string> > bits;
+	  std::string separator;
+	  bool allowEmpty;
+
+	  EnumBits_(const ValueMap<Value>& values, size_t numBits,
+		    const std::string& separator, bool allowEmpty):
+	      values(values), bits(), separator(separator),
+	      allowEmpty(allowEmpty) {
+	    std::vector<std::string> keys(values.allKeys());
+	    for (auto i= keys.begin(); i != keys.end(); ++i) {
+	      const size_t bit= (size_t)values[*i];
+	      if (bit >= numBits) {
+		throw exceptions::IllegalValueError(
+		    "valueMap", *i,
+		    "Value must be less than " + std::to_string(numBits) +
+		    " to fit in the destination",
+		    PISTIS_EX_HERE
+		);
+	      }
+	      bits.insert(std::make_pair(*i, (uint32_t)bit));
+	    }
+	  }
+	};
+
+	/** How the values of arguments with map destinations are split
+	 *  into key=value pairs.
+	 */
+	struct KeyValueFormat_ {
+	  std::string separator;
+	  DuplicateKeyPolicy onDuplicate;
+
+	  KeyValueFormat_(const std::string& separator,
+			  DuplicateKeyPolicy onDuplicate):
+	      separator(separator), onDuplicate(onDuplicate) {
+	  }
+	};
+
+	template <typename Value>
+	struct Range_ {
+	  Value minValue;
+	  Value maxValue;
+
+	  Range_(const Value& minValue, const Value& maxValue):
+	      minValue(minValue), maxValue(maxValue) {
+	  }
+	};
+
 	template <typename Value>
 	class ArgFormatter {
 	  static_assert(sizeof(Value) == 0,
-			"Unsupported destination value type");
+			"Unsupported destination value type; specialize "
+			"pistis::arg_parser::ArgConversion for it");
 	};
 
 
-	typedef std::unordered_map<std::string, ArgHandler*> HandlerMapType;
+	/** Keys of named arguments refer to the names held by their
+	 *  handlers, so adding an argument does not copy its name.
+	 */
+	typedef std::unordered_map<ArgText, ArgHandler*,
+				   SeededHash<ArgText> > HandlerMapType;
 	typedef std::vector<ArgHandler*> HandlerListType;
 
+	/** A named argument given a value by the environment or a
+	 *  configuration file: either a handler or the flag at index flag
+	 *  of flags_, which negated says was named by its "--no-" name.
+	 */
+	struct NamedTarget_ {
+	  ArgHandler* handler;
+	  uint32_t flag;
+	  bool negated;
+
+	  NamedTarget_(ArgHandler* handler):
+	      handler(handler), flag(0), negated(false) {
+	  }
+	  NamedTarget_(uint32_t flag, bool negated):
+	      handler(nullptr), flag(flag), negated(negated) {
+	  }
+	};
+
+	/** The target an environment variable is bound to, and the order
+	 *  the variable was bound in
+	 */
+	struct EnvTarget_ {
+	  NamedTarget_ target;
+	  size_t order;
+	};
+
+	typedef std::unordered_map<ArgText, EnvTarget_,
+				   SeededHash<ArgText> > EnvMapType;
+
       public:
 	SimpleCmdLineArgs();
 	virtual ~SimpleCmdLineArgs();
 
+	/** Compile the configuration file at path into the binary image at
+	 *  imagePath, for use with addConfigFile_().  Throws ConfigFileError
+	 *  if the file cannot be read or has an unknown key, and
+	 *  pistis::exceptions::IllegalValueError if the image cannot be
+	 *  written.
+	 */
+	void compileConfigFile(const std::string& path,
+			       const std::string& imagePath) const;
+
+	/** Paths of the configuration files read by the last parse, both
+	 *  those given to addConfigFile_() and those given on the command
+	 *  line.  Files that were optional and missing are included.
+	 */
+	std::vector<std::string> configFilePaths() const;
+
+	/** Options registered with std::atomic destinations, which can be
+	 *  changed while the program runs.
+	 */
+	const RuntimeFlagRegistry& runtimeFlags() const {
+	  return runtimeFlags_;
+	}
+
+	/** Observer told about each call to a handler, initValues_() and
+	 *  checkValues_(), or nullptr if there is none.  The observer is not
+	 *  owned and must outlive any parse that uses it.
+	 */
+	ParseObserver* parseObserver() const { return parseObserver_; }
+	void setParseObserver(ParseObserver* observer) {
+	  parseObserver_= observer;
+	}
+
+	/** Whether parse() counts the values of each argument before
+	 *  handling any of them, and reserves room for them in vector and
+	 *  unordered_set destinations.  Off by default, since the extra pass
+	 *  over the command line only pays off for long lists.  Reservations
+	 *  are capped at ParseLimits::maxListElements.
+	 */
+	bool preScan() const { return preScan_; }
+	void setPreScan(bool enabled) { preScan_= enabled; }
+
+	/** Convert the items of list values at least minSize bytes long on
+	 *  numThreads threads, or one per core if numThreads is 0.  The
+	 *  value is cut into chunks at separators, the chunks are converted
+	 *  concurrently into slots reserved at the end of the destination,
+	 *  and the items keep their order.  An illegal item is reported just
+	 *  as it would be by a serial conversion: the first one in the
+	 *  value is the one reported, and the items before it are kept.
+	 *  ParseLimits::maxContainerBytes is checked against a running total
+	 *  as each chunk is converted, so a conversion goes at most a few
+	 *  chunks past the limit before it stops.
+	 *
+	 *  Only vector destinations with single-character separators whose
+	 *  values are converted by ArgFormatter, with or without a range,
+	 *  set of legal values or ValueMap, are converted in parallel.  Other
+	 *  destinations, including any converted by a std::function or an
+	 *  ArgConversion, which need not be thread-safe, are converted on the
+	 *  parsing thread as before.  Parallel conversion is off until this
+	 *  is called, and setParallelConversion(SIZE_MAX) turns it off.
+	 */
+	void setParallelConversion(size_t minSize, size_t numThreads = 0);
+	size_t parallelConversionMinSize() const {
+	  return parallelMinSize_;
+	}
+
+	/** Whether a value of "@" followed by a path gives a vector or
+	 *  unordered_set destination the items in that file, one per line,
+	 *  instead of being split into items or stored as one item itself.
+	 *  Other destinations store such a value as it is.  The file is
+	 *  read in chunks of LIST_FILE_CHUNK_SIZE bytes and its items are
+	 *  stored as they are read, so it is never held in memory whole.  A
+	 *  line longer than MAX_LIST_FILE_LINE_SIZE bytes, or than
+	 *  ParseLimits::maxTokenSize if that is smaller, is an error.  Empty
+	 *  lines and a carriage return before each newline are ignored, and
+	 *  an illegal item is reported with its line number.  Off by
+	 *  default, since it changes the meaning of values that begin with
+	 *  "@".
+	 */
+	bool listFiles() const { return listFiles_; }
+	void setListFiles(bool enabled) { listFiles_= enabled; }
+
+	static const size_t LIST_FILE_CHUNK_SIZE= 64 * 1024;
+	static const size_t MAX_LIST_FILE_LINE_SIZE= 1024 * 1024;
+
+	/** Convert every Lazy destination that has not been converted
+	 *  since the last parse, throwing IllegalValueError for the first
+	 *  illegal value.  Call it after parse() to check all values the
+	 *  way an eager parse would.
+	 */
+	void validateAll() const;
+
+	/** Answer a shell-completion request.
+	 *
+	 *  If argv[1] is "--__complete", argv[2] is the index of the word
+	 *  being completed among the words of the command line being
+	 *  edited, which follow in argv[3] onwards starting with the program
+	 *  name.  The candidates are written to fd, one per line, with a
+	 *  single write, and true is returned.  Otherwise nothing is written
+	 *  and false is returned.  Candidates come from tries built while the
+	 *  arguments were registered: option names for words beginning with
+	 *  '-', and the ValueMap keys or legal values of the argument the
+	 *  word belongs to otherwise.
+	 *
+	 *  Call this at the start of main(), right after constructing the
+	 *  arguments and before any other initialization, and exit if it
+	 *  returns true.
+	 */
+	bool complete(int argc, char** argv, int fd = 1) const;
+
       protected:
 	template <typename Formatter>
 	static auto formatUsingFn(const std::string& value,
@@ -181,6 +534,8 @@ namespace pistis {
 		f(*i);
 	      } catch(const FormatError& e) {
 		throw;
+	      } catch(const CmdLineArgError& e) {
+		throw;
 	      } catch(const std::exception& e) {
 		throw FormatError(*i, e.what());
 	      } catch(...) {
@@ -192,423 +547,565 @@ namespace pistis {
 	  }
 	}
 				  
+	/** Add v to a vector or set destination, counting it against
+	 *  ParseLimits::maxContainerBytes.
+	 */
+	template <typename Container, typename Value>
+	void addTo_(Container& c, Value&& v) {
+	  if (parseLimits().maxContainerBytes != ParseLimits::UNLIMITED) {
+	    addContainerBytes_(sizeOfValue_(v));
+	  }
+	  insertInto_(c, std::forward<Value>(v));
+	}
+
+	/** Convert value and store it in d, which is a Value, a vector of
+	 *  Values or an unordered_set of Values.  Values are converted by
+	 *  their ArgConversion, if they have one, and otherwise by
+	 *  ArgFormatter.
+	 */
+	template <typename Destination>
+	void convertInto_(Destination& d, const std::string& value) {
+	  typedef typename ItemOf_<Destination>::Type Value;
+	  convertInto_(d, value, HasArgConversion<Value>());
+	}
+
+	/** splitAndApply(), but rejecting lists with more items than
+	 *  ParseLimits::maxListElements before any item is converted.
+	 */
+	template <typename Function>
+	void applyToItems_(const std::string& value,
+			   const std::string& separator,
+			   bool allowEmpty,
+			   const Function& f) {
+	  if (parseLimits().maxListElements != ParseLimits::UNLIMITED) {
+	    checkListSize_(value, separator);
+	  }
+	  splitAndApply(value, separator, allowEmpty, f);
+	}
+
+	/** Throw ResourceLimitExceededError if value is a list of more
+	 *  than ParseLimits::maxListElements items.
+	 */
+	void checkListSize_(const std::string& value,
+			    const std::string& separator) const;
+
+	/** Start of the first occurrence of separator in [begin, end), or
+	 *  end if there is none or separator is empty.
+	 */
+	static const char* findSeparator_(const char* begin, const char* end,
+					  const std::string& separator);
+
+	/** Call f(key, value) for each key=value pair in text, which is a
+	 *  list of pairs separated by separator, or a single pair if
+	 *  separator is empty.  A key ends at the first '=' and its value
+	 *  at the next separator, so values may contain '=' but neither
+	 *  may contain the separator.  Each list is scanned once, with
+	 *  memchr(), and the key and value passed to f are reused for every
+	 *  pair.
+	 */
+	template <typename Function>
+	void applyToPairs_(const std::string& text,
+			   const std::string& separator,
+			   const Function& f) {
+	  if (text.empty()) {
+	    throw FormatError("Value is empty");
+	  } else if (parseLimits().maxListElements != ParseLimits::UNLIMITED) {
+	    checkListSize_(text, separator);
+	  }
+
+	  const char* const end= text.data() + text.size();
+	  std::string key;
+	  std::string value;
+	  for (const char* p= text.data(); ; p += separator.size()) {
+	    const char* next= findSeparator_(p, end, separator);
+	    const char* eq= (const char*)memchr(p, '=', next - p);
+	    if (!eq) {
+	      throw FormatError(std::string(p, next), "Expected key=value");
+	    } else if (eq == p) {
+	      throw FormatError(std::string(p, next), "Key is empty");
+	    }
+	    key.assign(p, eq);
+	    value.assign(eq + 1, next);
+	    try {
+	      f(key, value);
+	    } catch(const FormatError& e) {
+	      throw;
+	    } catch(const CmdLineArgError& e) {
+	      throw;
+	    } catch(const std::exception& e) {
+	      throw FormatError(std::string(p, next), e.what());
+	    }
+	    if (next == end) {
+	      break;
+	    }
+	    p= next;
+	  }
+	}
+
 	template <typename Value>
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
 			       Value& v) {
-	  ArgHandler* h =
-	      createDelegate_(argName, description, required, true,
-			    [&v](CmdLineArgGenerator& args,
-				 const std::string& argName) -> void {
-	        v = ArgFormatter<Value>::format(args.next(argName));
-	      });
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    NoConstraint_());
 	  registerHandler_(h);
 	}
 
+	/** Register a named argument whose destination can also be changed
+	 *  through runtimeFlags() while the program runs.  Readers of v only
+	 *  need a relaxed atomic load.
+	 */
+	template <typename Value>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
+			       bool required,
+			       std::atomic<Value>& v) {
+	  registerAtomicArg_(argName, description, required, v,
+			     [](const std::string& value) {
+	    return ArgFormatter<Value>::format(value);
+	  });
+	}
+
+	/** Register a named argument whose value is converted when v is
+	 *  first used rather than during parse().  If the argument is given
+	 *  more than once, a container destination gets every value and any
+	 *  other destination gets the last one.
+	 */
+	template <typename Value>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
+			       bool required,
+			       Lazy<Value>& v) {
+	  registerLazy_(
+	      v, new LazyArgHandler(argName, description, required, *this, v,
+				    &v.value_,
+				    &storeItem_<Value, NoConstraint_>,
+				    holdConstraint_(NoConstraint_()))
+	  );
+	}
+
+	/** As above, for a vector or unordered_set destination whose
+	 *  values are lists of items separated by separator.
+	 */
+	template <typename Container>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
+			       bool required,
+			       const std::string& separator,
+			       bool allowEmpty,
+			       Lazy<Container>& v) {
+	  LazyArgHandler* h=
+	      new LazyArgHandler(argName, description, required, *this, v,
+				 &v.value_,
+				 &storeItem_<Container, NoConstraint_>,
+				 holdConstraint_(NoConstraint_()), separator,
+				 allowEmpty);
+	  h->setParallelStore(
+	      parallelStoreFor_(v.value_, (const NoConstraint_*)nullptr)
+	  );
+	  registerLazy_(v, h);
+	}
+
 	template <typename Value>
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
 			       std::vector<Value>& v) {
-	  ArgHandler *h =
-	      createDelegate_(argName, description, required, true,
-			      [&v](CmdLineArgGenerator& args,
-				   const std::string& argName) -> void {
-	        v.push_back(ArgFormatter<Value>::format(args.next(argName)));
-	      });
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    NoConstraint_());
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
 			       const std::string& separator,
 			       bool allowEmpty,
 			       std::vector<Value>& v) {
-	  ArgHandler *h =
-	    createDelegate_(
-	        argName, description, required, true,
-		[&v, separator, allowEmpty, this](
-		    CmdLineArgGenerator& args, const std::string& argName
-		) -> void {
-	          splitAndApply(args.next(argName), separator, allowEmpty,
-				[&v](const std::string& value) -> void {
-		    v.push_back(ArgFormatter<Value>::format(value));
-	          });
-		}
-	    );
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    NoConstraint_(), separator, allowEmpty);
 	  registerHandler_(h);
 	}
 	
-	template <typename Value>
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
-			       std::unordered_set<Value>& v) {
-	  ArgHandler *h=
-	      createDelegate_(argName, description, required, true,
-                              [&v](CmdLineArgGenerator& args,
-				   const std::string& argName) -> void {
-	        v.insert(ArgFormatter<Value>::format(args.next(argName)));
-	      });
+			       std::unordered_set<Value, Hash, Equal>& v) {
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    NoConstraint_());
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
 			       const std::string& separator,
 			       bool allowEmpty,
-			       std::unordered_set<Value>& v) {
-	  ArgHandler *h=
-	    createDelegate_(argName, description, required, true,
-                            [&v, separator, allowEmpty, this](
-			        CmdLineArgGenerator& args,
-				const std::string& argName
-			    ) -> void {
-	      splitAndApply(args.next(argName), separator, allowEmpty,
-			    [&v](const std::string& value) {
-		v.insert(ArgFormatter<Value>::format(value));
-	      });
-	    });
+			       std::unordered_set<Value, Hash, Equal>& v) {
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    NoConstraint_(), separator, allowEmpty);
+	  registerHandler_(h);
+	}
+
+	/** Register a named argument whose value is "@" followed by the
+	 *  path of a binary file of elements, which v maps read-only in
+	 *  place of converting text (see MappedArray).  If the argument is
+	 *  given more than once, v maps the last file.
+	 */
+	template <typename Value>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
+			       bool required,
+			       MappedArray<Value>& v) {
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    NoConstraint_());
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerNamedArgInRange_(const std::string& argName,
-				      const std::string& description,
+	void registerNamedArgInRange_(const ArgText& argName,
+				      const ArgText& description,
 				      bool required, Value minValue,
 				      Value maxValue, Value& v) {
 	  ArgHandler* h=
-	    createDelegate_(argName, description, required, true,
-			    [&v, minValue, maxValue](
-			         CmdLineArgGenerator& args,
-				 const std::string& argName
-			    ) -> void {
-	      v= ArgFormatter<Value>::format(args.next(argName), minValue,
-					     maxValue);
-	    });
+	      createKernel_(argName, description, required, true, v,
+			    Range_<Value>(minValue, maxValue));
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerNamedArgInRange_(const std::string& argName,
-				      const std::string& description,
+	void registerNamedArgInRange_(const ArgText& argName,
+				      const ArgText& description,
+				      bool required, Value minValue,
+				      Value maxValue, std::atomic<Value>& v) {
+	  registerAtomicArg_(argName, description, required, v,
+			     [minValue, maxValue](const std::string& value) {
+	    return ArgFormatter<Value>::format(value, minValue, maxValue);
+	  });
+	}
+
+	template <typename Value>
+	void registerNamedArgInRange_(const ArgText& argName,
+				      const ArgText& description,
 				      bool required,
 				      Value minValue, Value maxValue,
 				      std::vector<Value>& v) {
 	  ArgHandler* h=
-	    createDelegate_(argName, description, required, true,
-			    [&v, minValue, maxValue](
-			        CmdLineArgGenerator& args,
-				const std::string& argName
-			    ) -> void {
-	      v.push_back(ArgFormatter<Value>::format(args.next(argName),
-						      minValue, maxValue));
-	    });
+	      createKernel_(argName, description, required, true, v,
+			    Range_<Value>(minValue, maxValue));
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerNamedArgInRange_(const std::string& argName,
-				      const std::string& description,
+	void registerNamedArgInRange_(const ArgText& argName,
+				      const ArgText& description,
 				      bool required,
 				      const std::string& separator,
 				      bool allowEmpty,
 				      Value minValue, Value maxValue,
 				      std::vector<Value>& v) {
-	  ArgHandler *h=
-	    createDelegate_(
-	        argName, description, required, true,
-		[&v, separator, allowEmpty, minValue, maxValue, this](
-		    CmdLineArgGenerator& args,
-		    const std::string& argName
-	        ) -> void {
-	          splitAndApply(args.next(argName), separator, allowEmpty,
-				[&v, minValue, maxValue](
-				    const std::string& value
-				) -> void {
-	            v.push_back(ArgFormatter<Value>::format(value, minValue,
-							    maxValue));
-	          });
-		}
-	    );
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    Range_<Value>(minValue, maxValue), separator,
+			    allowEmpty);
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerNamedArgInRange_(const std::string& argName,
-				      const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerNamedArgInRange_(const ArgText& argName,
+				      const ArgText& description,
 				      bool required, Value minValue,
 				      Value maxValue,
-				      std::unordered_set<Value>& v) {
+				      std::unordered_set<Value, Hash,
+							 Equal>& v) {
 	  ArgHandler* h=
-	    createDelegate_(argName, description, required, true,
-			    [&v, minValue, maxValue](
-			        CmdLineArgGenerator& args,
-				const std::string& argName
-			    ) -> void {
-	      v.insert(ArgFormatter<Value>::format(args.next(argName),
-						   minValue, maxValue));
-	    });
+	      createKernel_(argName, description, required, true, v,
+			    Range_<Value>(minValue, maxValue));
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerNamedArgInRange_(const std::string& argName,
-				      const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerNamedArgInRange_(const ArgText& argName,
+				      const ArgText& description,
 				      bool required,
 				      const std::string& separator,
 				      bool allowEmpty,
 				      Value minValue, Value maxValue,
-				      std::unordered_set<Value>& v) {
-	  ArgHandler *h =
-	    createDelegate_(
-		argName, description, required, true,
-		[&v,separator, allowEmpty, minValue, maxValue, this](
-		    CmdLineArgGenerator& args,
-		    const std::string& argName
-	        ) -> void {
-	          splitAndApply(args.next(argName), separator, allowEmpty,
-				[&v, minValue, maxValue](
-				    const std::string& value
-				) -> void {
-	            v.insert(ArgFormatter<Value>::format(value, minValue,
-							 maxValue));
-	          }
-	        );
-	    });
+				      std::unordered_set<Value, Hash,
+							 Equal>& v) {
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    Range_<Value>(minValue, maxValue), separator,
+			    allowEmpty);
 	  registerHandler_(h);
 	}
 
+	/** As registerNamedArg_() for a MappedArray, but every element of
+	 *  the file is checked when it is mapped.
+	 */
 	template <typename Value>
-	void registerNamedArgInSet_(const std::string& argName,
-				    const std::string& description,
+	void registerNamedArgInRange_(
+	    const ArgText& argName, const ArgText& description,
+	    bool required,
+	    typename MappedArray<Value>::value_type minValue,
+	    typename MappedArray<Value>::value_type maxValue,
+	    MappedArray<Value>& v
+	) {
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    Range_<Value>(minValue, maxValue));
+	  registerHandler_(h);
+	}
+
+	template <typename Value>
+	void registerNamedArgInSet_(const ArgText& argName,
+				    const ArgText& description,
 				    bool required,
 				    const std::unordered_set<Value>&
 				        legalValues,
 				    Value& v) {
 	  ArgHandler* h=
-	    createDelegate_(argName, description, required, true,
-			    [&v, legalValues](
-			        CmdLineArgGenerator& args,
-				const std::string& argName
-			    ) -> void {
-	      v= ArgFormatter<Value>::format(args.next(argName), legalValues);
-	    });
+	      createKernel_(argName, description, required, true, v,
+			    legalValues);
+	  addCompletions_(h, legalValues);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerNamedArgInSet_(const std::string& argName,
-				    const std::string& description,
+	void registerNamedArgInSet_(const ArgText& argName,
+				    const ArgText& description,
 				    bool required,
 				    const std::unordered_set<Value>&
 				        legalValues,
 				    std::vector<Value>& v) {
 	  ArgHandler* h=
-	    createDelegate_(argName, description, required, true,
-			    [&v, legalValues](
-			        CmdLineArgGenerator& args,
-				const std::string& argName
-			    ) -> void {
-	      v.push_back(ArgFormatter<Value>::format(args.next(argName),
-						      legalValues));
-	    });
+	      createKernel_(argName, description, required, true, v,
+			    legalValues);
+	  addCompletions_(h, legalValues);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerNamedArgInSet_(const std::string& argName,
-				    const std::string& description,
+	void registerNamedArgInSet_(const ArgText& argName,
+				    const ArgText& description,
 				    bool required,
 				    const std::string& separator,
 				    bool allowEmpty,
 				    const std::unordered_set<Value>&
 				        legalValues,
 				    std::vector<Value>& v) {
-	  ArgHandler *h=
-	    createDelegate_(argName, description, required, true,
-                            [&v, separator, allowEmpty, legalValues, this](
-			        CmdLineArgGenerator& args,
-				const std::string& argName
-			    ) -> void {
-	      splitAndApply(args.next(argName), separator, allowEmpty,
-			    [&v, legalValues](const std::string& value) {
-	        v.push_back(ArgFormatter<Value>::format(value, legalValues));
-	      });
-	    });
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    legalValues, separator, allowEmpty);
+	  addCompletions_(h, legalValues);
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerNamedArgInSet_(const std::string& argName,
-				    const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerNamedArgInSet_(const ArgText& argName,
+				    const ArgText& description,
 				    bool required,
 				    const std::unordered_set<Value>&
 				        legalValues,
-				    std::unordered_set<Value>& v) {
+				    std::unordered_set<Value, Hash,
+						       Equal>& v) {
 	  ArgHandler* h=
-	    createDelegate_(argName, description, required, true,
-			    [&v, legalValues](CmdLineArgGenerator& args,
-					      const std::string& argName) {
-	      v.insert(ArgFormatter<Value>::format(args.next(argName),
-						   legalValues));
-	    });
+	      createKernel_(argName, description, required, true, v,
+			    legalValues);
+	  addCompletions_(h, legalValues);
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerNamedArgInSet_(const std::string& argName,
-				    const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerNamedArgInSet_(const ArgText& argName,
+				    const ArgText& description,
 				    bool required,
 				    const std::string& separator,
 				    bool allowEmpty,
 				    const std::unordered_set<Value>&
 				        legalValues,
-				    std::unordered_set<Value>& v) {
-	  ArgHandler *h=
-	    createDelegate_(argName, description, required, true,
-                            [&v, separator, allowEmpty, legalValues, this](
-			        CmdLineArgGenerator& args,
-				const std::string& argName
-			    ) -> void {
-	      splitAndApply(args.next(argName), separator, allowEmpty,
-			    [&v, legalValues](const std::string& value) {
-	        v.insert(ArgFormatter<Value>::format(value, legalValues));
-	      });
-	    });
+				    std::unordered_set<Value, Hash,
+						       Equal>& v) {
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    legalValues, separator, allowEmpty);
+	  addCompletions_(h, legalValues);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
 			       const ValueMap<Value>& valueMap,
 			       Value& v) {
-	  ArgHandler *h=
-	    createDelegate_(argName, description, required, true,
-			    [&v, valueMap](CmdLineArgGenerator& args,
-					   const std::string& argName) {
-	      v= valueMap[args.next(argName)];
-	    });
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    valueMap);
+	  addCompletions_(h, valueMap);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
 			       const ValueMap<Value>& valueMap,
 			       std::vector<Value>& v) {
-	  ArgHandler *h=
-	    createDelegate_(argName, description, required, true,
-			    [&v, valueMap](CmdLineArgGenerator& args,
-					   const std::string& argName) {
-	      v.push_back(valueMap[args.next(argName)]);
-	    });
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    valueMap);
+	  addCompletions_(h, valueMap);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
 			       const std::string& separator,
 			       bool allowEmpty,
 			       const ValueMap<Value>& valueMap,
 			       std::vector<Value>& v) {
-	  ArgHandler *h=
-	    createDelegate_(argName, description, required, true,
-			    [&v, valueMap, separator, allowEmpty, this](
-			        CmdLineArgGenerator& args,
-				const std::string& argName
-			    ) {
-	      splitAndApply(args.next(argName), separator, allowEmpty,
-			    [&v, valueMap](const std::string& value) {
-	        v.push_back(valueMap[value]);
-	      });
-	    });
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    valueMap, separator, allowEmpty);
+	  addCompletions_(h, valueMap);
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
 			       const ValueMap<Value>& valueMap,
-			       std::unordered_set<Value>& v) {
-	  ArgHandler *h=
-	    createDelegate_(argName, description, required, true,
-			    [&v, valueMap](CmdLineArgGenerator& args,
-					   const std::string& argName) {
-	      v.insert(valueMap[args.next(argName)]);
-	    });
-          registerHandler_(h);
+			       std::unordered_set<Value, Hash, Equal>& v) {
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    valueMap);
+          addCompletions_(h, valueMap);
+	  registerHandler_(h);
 	}
 
+	template <typename Value, typename Hash, typename Equal>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
+			       bool required,
+			       const std::string& separator,
+			       bool allowEmpty,
+			       const ValueMap<Value>& valueMap,
+			       std::unordered_set<Value, Hash, Equal>& v) {
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    valueMap, separator, allowEmpty);
+	  addCompletions_(h, valueMap);
+	  registerHandler_(h);
+	}
+
+	/** Register a named argument whose values name members of a set
+	 *  of enum values, which is stored as a bitmask in v.  The value
+	 *  that valueMap gives a name is the index of its bit, so an enum
+	 *  with members 0 through 63 fits.  Names are ORed into v, which
+	 *  initValues_() should clear.
+	 */
+	template <typename Value>
+	typename std::enable_if<std::is_enum<Value>::value>::type
+	    registerNamedArg_(const ArgText& argName,
+			      const ArgText& description,
+			      bool required,
+			      const ValueMap<Value>& valueMap,
+			      uint64_t& v) {
+	  registerNamedArg_(argName, description, required, std::string(),
+			    false, valueMap, v);
+	}
+
+	/** As above, but each value may name several members separated by
+	 *  separator, as in "--features a,b,c".
+	 */
 	template <typename Value>
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	typename std::enable_if<std::is_enum<Value>::value>::type
+	    registerNamedArg_(const ArgText& argName,
+			      const ArgText& description,
+			      bool required,
+			      const std::string& separator,
+			      bool allowEmpty,
+			      const ValueMap<Value>& valueMap,
+			      uint64_t& v) {
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    EnumBits_<Value>(valueMap, 64, separator,
+					     allowEmpty));
+	  addCompletions_(h, valueMap);
+	  registerHandler_(h);
+	}
+
+	/** Bitmasks wider than 64 bits are stored in a std::bitset */
+	template <typename Value, size_t N>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
+			       bool required,
+			       const ValueMap<Value>& valueMap,
+			       std::bitset<N>& v) {
+	  registerNamedArg_(argName, description, required, std::string(),
+			    false, valueMap, v);
+	}
+
+	template <typename Value, size_t N>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
 			       const std::string& separator,
 			       bool allowEmpty,
 			       const ValueMap<Value>& valueMap,
-			       std::unordered_set<Value>& v) {
-	  ArgHandler *h=
-	    createDelegate_(argName, description, required, true,
-			    [&v, valueMap, separator, allowEmpty, this](
-			        CmdLineArgGenerator& args,
-				const std::string& argName
-			    ) {
-	      splitAndApply(args.next(argName), separator, allowEmpty,
-		 	    [&v,valueMap](const std::string& value) {
-	        v.insert(valueMap[value]);
-	      });
-	    });
+			       std::bitset<N>& v) {
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    EnumBits_<Value>(valueMap, N, separator,
+					     allowEmpty));
+	  addCompletions_(h, valueMap);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
 			       const std::function<Value (const std::string&)>&
 			           format,
 			       Value& v) {
 	  ArgHandler* h=
-	    createDelegate_(argName, description, required, true,
-			    [format, this, &v](CmdLineArgGenerator& args,
-					       const std::string& argName) {
-	      v= SimpleCmdLineArgs::formatUsingFn(args.next(argName), format);
-	    });
+	      createKernel_(argName, description, required, true, v,
+			    format);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
 			       const std::function<
 			           Value (const std::string&)
 			       >& format,
 			       std::vector<Value>& v) {
 	  ArgHandler* h=
-	    createDelegate_(argName, description, required, true,
-			    [format, this, &v](CmdLineArgGenerator& args,
-					       const std::string& argName) {
-	      v.push_back(formatUsingFn(args.next(argName), format));
-	    });
-          registerHandler_(h);
+	      createKernel_(argName, description, required, true, v,
+			    format);
+	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
 			       const std::string& separator,
 			       bool allowEmpty,
@@ -617,62 +1114,103 @@ namespace pistis {
 			       >& format,
 			       std::vector<Value>& v) {
 	  ArgHandler* h=
-	    createDelegate_(argName, description, required, true,
-			    [format, separator, allowEmpty, this, &v](
-			        CmdLineArgGenerator& args,
-				const std::string& argName
-			    ) {
-	      splitAndApply(args.next(argName), separator, allowEmpty,
-			    [format, this, &v](const std::string& value) {
-	        v.push_back(formatUsingFn(value, format));
-	      });
-	    });
-          registerHandler_(h);
+	      createKernel_(argName, description, required, true, v,
+			    format, separator, allowEmpty);
+	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
 			       const std::function<
 			           Value (const std::string&)
 			       >& format,
-			       std::unordered_set<Value>& v) {
+			       std::unordered_set<Value, Hash, Equal>& v) {
 	  ArgHandler* h=
-	    createDelegate_(argName, description, required, true,
-			    [format, this, &v](CmdLineArgGenerator& args,
-					       const std::string& argName) {
-	      v.insert(formatUsingFn(args.next(argName), format));
-	    });
-          registerHandler_(h);
+	      createKernel_(argName, description, required, true, v,
+			    format);
+	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
 			       const std::string& separator,
 			       bool allowEmpty,
 			       const std::function<
 			           Value (const std::string&)
 			       >& format,
-			       std::unordered_set<Value>& v) {
+			       std::unordered_set<Value, Hash, Equal>& v) {
 	  ArgHandler* h=
-	    createDelegate_(argName, description, required, true,
-			    [format, separator, allowEmpty, this, &v](
-			        CmdLineArgGenerator& args,
-				const std::string& argName
-			    ) {
-	      splitAndApply(args.next(argName), separator, allowEmpty,
-			    [format, this, &v](const std::string& value) {
-	        v.insert(formatUsingFn(value, format));
-	      });
-	    });
-          registerHandler_(h);
+	      createKernel_(argName, description, required, true, v,
+			    format, separator, allowEmpty);
+	  registerHandler_(h);
+	}
+
+	/** Register a named argument whose values are key=value pairs,
+	 *  such as "--define NAME=VALUE", that are added to v.  Keys and
+	 *  values are converted like any other value.  onDuplicate decides
+	 *  what happens when a key is given more than once.
+	 */
+	template <typename Key, typename Value, typename Hash, typename Equal,
+		  typename Allocator>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
+			       bool required,
+			       DuplicateKeyPolicy onDuplicate,
+			       std::unordered_map<Key, Value, Hash, Equal,
+			                          Allocator>& v) {
+	  registerNamedArg_(argName, description, required, std::string(),
+			    onDuplicate, v);
+	}
+
+	/** As above, but each value may hold several pairs separated by
+	 *  separator, as in "--define A=1,B=2".
+	 */
+	template <typename Key, typename Value, typename Hash, typename Equal,
+		  typename Allocator>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
+			       bool required,
+			       const std::string& separator,
+			       DuplicateKeyPolicy onDuplicate,
+			       std::unordered_map<Key, Value, Hash, Equal,
+			                          Allocator>& v) {
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    KeyValueFormat_(separator, onDuplicate));
+	  registerHandler_(h);
+	}
+
+	template <typename Key, typename Value, typename Compare,
+		  typename Allocator>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
+			       bool required,
+			       DuplicateKeyPolicy onDuplicate,
+			       std::map<Key, Value, Compare, Allocator>& v) {
+	  registerNamedArg_(argName, description, required, std::string(),
+			    onDuplicate, v);
 	}
 
-	void registerNamedArg_(const std::string& argName,
-			       const std::string& description,
+	template <typename Key, typename Value, typename Compare,
+		  typename Allocator>
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
+			       bool required,
+			       const std::string& separator,
+			       DuplicateKeyPolicy onDuplicate,
+			       std::map<Key, Value, Compare, Allocator>& v) {
+	  ArgHandler* h=
+	      createKernel_(argName, description, required, true, v,
+			    KeyValueFormat_(separator, onDuplicate));
+	  registerHandler_(h);
+	}
+
+	void registerNamedArg_(const ArgText& argName,
+			       const ArgText& description,
 			       bool required,
 			       const std::function<
 			           void (CmdLineArgGenerator&,
@@ -680,383 +1218,277 @@ namespace pistis {
 			       >& handler);
 
 	template <typename Value>
-	void registerUnnamedArg_(const std::string& description,
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
 				 Value& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, false,
-			    [&v](CmdLineArgGenerator& args,
-				 const std::string& argValue) -> void {
-	      v = ArgFormatter<Value>::format(argValue);
-	    });
+	      createKernel_(std::string(), description, required, false, v,
+			    NoConstraint_());
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerUnnamedArg_(const std::string& description,
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
 				 std::vector<Value>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, true,
-			    [&v](CmdLineArgGenerator& args,
-				 const std::string& argValue) -> void {
-	      v.push_back(ArgFormatter<Value>::format(argValue));
-	    });
+	      createKernel_(std::string(), description, required, true, v,
+			    NoConstraint_());
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerUnnamedArg_(const std::string& description,
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
 				 const std::string& separator,
 				 std::vector<Value>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, false,
-			    [&v,separator,this](
-			        CmdLineArgGenerator& args,
-				const std::string& argValue
-			    ) -> void {
-	      splitAndApply(argValue, separator, false,
-			    [&v](const std::string& value) -> void {
-	        v.push_back(ArgFormatter<Value>::format(value));
-	      });
-	    });
+	      createKernel_(std::string(), description, required, false, v,
+			    NoConstraint_(), separator, false);
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerUnnamedArg_(const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
-				 std::unordered_set<Value>& v) {
+				 std::unordered_set<Value, Hash, Equal>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, true,
-			    [&v](CmdLineArgGenerator& args,
-				 const std::string& argValue) -> void {
-	      v.insert(ArgFormatter<Value>::format(argValue));
-	    });
+	      createKernel_(std::string(), description, required, true, v,
+			    NoConstraint_());
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerUnnamedArg_(const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
 				 const std::string& separator,
-				 std::unordered_set<Value>& v) {
+				 std::unordered_set<Value, Hash, Equal>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, false,
-			    [&v, separator, this](
-			        CmdLineArgGenerator& args,
-				const std::string& argValue
-			    ) -> void {
-	      splitAndApply(argValue, separator, false,
-			    [&v](const std::string& value) -> void {
-	        v.insert(ArgFormatter<Value>::format(value));
-	      });
-	    });
+	      createKernel_(std::string(), description, required, false, v,
+			    NoConstraint_(), separator, false);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerUnnamedArgInRange_(const std::string& description,
+	void registerUnnamedArgInRange_(const ArgText& description,
 					bool required,
 					Value minValue, Value maxValue,
 					Value& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, false,
-			    [&v, minValue, maxValue](
-			        CmdLineArgGenerator& args,
-				const std::string& argValue
-			    ) -> void {
-	      v= ArgFormatter<Value>::format(argValue, minValue, maxValue);
-	    });
+	      createKernel_(std::string(), description, required, false, v,
+			    Range_<Value>(minValue, maxValue));
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerUnnamedArgInRange_(const std::string& description,
+	void registerUnnamedArgInRange_(const ArgText& description,
 					bool required,
 					Value minValue, Value maxValue,
 					std::vector<Value>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, true,
-			    [&v, minValue, maxValue](
-			        CmdLineArgGenerator& args,
-				const std::string& argValue
-			    ) -> void {
-	      v.push_back(ArgFormatter<Value>::format(argValue, minValue,
-						      maxValue));
-	    });
+	      createKernel_(std::string(), description, required, true, v,
+			    Range_<Value>(minValue, maxValue));
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerUnnamedArgInRange_(const std::string& description,
+	void registerUnnamedArgInRange_(const ArgText& description,
 					bool required,
 					const std::string& separator,
 					Value minValue, Value maxValue,
 					std::vector<Value>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, false,
-			    [&v, separator, minValue, maxValue, this](
-			        CmdLineArgGenerator& args,
-				const std::string& argValue
-			    ) -> void {
-	      splitAndApply(argValue, separator, false,
-			    [&v, minValue, maxValue](
-			        const std::string& value
-			    ) -> void {
-	        v.push_back(ArgFormatter<Value>::format(value, minValue,
-							maxValue));
-	      });
-	    });
+	      createKernel_(std::string(), description, required, false, v,
+			    Range_<Value>(minValue, maxValue), separator,
+			    false);
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerUnnamedArgInRange_(const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerUnnamedArgInRange_(const ArgText& description,
 					bool required,
 					Value minValue, Value maxValue,
-					std::unordered_set<Value>& v) {
+					std::unordered_set<Value, Hash,
+							   Equal>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, true,
-			    [&v, minValue, maxValue](
-			        CmdLineArgGenerator& args,
-				const std::string& argValue
-			    ) -> void {
-	      v.insert(ArgFormatter<Value>::format(argValue, minValue,
-						   maxValue));
-	    });
+	      createKernel_(std::string(), description, required, true, v,
+			    Range_<Value>(minValue, maxValue));
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerUnnamedArgInRange_(const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerUnnamedArgInRange_(const ArgText& description,
 					bool required,
 					const std::string& separator,
 					Value minValue, Value maxValue,
-					std::unordered_set<Value>& v) {
+					std::unordered_set<Value, Hash,
+							   Equal>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, false,
-			    [&v, separator, minValue, maxValue, this](
-			        CmdLineArgGenerator& args,
-				const std::string& argValue
-			    ) -> void {
-	      splitAndApply(argValue, separator, false,
-			    [&v, minValue, maxValue](
-			        const std::string& value
-			    ) -> void {
-	        v.insert(ArgFormatter<Value>::format(value, minValue,
-						     maxValue));
-	      });
-	    });
+	      createKernel_(std::string(), description, required, false, v,
+			    Range_<Value>(minValue, maxValue), separator,
+			    false);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerUnnamedArgInSet_(const std::string& description,
+	void registerUnnamedArgInSet_(const ArgText& description,
 				      bool required,
 				      const std::unordered_set<Value>&
 				          legalValues,
 				      Value& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, false,
-			    [&v, legalValues](CmdLineArgGenerator& args,
-					      const std::string& argValue) {
-	      v = ArgFormatter<Value>::format(argValue, legalValues);
-	    });
+	      createKernel_(std::string(), description, required, false, v,
+			    legalValues);
+	  addCompletions_(h, legalValues);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerUnnamedArgInSet_(const std::string& description,
+	void registerUnnamedArgInSet_(const ArgText& description,
 				      bool required,
 				      const std::unordered_set<Value>&
 				          legalValues,
 				      std::vector<Value>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, true,
-			    [&v, legalValues](CmdLineArgGenerator& args,
-					      const std::string& argValue) {
-	      v.push_back(ArgFormatter<Value>::format(argValue, legalValues));
-	    });
+	      createKernel_(std::string(), description, required, true, v,
+			    legalValues);
+	  addCompletions_(h, legalValues);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerUnnamedArgInSet_(const std::string& description,
+	void registerUnnamedArgInSet_(const ArgText& description,
 				      bool required,
 				      const std::string& separator,
 				      const std::unordered_set<Value>&
 				          legalValues,
 				      std::vector<Value>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, false,
-			    [&v, separator, legalValues, this](
-			        CmdLineArgGenerator& args,
-				const std::string& argValue
-			    ) -> void {
-	      splitAndApply(argValue, separator, false,
-			    [&v, legalValues](const std::string& value) {
-	        v.push_back(ArgFormatter<Value>::format(value, legalValues));
-	      });
-	    });
+	      createKernel_(std::string(), description, required, false, v,
+			    legalValues, separator, false);
+	  addCompletions_(h, legalValues);
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerUnnamedArgInSet_(const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerUnnamedArgInSet_(const ArgText& description,
 				      bool required,
 				      const std::unordered_set<Value>&
 				          legalValues,
-				      std::unordered_set<Value>& v) {
+				      std::unordered_set<Value, Hash,
+							 Equal>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, true,
-			    [&v, legalValues](CmdLineArgGenerator& args,
-					      const std::string& argValue) {
-	      v.insert(ArgFormatter<Value>::format(argValue, legalValues));
-	    });
+	      createKernel_(std::string(), description, required, true, v,
+			    legalValues);
+	  addCompletions_(h, legalValues);
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerUnnamedArgInRange_(const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerUnnamedArgInRange_(const ArgText& description,
 					bool required,
 					const std::string& separator,
 					const std::unordered_set<Value>&
 					    legalValues,
-					std::unordered_set<Value>& v) {
+					std::unordered_set<Value, Hash,
+							   Equal>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, false,
-			    [&v, separator, legalValues, this](
-			        CmdLineArgGenerator& args,
-				const std::string& argValue
-			    ) -> void {
-	      splitAndApply(argValue, separator, false,
-			    [&v, legalValues](const std::string& value) {
-	        v.insert(ArgFormatter<Value>::format(value, legalValues));
-	      });
-	    });
+	      createKernel_(std::string(), description, required, false, v,
+			    legalValues, separator, false);
+	  addCompletions_(h, legalValues);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerUnnamedArg_(const std::string& description,
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
 				 const ValueMap<Value>& valueMap,
 				 Value& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, false,
-			    [&v, valueMap](CmdLineArgGenerator& args,
-					   const std::string& argValue) {
-	      v = valueMap[argValue];
-	    });
+	      createKernel_(std::string(), description, required, false, v,
+			    valueMap);
+	  addCompletions_(h, valueMap);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerUnnamedArg_(const std::string& description,
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
 				 const ValueMap<Value>& valueMap,
 				 std::vector<Value>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, true,
-			    [&v, valueMap](CmdLineArgGenerator& args,
-					   const std::string& argValue) {
-	      v.push_back(valueMap[argValue]);
-	    });
+	      createKernel_(std::string(), description, required, true, v,
+			    valueMap);
+	  addCompletions_(h, valueMap);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerUnnamedArg_(const std::string& description,
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
 				 const std::string& separator,
 				 const ValueMap<Value>& valueMap,
 				 std::vector<Value>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, false,
-			    [&v, valueMap, separator, this](
-			        CmdLineArgGenerator& args,
-				const std::string& argValue
-			    ) -> void {
-	      splitAndApply(argValue, separator, false,
-			    [&v,valueMap](const std::string& value) {
-	        v.push_back(valueMap[value]);
-	      });
-	    });
+	      createKernel_(std::string(), description, required, false, v,
+			    valueMap, separator, false);
+	  addCompletions_(h, valueMap);
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerUnnamedArg_(const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
 				 const ValueMap<Value>& valueMap,
-				 std::unordered_set<Value>& v) {
+				 std::unordered_set<Value, Hash, Equal>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, true,
-			    [&v, valueMap](CmdLineArgGenerator& args,
-					   const std::string& argValue) {
-	      v.insert(valueMap[argValue]);
-	    });
+	      createKernel_(std::string(), description, required, true, v,
+			    valueMap);
+	  addCompletions_(h, valueMap);
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerUnnamedArg_(const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
 				 const std::string& separator,
 				 const ValueMap<Value>& valueMap,
-				 std::unordered_set<Value>& v) {
+				 std::unordered_set<Value, Hash, Equal>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, false,
-			    [&v, valueMap, separator, this](
-			        CmdLineArgGenerator& args,
-				const std::string& argValue
-			    ) {
-	      splitAndApply(argValue, separator, false,
-			    [&v,valueMap](const std::string& value) {
-	        v.insert(valueMap[value]);
-	      });
-	    });
+	      createKernel_(std::string(), description, required, false, v,
+			    valueMap, separator, false);
+	  addCompletions_(h, valueMap);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerUnnamedArg_(const std::string& description,
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
 				 const std::function<
 				     Value (const std::string&)
 				 >& format,
 				 Value& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, false,
-			    [&v, this, format](
-			        CmdLineArgGenerator& args,
-				const std::string& argValue
-			    ) {
-	      v = formatUsingFn(argValue, format);
-	    });
+	      createKernel_(std::string(), description, required, false, v,
+			    format);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerUnnamedArg_(const std::string& description,
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
 				 const std::function<
 				     Value (const std::string&)
 				 >& format,
 				 std::vector<Value>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, true,
-			    [&v, this, format](CmdLineArgGenerator& args,
-					       const std::string& argValue) {
-	      v.push_back(formatUsingFn(argValue, format));
-	    });
+	      createKernel_(std::string(), description, required, true, v,
+			    format);
 	  registerHandler_(h);
 	}
 
 	template <typename Value>
-	void registerUnnamedArg_(const std::string& description,
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
 				 const std::string& separator,
 				 const std::function<
@@ -1064,58 +1496,39 @@ namespace pistis {
 				 >& format,
 				 std::vector<Value>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, false,
-			    [&v, format, this, separator](
-			        CmdLineArgGenerator& args,
-				const std::string& argValue
-			    ) {
-	      splitAndApply(argValue, separator, false,
-			    [&v, this, format](const std::string& value) {
-	        v.push_back(formatUsingFn(value, format));
-	      });
-	    });
+	      createKernel_(std::string(), description, required, false, v,
+			    format, separator, false);
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerUnnamedArg_(const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
 				 const std::function<
 				     Value (const std::string&)
 				 >& format,
-				 std::unordered_set<Value>& v) {
+				 std::unordered_set<Value, Hash, Equal>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, true,
-			    [&v, format, this](CmdLineArgGenerator& args,
-					       const std::string& argValue) {
-	      v.insert(formatUsingFn(argValue, format));
-	    });
+	      createKernel_(std::string(), description, required, true, v,
+			    format);
 	  registerHandler_(h);
 	}
 
-	template <typename Value>
-	void registerUnnamedArg_(const std::string& description,
+	template <typename Value, typename Hash, typename Equal>
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
 				 const std::string& separator,
 				 const std::function<
 				     Value (const std::string&)
 				 >& format,
-				 std::unordered_set<Value>& v) {
+				 std::unordered_set<Value, Hash, Equal>& v) {
 	  ArgHandler* h=
-	    createDelegate_(std::string(), description, required, false,
-			    [&v, format, separator, this](
-			        CmdLineArgGenerator& args,
-				const std::string& argValue
-			    ) {
-	      splitAndApply(argValue, separator, false,
-			    [&v,format,this](const std::string& value) {
-	        v.insert(formatUsingFn(value, format));
-	      });
-	    });
+	      createKernel_(std::string(), description, required, false, v,
+			    format, separator, false);
 	  registerHandler_(h);
 	}
 
-	void registerUnnamedArg_(const std::string& description,
+	void registerUnnamedArg_(const ArgText& description,
 				 bool required,
 				 const std::function<
 				     void (CmdLineArgGenerator&,
@@ -1124,15 +1537,193 @@ namespace pistis {
 				 
 	template <typename Delegate>
         DelegatingArgHandler<Delegate>*
-	    createDelegate_(const std::string& argName,
-			    const std::string& description,
+	    createDelegate_(const ArgText& argName,
+			    const ArgText& description,
 			    bool required, bool final,
 			    const Delegate& delegate) {
 	  return new DelegatingArgHandler<Delegate>(argName, description,
 						    required, final, delegate);
 	}
 
+	template <typename Destination, typename Constraint>
+	ArgHandler* createKernel_(const ArgText& argName,
+				  const ArgText& description,
+				  bool required, bool final, Destination& d,
+				  const Constraint& constraint) {
+	  return new KernelArgHandler(argName, description, required, final,
+				      *this, &d,
+				      &storeItem_<Destination, Constraint>,
+				      reserveFor_(d),
+				      holdConstraint_(constraint));
+	}
+
+	template <typename Destination, typename Constraint>
+	ArgHandler* createKernel_(const ArgText& argName,
+				  const ArgText& description,
+				  bool required, bool final, Destination& d,
+				  const Constraint& constraint,
+				  const std::string& separator,
+				  bool allowEmpty) {
+	  KernelArgHandler* h=
+	      new KernelArgHandler(argName, description, required, final,
+				   *this, &d,
+				   &storeItem_<Destination, Constraint>,
+				   reserveFor_(d), holdConstraint_(constraint),
+				   separator, allowEmpty);
+	  h->setParallelStore(
+	      parallelStoreFor_(d, (const Constraint*)nullptr)
+	  );
+	  return h;
+	}
+
 	void registerHandler_(ArgHandler* handler);
+	void registerLazy_(LazyBase& lazy, LazyArgHandler* handler);
+
+	template <typename Value>
+	static void addCompletions_(ArgHandler* h,
+				    const std::unordered_set<Value>& values) {
+	  for (auto i= values.begin(); i != values.end(); ++i) {
+	    std::ostringstream tmp;
+	    tmp << *i;
+	    h->addCompletion(tmp.str());
+	  }
+	}
+
+	template <typename Value>
+	static void addCompletions_(ArgHandler* h,
+				    const ValueMap<Value>& values) {
+	  std::vector<std::string> keys(values.allKeys());
+	  for (auto i= keys.begin(); i != keys.end(); ++i) {
+	    h->addCompletion(*i);
+	  }
+	}
+
+	/** Add values offered by shell completion for the named argument
+	 *  argName, for handlers that take values from a fixed set but were
+	 *  not registered with a ValueMap or a set of legal values, such as
+	 *  handlers that call CmdLineArgGenerator::nextInSet().
+	 */
+	void addCompletions_(const std::string& argName,
+			     const std::vector<std::string>& values);
+
+	template <typename Value, typename Formatter>
+	void registerAtomicArg_(const ArgText& argName,
+				const ArgText& description,
+				bool required, std::atomic<Value>& v,
+				const Formatter& format) {
+	  ArgHandler* h=
+	      createDelegate_(argName, description, required, true,
+			      [&v, format](CmdLineArgGenerator& args,
+					   const std::string& argName) {
+	        v.store(format(args.next(argName)),
+			std::memory_order_relaxed);
+	      });
+	  registerHandler_(h);
+	  runtimeFlags_.add(
+	      argName.str(), description.str(),
+	      [&v]() {
+	        // Enough digits that the value reads back unchanged
+	        std::ostringstream tmp;
+		tmp.precision(std::numeric_limits<Value>::max_digits10);
+		tmp << v.load(std::memory_order_relaxed);
+		return tmp.str();
+	      },
+	      [&v, format, argName](const std::string& value) {
+		try {
+		  v.store(format(value), std::memory_order_relaxed);
+		} catch(const FormatError& e) {
+		  throw exceptions::IllegalValueError(argName.str(), value,
+						      e.details(),
+						      PISTIS_EX_HERE);
+		}
+	      }
+	  );
+	}
+
+	/** Let every named argument, including ones registered later, take
+	 *  its value from the environment variable formed by prefix and the
+	 *  argument's name without leading dashes, in upper case and with
+	 *  dashes replaced by underscores.  With prefix "APP_", "--threads"
+	 *  binds to APP_THREADS.  Values from the command line override
+	 *  values from the environment.  When several variables bound to
+	 *  the same argument are set, the one bound first gives the value,
+	 *  whatever order the environment lists them in.
+	 */
+	void bindEnvironment_(const std::string& prefix);
+
+	/** Let the named argument argName take its value from envVar.  A
+	 *  variable bound earlier to the same argument, including by
+	 *  bindEnvironment_(), takes precedence over envVar.
+	 */
+	void bindEnvVar_(const std::string& argName, const std::string& envVar);
+
+	/** Read "key = value" entries from the configuration file at path on
+	 *  every parse.  Each entry is handled as if "--key value" had been
+	 *  given on the command line; entries in a "[section]" are handled
+	 *  as "--section.key value", and keys that begin with '-' are used
+	 *  as they are.  Values from the command line and the environment
+	 *  override values from configuration files, and files added later
+	 *  override files added earlier.  If required is false, a missing
+	 *  file is ignored.
+	 */
+	void addConfigFile_(const std::string& path, bool required);
+
+	/** Like addConfigFile_(path, required), but replay the file from the
+	 *  binary image at imagePath when the image was compiled from the
+	 *  current contents of the file with the current set of named
+	 *  arguments.  Otherwise the text is read, and the image is
+	 *  rewritten for the next parse if possible.
+	 */
+	void addConfigFile_(const std::string& path, bool required,
+			    const std::string& imagePath);
+
+	/** Register a named argument whose value is the path to a
+	 *  configuration file to read for that parse only, in addition to
+	 *  the files given to addConfigFile_().
+	 */
+	void registerConfigFileArg_(const ArgText& argName,
+				    const ArgText& description);
+
+	/** Register a flag that sets value when given as argName.  If
+	 *  negatable is true and argName starts with "--", the flag is
+	 *  cleared by "--no-" followed by the rest of argName.  The value
+	 *  may also be given explicitly, as in "--foo=true" or
+	 *  "--foo=false", which is also how the environment and
+	 *  configuration files give it; there an empty value works like
+	 *  the flag given alone.  Flags named by one character after
+	 *  a single '-' can be combined, as in "-xvf".
+	 */
+	void registerFlag_(const ArgText& argName, const ArgText& description,
+			   bool negatable, bool& value);
+
+	/** As above, and also add the flag to runtimeFlags() so it can be
+	 *  changed while the program runs.
+	 */
+	void registerFlag_(const ArgText& argName, const ArgText& description,
+			   bool negatable, std::atomic<bool>& value);
+
+	/** Register a flag stored in one bit of bits, which can hold the
+	 *  values of many flags in very little memory.
+	 */
+	template <size_t N>
+	void registerFlag_(const ArgText& argName, const ArgText& description,
+			   bool negatable, std::bitset<N>& bits, size_t bit) {
+	  if (bit >= N) {
+	    throw exceptions::IllegalValueError(
+	        "bit", std::to_string(bit),
+		"Bit must be less than " + std::to_string(N), PISTIS_EX_HERE
+	    );
+	  }
+	  addFlag_(argName, description, negatable,
+		   FlagTable::bitFlag(bits, bit));
+	}
+
+	/** Register a flag that adds one to count each time it is given,
+	 *  so "-vvv" or "-v -v -v" add three.  A value, as in "-v=3" or a
+	 *  configuration file entry, adds that many instead.
+	 */
+	void registerCountingFlag_(const ArgText& argName,
+				   const ArgText& description, int& count);
 
 	virtual void init_(int argc, char** argv);
 	virtual bool handleNamedArg_(CmdLineArgGenerator& args,
@@ -1140,6 +1731,9 @@ namespace pistis {
 	virtual bool handleUnnamedArg_(CmdLineArgGenerator& args,
 				       const std::string& arg);
 	virtual void check_(const std::string& appName);
+	virtual std::vector<std::string> suggestionsFor_(
+	    const std::string& argName
+	) const;
 
 	virtual void initValues_();
 	virtual void checkValues_();
@@ -1148,92 +1742,565 @@ namespace pistis {
 	HandlerMapType namedArgs_;
 	HandlerListType unnamedArgs_;
 	HandlerListType::iterator currentUnnamedArg_;
-      };
+	bool envBound_;
+	std::string envPrefix_;
+	EnvMapType envArgs_;
+	size_t numEnvBindings_;
+	std::string envKeyPrefix_;
+
+	struct ConfigFile_ {
+	  std::string path;
+	  bool required;
+	  std::string imagePath;
+	};
 
-      template <>
-      class SimpleCmdLineArgs::ArgFormatter<int> {
-      public:
-	static int format(const std::string& value) {
-	  std::pair<int64_t, util::NumConversionResult> v =
-	    util::toInt64Quietly(value);
-	  if (v.second != util::NumConversionResult::OK) {
-	    throw FormatError(value, descriptionFor(v.second));
+	HandlerListType namedArgList_;
+	FlagTable flags_;
+
+	// How often each flag was given on the command line in the last
+	// parse, and whether any source gave it
+	std::vector<uint32_t> flagOccurrences_;
+	std::vector<bool> flagsFound_;
+
+	// Only needed to complete or suggest names, so filled from
+	// namedArgList_ on first use by indexNames_()
+	mutable CompletionTrie namedArgNames_;
+	mutable OptionSuggester suggester_;
+	mutable size_t numIndexedNames_;
+	mutable size_t numIndexedFlagNames_;
+	RuntimeFlagRegistry runtimeFlags_;
+	ParseObserver* parseObserver_;
+	bool preScan_;
+	std::string appName_;
+	ArgHandler* currentHandler_;
+	size_t containerBytes_;
+	std::vector<ConfigFile_> configFiles_;
+	std::vector<std::string> cmdLineConfigFiles_;
+
+	// Lazy destinations, and the argv they refer to after a parse
+	std::vector<LazyBase*> lazyValues_;
+	char** argvBegin_;
+	char** argvEnd_;
+
+	size_t parallelMinSize_;
+	std::unique_ptr<WorkStealingScheduler> scheduler_;
+	bool listFiles_;
+
+	void completeWord_(char** words, int numWords, int cword,
+			   std::string& out) const;
+	void addEnvVar_(const std::string& envVar, const NamedTarget_& target);
+	void applyEnvironment_(const std::string& appName);
+	void applyConfigFiles_(const std::string& appName);
+	void applyConfigFile_(const std::string& appName,
+			      const ConfigFile_& file,
+			      std::unordered_set<const void*>& setByFiles);
+	template <typename Function>
+	void readConfigFile_(const std::string& appName,
+			     const std::string& path, const Function& f) const;
+	template <typename Function>
+	void readListFile_(const std::string& value, const Function& f) const;
+	uint64_t schemaFingerprint_() const;
+	std::unordered_map<const ArgHandler*, size_t> handlerIndices_() const;
+	bool findTarget_(const ArgText& argName, NamedTarget_& target) const;
+	bool found_(const NamedTarget_& target) const;
+	const void* keyOf_(const NamedTarget_& target) const;
+	size_t indexOf_(const NamedTarget_& target,
+			const std::unordered_map<const ArgHandler*, size_t>&
+			    indices) const;
+	NamedTarget_ targetAt_(size_t index) const;
+	size_t numTargets_() const;
+	void applyValue_(const NamedTarget_& target,
+			 const std::string& appName, const char* value,
+			 const char* sourceType, const std::string& sourceName,
+			 size_t line);
+	void invokeHandler_(ArgHandler* handler, CmdLineArgGenerator& args,
+			    const std::string& arg);
+	void invokeFlag_(size_t flag, bool negated, const char* value);
+	template <typename Function>
+	void observeValue_(const ArgText& argName, const Function& f);
+	void indexNames_() const;
+	void reserveContainers_(int argc, char** argv);
+	void addFlag_(const ArgText& argName, const ArgText& description,
+		      bool negatable, const FlagTable::Flag& flag);
+	bool handleFlag_(const std::string& appName, const std::string& arg);
+	bool handleShortFlags_(const std::string& appName,
+			       const std::string& arg);
+	void applyFlagArg_(const std::string& appName,
+			   const FlagTable::Match& match, const char* value);
+	static void setFlag_(const FlagTable::Flag& flag, bool negated,
+			     const char* value);
+	void addContainerBytes_(size_t n);
+	[[noreturn]] void tooManyContainerBytes_() const;
+	[[noreturn]] void tooManyListElements_() const;
+
+	template <typename Item, typename Value>
+	static void insertInto_(std::vector<Item>& c, Value&& v) {
+	  c.push_back(std::forward<Value>(v));
+	}
+
+	template <typename Item, typename Hash, typename Equal,
+		  typename Value>
+	static void insertInto_(std::unordered_set<Item, Hash, Equal>& c,
+				Value&& v) {
+	  c.insert(std::forward<Value>(v));
+	}
+
+	template <typename Value>
+	static size_t sizeOfValue_(const Value& /* v */) {
+	  return sizeof(Value);
+	}
+
+	static size_t sizeOfValue_(const std::string& v) {
+	  return sizeof(std::string) + v.size();
+	}
+
+	template <typename Destination>
+	struct ItemOf_ {
+	  typedef Destination Type;
+	};
+
+	template <typename Item, typename Allocator>
+	struct ItemOf_< std::vector<Item, Allocator> > {
+	  typedef Item Type;
+	};
+
+	template <typename Item, typename Hash, typename Equal>
+	struct ItemOf_< std::unordered_set<Item, Hash, Equal> > {
+	  typedef Item Type;
+	};
+
+	template <typename Constraint>
+	static std::shared_ptr<const void> holdConstraint_(
+	    const Constraint& constraint
+	) {
+	  return std::make_shared<Constraint>(constraint);
+	}
+
+	static std::shared_ptr<const void> holdConstraint_(
+	    const NoConstraint_& /* constraint */
+	) {
+	  return std::shared_ptr<const void>();
+	}
+
+	template <typename Value>
+	static Value convert_(const std::string& value,
+			      const NoConstraint_* /* constraint */) {
+	  return ArgFormatter<Value>::format(value);
+	}
+
+	template <typename Value>
+	static Value convert_(const std::string& value,
+			      const Range_<Value>* range) {
+	  return ArgFormatter<Value>::format(value, range->minValue,
+					     range->maxValue);
+	}
+
+	template <typename Value>
+	static Value convert_(const std::string& value,
+			      const std::unordered_set<Value>* legalValues) {
+	  return ArgFormatter<Value>::format(value, *legalValues);
+	}
+
+	template <typename Value>
+	static Value convert_(const std::string& value,
+			      const ValueMap<Value>* valueMap) {
+	  return (*valueMap)[value];
+	}
+
+	template <typename Value>
+	static Value convert_(
+	    const std::string& value,
+	    const std::function<Value (const std::string&)>* format
+	) {
+	  return formatUsingFn(value, *format);
+	}
+
+	template <typename Destination, typename Value>
+	void storeIn_(Destination& d, Value&& v) {
+	  d= std::forward<Value>(v);
+	}
+
+	template <typename Item, typename Allocator, typename Value>
+	void storeIn_(std::vector<Item, Allocator>& d, Value&& v) {
+	  addTo_(d, std::forward<Value>(v));
+	}
+
+	template <typename Item, typename Hash, typename Equal,
+		  typename Value>
+	void storeIn_(std::unordered_set<Item, Hash, Equal>& d, Value&& v) {
+	  addTo_(d, std::forward<Value>(v));
+	}
+
+	template <typename Destination>
+	static KernelArgHandler::ReserveFn reserveFor_(Destination& /* d */) {
+	  return nullptr;
+	}
+
+	template <typename Item, typename Allocator>
+	static KernelArgHandler::ReserveFn reserveFor_(
+	    std::vector<Item, Allocator>& /* d */
+	) {
+	  return &reserveIn_< std::vector<Item, Allocator> >;
+	}
+
+	template <typename Item, typename Hash, typename Equal>
+	static KernelArgHandler::ReserveFn reserveFor_(
+	    std::unordered_set<Item, Hash, Equal>& /* d */
+	) {
+	  return &reserveIn_< std::unordered_set<Item, Hash, Equal> >;
+	}
+
+	// Never reserves more than maxBytes worth of items, so a long value
+	// cannot allocate past ParseLimits::maxContainerBytes before the
+	// limit is checked
+	template <typename Container>
+	static void reserveIn_(void* destination, size_t numItems,
+			       size_t maxBytes) {
+	  typedef typename Container::value_type Item;
+	  Container& c= *static_cast<Container*>(destination);
+	  c.reserve(c.size() + std::min(numItems, maxBytes / sizeof(Item)));
+	}
+
+	template <typename Destination>
+	void convertInto_(Destination& d, const std::string& value,
+			  std::false_type) {
+	  typedef typename ItemOf_<Destination>::Type Value;
+	  storeIn_(d, ArgFormatter<Value>::format(value));
+	}
+
+	template <typename Destination>
+	void convertInto_(Destination& d, const std::string& value,
+			  std::true_type) {
+	  typedef typename ItemOf_<Destination>::Type Value;
+	  ArgConversion<Value>::convert(
+	      value.data(), value.data() + value.size(),
+	      [this, &d](auto&&... args) {
+		emplaceIn_(d, std::forward<decltype(args)>(args)...);
+	      }
+	  );
+	}
+
+	template <typename Destination, typename... Args>
+	void emplaceIn_(Destination& d, Args&&... args) {
+	  d= Destination(std::forward<Args>(args)...);
+	}
+
+	template <typename Item, typename Allocator, typename... Args>
+	void emplaceIn_(std::vector<Item, Allocator>& d, Args&&... args) {
+	  d.emplace_back(std::forward<Args>(args)...);
+	  if (parseLimits().maxContainerBytes != ParseLimits::UNLIMITED) {
+	    addContainerBytes_(sizeOfValue_(d.back()));
 	  }
-	  return v.first;
 	}
 
-	static int format(const std::string& value, int minValue,
-			  int maxValue) {
-	  int v= format(value);
-	  if ((v < minValue) || (v > maxValue)) {
-	    std::ostringstream msg;
-	    if (minValue == INT_MIN) {
-	      msg << "Value must be less than or equal to " << maxValue;
-	    } else if (maxValue == INT_MAX) {
-	      msg << "Value must be greater than or equal to " << maxValue;
-	    } else {
-	      msg << "Value must be between " << minValue << "and "
-		  << maxValue << " (inclusive)";
-	    }
-	    throw FormatError(value, msg.str());
+	template <typename Item, typename Hash, typename Equal,
+		  typename... Args>
+	void emplaceIn_(std::unordered_set<Item, Hash, Equal>& d,
+			Args&&... args) {
+	  auto i= d.emplace(std::forward<Args>(args)...);
+	  if (parseLimits().maxContainerBytes != ParseLimits::UNLIMITED) {
+	    addContainerBytes_(sizeOfValue_(*i.first));
 	  }
-	  return v;
 	}
 
-	static int format(const std::string& value,
-			  const std::unordered_set<int>& legalValues) {
-	  int v= format(value);
-	  if (legalValues.find(v) == legalValues.end()) {
+	template <typename Destination, typename Constraint>
+	void storeValue_(Destination& d, const Constraint* constraint,
+			 const std::string& value) {
+	  typedef typename ItemOf_<Destination>::Type Value;
+	  storeIn_(d, convert_<Value>(value, constraint));
+	}
+
+	template <typename Destination>
+	void storeValue_(Destination& d, const NoConstraint_* /* constraint */,
+			 const std::string& value) {
+	  convertInto_(d, value);
+	}
+
+	template <typename Value>
+	void storeValue_(MappedArray<Value>& d,
+			 const NoConstraint_* /* constraint */,
+			 const std::string& value) {
+	  d.map(mappedPath_(value));
+	}
+
+	template <typename Value>
+	void storeValue_(MappedArray<Value>& d, const Range_<Value>* range,
+			 const std::string& value) {
+	  MappedArray<Value> array;
+	  array.map(mappedPath_(value));
+	  const size_t i= array.findOutOfRange(range->minValue,
+					       range->maxValue);
+	  if (i < array.size()) {
 	    std::ostringstream msg;
-	    msg << "Legal values are "
-		<< util::join(legalValues.begin(), legalValues.end(), ", ");
+	    msg << "Element " << i << " is " << +array[i]
+		<< ", which is not between " << +range->minValue << " and "
+		<< +range->maxValue << " (inclusive)";
 	    throw FormatError(value, msg.str());
 	  }
-	  return v;
+	  d= array;
 	}
-      };
 
-      template <>
-      class SimpleCmdLineArgs::ArgFormatter<double> {
-      public:
-	static double format(const std::string& value) {
-	  std::pair<double, util::NumConversionResult> v=
-	    util::toDoubleQuietly(value);
-	  if (v.second != util::NumConversionResult::OK) {
-	    throw FormatError(value, descriptionFor(v.second));
-	  }
-	  return v.first;
+	/** The path in a value of the form "@path" */
+	static std::string mappedPath_(const std::string& value);
+
+	template <typename Map>
+	void storeValue_(Map& d, const KeyValueFormat_* format,
+			 const std::string& value) {
+	  typedef typename Map::key_type Key;
+	  typedef typename Map::mapped_type Mapped;
+	  const bool limitBytes=
+	      parseLimits().maxContainerBytes != ParseLimits::UNLIMITED;
+	  applyToPairs_(value, format->separator,
+			[this, &d, format, limitBytes](const std::string& k,
+						       const std::string& v) {
+	    Key key(ArgFormatter<Key>::format(k));
+	    auto i= d.find(key);
+	    if (i == d.end()) {
+	      i= d.emplace(std::move(key), ArgFormatter<Mapped>::format(v))
+		     .first;
+	      if (limitBytes) {
+		addContainerBytes_(sizeOfValue_(i->first) +
+				   sizeOfValue_(i->second));
+	      }
+	    } else if (format->onDuplicate == DuplicateKeyPolicy::KEEP_LAST) {
+	      i->second= ArgFormatter<Mapped>::format(v);
+	    } else if (format->onDuplicate == DuplicateKeyPolicy::REJECT) {
+	      throw FormatError(k, "Duplicate key");
+	    }
+	  });
 	}
 
-	static double format(const std::string& value, double minValue,
-			     double maxValue) {
-	  double v= format(value);
-	  if ((v < minValue) || (v > maxValue)) {
-	    std::ostringstream msg;
-	    if (minValue == -DBL_MAX) {
-	      msg << "Value must be less than or equal to " << maxValue;
-	    } else if (maxValue == DBL_MAX) {
-	      msg << "Value must be greater than or equal to " << maxValue;
-	    } else {
-	      msg << "Value must be between " << minValue << "and "
-		  << maxValue << " (inclusive)";
+	/** Call f(bit) with the bit for each name in value, a list of names
+	 *  of enum values separated by enumBits.separator.
+	 */
+	template <typename Value, typename Function>
+	void applyToBits_(const std::string& value,
+			  const EnumBits_<Value>& enumBits,
+			  const Function& f) {
+	  if (value.empty()) {
+	    if (!enumBits.allowEmpty) {
+	      throw FormatError("Value is empty");
 	    }
-	    throw FormatError(value, msg.str());
+	    return;
+	  } else if (parseLimits().maxListElements != ParseLimits::UNLIMITED) {
+	    checkListSize_(value, enumBits.separator);
+	  }
+
+	  const char* const end= value.data() + value.size();
+	  std::string name;
+	  for (const char* p= value.data(); ;
+	       p += enumBits.separator.size()) {
+	    const char* next= findSeparator_(p, end, enumBits.separator);
+	    name.assign(p, next);
+	    auto i= enumBits.bits.find(name);
+	    if (i == enumBits.bits.end()) {
+	      throw FormatError(name, enumBits.values.legalValues());
+	    }
+	    f(i->second);
+	    if (next == end) {
+	      break;
+	    }
+	    p= next;
 	  }
-	  return v;
 	}
 
-	static double format(const std::string& value,
-			     const std::unordered_set<double>& legalValues) {
-	  double v= format(value);
-	  if (legalValues.find(v) == legalValues.end()) {
-	    std::ostringstream msg;
-	    msg << "Legal values are "
-		<< util::join(legalValues.begin(), legalValues.end(), ", ");
-	    throw FormatError(value, msg.str());
+	template <typename Value>
+	void storeValue_(uint64_t& d, const EnumBits_<Value>* enumBits,
+			 const std::string& value) {
+	  // Nothing is stored unless every name is legal
+	  uint64_t bits= 0;
+	  applyToBits_(value, *enumBits, [&bits](uint32_t bit) {
+	    bits |= (uint64_t)1 << bit;
+	  });
+	  d |= bits;
+	}
+
+	template <size_t N, typename Value>
+	void storeValue_(std::bitset<N>& d, const EnumBits_<Value>* enumBits,
+			 const std::string& value) {
+	  std::bitset<N> bits;
+	  applyToBits_(value, *enumBits, [&bits](uint32_t bit) {
+	    bits.set(bit);
+	  });
+	  d |= bits;
+	}
+
+	/** The slots of a destination that a parallel conversion fills */
+	class ParallelSink_ {
+	public:
+	  virtual ~ParallelSink_() { }
+
+	  /** Size of one slot, which is the least an item can add to
+	   *  the bytes stored
+	   */
+	  virtual size_t slotSize() const = 0;
+
+	  /** Add numItems empty slots */
+	  virtual void resize(size_t numItems) = 0;
+
+	  /** Convert item into slot i and return the number of bytes it
+	   *  adds to the bytes stored.  Called on several threads at once,
+	   *  but never twice for the same slot.
+	   */
+	  virtual size_t convert(size_t i, const std::string& item) = 0;
+
+	  /** Remove all but the first numItems slots added */
+	  virtual void truncate(size_t numItems) = 0;
+	};
+
+	template <typename Item, typename Allocator, typename Constraint>
+	class VectorSink_ : public ParallelSink_ {
+	public:
+	  VectorSink_(std::vector<Item, Allocator>& d,
+		      const Constraint* constraint):
+	      d_(d), constraint_(constraint), start_(d.size()) {
+	    // Intentionally left blank
+	  }
+
+	  virtual size_t slotSize() const { return sizeof(Item); }
+
+	  virtual void resize(size_t numItems) {
+	    d_.resize(start_ + numItems);
 	  }
-	  return v;
+
+	  virtual size_t convert(size_t i, const std::string& item) {
+	    d_[start_ + i]= convert_<Item>(item, constraint_);
+	    return sizeOfValue_(d_[start_ + i]);
+	  }
+
+	  virtual void truncate(size_t numItems) {
+	    d_.erase(d_.begin() + start_ + numItems, d_.end());
+	  }
+
+	private:
+	  std::vector<Item, Allocator>& d_;
+	  const Constraint* constraint_;
+	  size_t start_;
+	};
+
+	void convertInParallel_(const std::string& value, char separator,
+				ParallelSink_& sink);
+
+	template <typename Item, typename Allocator, typename Constraint>
+	static void storeInParallel_(SimpleCmdLineArgs& owner,
+				     void* destination,
+				     const void* constraint,
+				     const std::string& value,
+				     char separator) {
+	  std::vector<Item, Allocator>& d=
+	      *static_cast<std::vector<Item, Allocator>*>(destination);
+	  VectorSink_<Item, Allocator, Constraint> sink(
+	      d, static_cast<const Constraint*>(constraint)
+	  );
+	  owner.convertInParallel_(value, separator, sink);
+	}
+
+	/** Whether items can be converted into slots on several threads.
+	 *  Slots are made before the items are converted into them, so the
+	 *  items must be default-constructible and assignable, and the
+	 *  slots of a std::vector<bool> share words.
+	 */
+	template <typename Item>
+	struct ConvertsInParallel_ :
+	    std::integral_constant<
+	        bool,
+		!std::is_same<Item, bool>::value &&
+		std::is_default_constructible<Item>::value &&
+		std::is_move_assignable<Item>::value
+	    > {
+	};
+
+	template <typename Item, typename Allocator, typename Constraint>
+	static KernelArgHandler::ParallelStoreFn parallelStoreIn_(
+	    std::true_type
+	) {
+	  return &storeInParallel_<Item, Allocator, Constraint>;
 	}
+
+	template <typename Item, typename Allocator, typename Constraint>
+	static KernelArgHandler::ParallelStoreFn parallelStoreIn_(
+	    std::false_type
+	) {
+	  return nullptr;
+	}
+
+	template <typename Destination, typename Constraint>
+	static KernelArgHandler::ParallelStoreFn parallelStoreFor_(
+	    Destination& /* d */, const Constraint* /* constraint */
+	) {
+	  return nullptr;
+	}
+
+	template <typename Item, typename Allocator, typename Constraint>
+	static KernelArgHandler::ParallelStoreFn parallelStoreFor_(
+	    std::vector<Item, Allocator>& /* d */,
+	    const Constraint* /* constraint */
+	) {
+	  return parallelStoreIn_<Item, Allocator, Constraint>(
+	      ConvertsInParallel_<Item>()
+	  );
+	}
+
+	template <typename Item, typename Allocator>
+	static KernelArgHandler::ParallelStoreFn parallelStoreFor_(
+	    std::vector<Item, Allocator>& /* d */,
+	    const std::function<Item (const std::string&)>* /* constraint */
+	) {
+	  return nullptr;
+	}
+
+	template <typename Item, typename Allocator>
+	static KernelArgHandler::ParallelStoreFn parallelStoreFor_(
+	    std::vector<Item, Allocator>& d, const NoConstraint_* constraint
+	) {
+	  return parallelStoreFor_(d, constraint, HasArgConversion<Item>());
+	}
+
+	template <typename Item, typename Allocator>
+	static KernelArgHandler::ParallelStoreFn parallelStoreFor_(
+	    std::vector<Item, Allocator>& /* d */,
+	    const NoConstraint_* /* constraint */, std::false_type
+	) {
+	  return parallelStoreIn_<Item, Allocator, NoConstraint_>(
+	      ConvertsInParallel_<Item>()
+	  );
+	}
+
+	template <typename Item, typename Allocator>
+	static KernelArgHandler::ParallelStoreFn parallelStoreFor_(
+	    std::vector<Item, Allocator>& /* d */,
+	    const NoConstraint_* /* constraint */, std::true_type
+	) {
+	  return nullptr;
+	}
+
+	template <typename Destination, typename Constraint>
+	static void storeItem_(SimpleCmdLineArgs& owner, void* destination,
+			       const void* constraint,
+			       const std::string& value) {
+	  owner.storeValue_(*static_cast<Destination*>(destination),
+			    static_cast<const Constraint*>(constraint), value);
+	}
+      };
+
+      template <>
+      class SimpleCmdLineArgs::ArgFormatter<int> {
+      public:
+	static int format(const std::string& value);
+	static int format(const std::string& value, int minValue,
+			  int maxValue);
+	static int format(const std::string& value,
+			  const std::unordered_set<int>& legalValues);
+      };
+
+      template <>
+      class SimpleCmdLineArgs::ArgFormatter<double> {
+      public:
+	static double format(const std::string& value);
+	static double format(const std::string& value, double minValue,
+			     double maxValue);
+	static double format(const std::string& value,
+			     const std::unordered_set<double>& legalValues);
       };
 
       template <>
@@ -1245,31 +2312,59 @@ namespace pistis {
 
 	static const std::string& format(const std::string& value,
 					 const std::string& minValue,
-					 const std::string& maxValue) {
-	  if ((value < minValue) || (value > maxValue)) {
-	    std::ostringstream msg;
-	    msg << "Value must be between \"" << minValue << "\" and \""
-		<< maxValue << "\" (inclusive)";
-	    throw FormatError(value, msg.str());
-	  }
-	  return value;
-	}
-
+					 const std::string& maxValue);
 	static const std::string& format(
 	    const std::string& value,
 	    const std::unordered_set<std::string>& legalValues
-	) {
-	  if (legalValues.find(value) == legalValues.end()) {
-	    std::ostringstream msg;
-	    msg << "Legal values are \""
-		<< util::join(legalValues.begin(), legalValues.end(),
-			      "\", \"")
-		<< "\"";
-	    throw FormatError(value, msg.str());
-	  }
-	  return value;
-	}
+	);
       };
+
+      /** The kernels for the most common destinations are instantiated
+       *  once, in SimpleCmdLineArgs.cpp, rather than in every program
+       *  that registers arguments with them.
+       */
+#define PISTIS_ARG_PARSER_KERNEL_(EXTERN, Destination, Constraint) \
+      EXTERN template void                                           \
+      SimpleCmdLineArgs::storeItem_<Destination, Constraint>(        \
+	  SimpleCmdLineArgs&, void*, const void*, const std::string&  \
+      );
+
+#define PISTIS_ARG_PARSER_KERNELS_FOR_(EXTERN, Destination, Value)   \
+      PISTIS_ARG_PARSER_KERNEL_(EXTERN, Destination,                 \
+				SimpleCmdLineArgs::NoConstraint_)    \
+      PISTIS_ARG_PARSER_KERNEL_(EXTERN, Destination,                 \
+				SimpleCmdLineArgs::Range_<Value>)    \
+      PISTIS_ARG_PARSER_KERNEL_(EXTERN, Destination,                 \
+				std::unordered_set<Value>)
+
+#define PISTIS_ARG_PARSER_KERNELS_(EXTERN, Value)                    \
+      PISTIS_ARG_PARSER_KERNELS_FOR_(EXTERN, Value, Value)           \
+      PISTIS_ARG_PARSER_KERNELS_FOR_(EXTERN, std::vector<Value>, Value) \
+      PISTIS_ARG_PARSER_KERNELS_FOR_(EXTERN, std::unordered_set<Value>, \
+				     Value)
+
+#define PISTIS_ARG_PARSER_PARALLEL_(EXTERN, Value, Constraint)        \
+      EXTERN template void                                           \
+      SimpleCmdLineArgs::storeInParallel_<Value, std::allocator<Value>, \
+					  Constraint>(                \
+	  SimpleCmdLineArgs&, void*, const void*, const std::string&, \
+	  char                                                        \
+      );
+
+#define PISTIS_ARG_PARSER_PARALLELS_(EXTERN, Value)                  \
+      PISTIS_ARG_PARSER_PARALLEL_(EXTERN, Value,                     \
+				  SimpleCmdLineArgs::NoConstraint_)  \
+      PISTIS_ARG_PARSER_PARALLEL_(EXTERN, Value,                     \
+				  SimpleCmdLineArgs::Range_<Value>)  \
+      PISTIS_ARG_PARSER_PARALLEL_(EXTERN, Value,                     \
+				  std::unordered_set<Value>)
+
+      PISTIS_ARG_PARSER_KERNELS_(extern, int)
+      PISTIS_ARG_PARSER_KERNELS_(extern, double)
+      PISTIS_ARG_PARSER_KERNELS_(extern, std::string)
+      PISTIS_ARG_PARSER_PARALLELS_(extern, int)
+      PISTIS_ARG_PARSER_PARALLELS_(extern, double)
+      PISTIS_ARG_PARSER_PARALLELS_(extern, std::string)
 	
   }
 }
@@ -0,0 +1,85 @@
+#include "SubcommandCmdLineArgs.hpp"
+#include "RequiredCmdLineArgMissingError.hpp"
+#include "UnknownSubcommandError.hpp"
+#include <pistis/exceptions/IllegalValueError.hpp>
+#include <algorithm>
+#include <string.h>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  bool nameLessThan(const SubcommandCmdLineArgs::Subcommand& cmd,
+		    const char* name) {
+    return strcmp(cmd.name, name) < 0;
+  }
+}
+
+SubcommandCmdLineArgs::SubcommandCmdLineArgs(const Subcommand* subcommands,
+					     size_t numSubcommands,
+					     bool required):
+    SimpleCmdLineArgs(), subcommands_(subcommands),
+    numSubcommands_(numSubcommands), required_(required),
+    instances_(numSubcommands), selected_(nullptr), selectedArgs_(nullptr) {
+  for (size_t i= 1; i < numSubcommands; ++i) {
+    if (strcmp(subcommands[i-1].name, subcommands[i].name) >= 0) {
+      throw pistis::exceptions::IllegalValueError(
+	  "subcommands", subcommands[i].name,
+	  "Subcommands must be sorted by name and unique", PISTIS_EX_HERE
+      );
+    }
+  }
+}
+
+const SubcommandCmdLineArgs::Subcommand*
+    SubcommandCmdLineArgs::findSubcommand(const std::string& name) const {
+  const Subcommand* end= subcommands_ + numSubcommands_;
+  const Subcommand* i=
+      std::lower_bound(subcommands_, end, name.c_str(), nameLessThan);
+  return ((i != end) && !strcmp(i->name, name.c_str())) ? i : nullptr;
+}
+
+void SubcommandCmdLineArgs::init_(int argc, char** argv) {
+  SimpleCmdLineArgs::init_(argc, argv);
+  selected_= nullptr;
+  selectedArgs_= nullptr;
+}
+
+bool SubcommandCmdLineArgs::handleUnnamedArg_(CmdLineArgGenerator& args,
+					      const std::string& arg) {
+  const Subcommand* cmd= findSubcommand(arg);
+  if (!cmd) {
+    // Not a command, so it may be a value for one of our own unnamed
+    // arguments
+    if (SimpleCmdLineArgs::handleUnnamedArg_(args, arg)) {
+      return true;
+    }
+    throw UnknownSubcommandError(args.appName(), arg);
+  }
+
+  std::unique_ptr<AbstractCmdLineArgs>& instance=
+      instances_[cmd - subcommands_];
+  if (!instance) {
+    instance= cmd->create();
+  }
+
+  std::string appName= args.appName() + " " + cmd->name;
+  std::vector<char*> argv;
+  argv.reserve(args.remaining() + 2);
+  argv.push_back(&appName[0]);
+  argv.insert(argv.end(), args.remainingArgv(),
+	      args.remainingArgv() + args.remaining());
+  argv.push_back(nullptr);
+  args.skipRemaining();
+
+  selected_= cmd;
+  selectedArgs_= instance.get();
+  instance->parse((int)argv.size() - 1, argv.data());
+  return true;
+}
+
+void SubcommandCmdLineArgs::check_(const std::string& appName) {
+  if (required_ && !selected_ && !showUsage()) {
+    throw RequiredCmdLineArgMissingError(appName, "Command");
+  }
+  SimpleCmdLineArgs::check_(appName);
+}
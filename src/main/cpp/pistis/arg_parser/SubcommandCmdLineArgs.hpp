@@ -0,0 +1,68 @@
+#ifndef __PISTIS__ARG_PARSER__SUBCOMMANDCMDLINEARGS_HPP__
+#define __PISTIS__ARG_PARSER__SUBCOMMANDCMDLINEARGS_HPP__
+
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Command-line arguments of the form "app [options] command [args]".
+     *
+     *  The commands are given by a static table sorted by name and found
+     *  by binary search.  Each entry's factory creates the arguments for
+     *  that command, and runs only when the command is first selected, so
+     *  the options of commands that are not used are never registered.
+     *  Options before the command name are handled by this object like
+     *  any SimpleCmdLineArgs, and so are unnamed arguments that are not
+     *  command names, as long as this object has unnamed arguments
+     *  registered to take them.  Everything after the command name goes
+     *  to the command's arguments, with "app command" as the application
+     *  name.
+     */
+    class SubcommandCmdLineArgs : public SimpleCmdLineArgs {
+    public:
+      struct Subcommand {
+	const char* name;
+	const char* description;
+	std::unique_ptr<AbstractCmdLineArgs> (*create)();
+      };
+
+    public:
+      SubcommandCmdLineArgs(const Subcommand* subcommands,
+			    size_t numSubcommands, bool required = true);
+
+      template <size_t N>
+      SubcommandCmdLineArgs(const Subcommand (&subcommands)[N],
+			    bool required = true):
+	  SubcommandCmdLineArgs(subcommands, N, required) {
+      }
+
+      size_t numSubcommands() const { return numSubcommands_; }
+      const Subcommand& subcommand(size_t i) const { return subcommands_[i]; }
+      const Subcommand* findSubcommand(const std::string& name) const;
+
+      const Subcommand* selected() const { return selected_; }
+      AbstractCmdLineArgs* selectedArgs() const { return selectedArgs_; }
+
+    protected:
+      virtual void init_(int argc, char** argv);
+      virtual bool handleUnnamedArg_(CmdLineArgGenerator& args,
+				     const std::string& arg);
+      virtual void check_(const std::string& appName);
+
+    private:
+      const Subcommand* subcommands_;
+      size_t numSubcommands_;
+      bool required_;
+      std::vector< std::unique_ptr<AbstractCmdLineArgs> > instances_;
+      const Subcommand* selected_;
+      AbstractCmdLineArgs* selectedArgs_;
+    };
+
+  }
+}
+#endif
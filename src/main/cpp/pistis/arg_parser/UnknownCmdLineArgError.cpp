@@ -5,17 +5,36 @@ using namespace pistis::arg_parser;
 
 UnknownCmdLineArgError::UnknownCmdLineArgError(const std::string& appName,
 					       const std::string& argName):
-    CmdLineArgError(appName, _createMessage(argName)) {
+    UnknownCmdLineArgError(appName, argName, std::vector<std::string>()) {
+  // Intentionally left blank
+}
+
+UnknownCmdLineArgError::UnknownCmdLineArgError(
+    const std::string& appName, const std::string& argName,
+    const std::vector<std::string>& suggestions
+):
+    CmdLineArgError(appName, _createMessage(argName, suggestions)),
+    argName_(argName), suggestions_(suggestions) {
   // Intentionally left blank
 }
 
 std::string UnknownCmdLineArgError::_createMessage(
-    const std::string& argName
+    const std::string& argName, const std::vector<std::string>& suggestions
 ) {
   std::ostringstream msg;
   msg << "Unknown command-line argument";
   if (!argName.empty()) {
     msg << " " << argName;
   }
+  if (!suggestions.empty()) {
+    msg << " (did you mean ";
+    for (size_t i= 0; i < suggestions.size(); ++i) {
+      if (i) {
+	msg << ((i + 1 == suggestions.size()) ? " or " : ", ");
+      }
+      msg << suggestions[i];
+    }
+    msg << "?)";
+  }
   return msg.str();
 }
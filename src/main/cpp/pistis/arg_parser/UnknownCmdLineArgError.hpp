@@ -2,6 +2,8 @@
 #define __PISTIS__UTIL__ARGS__UNKNOWNCMDLINEARGERROR_HPP__
 
 #include <pistis/arg_parser/CmdLineArgError.hpp>
+#include <string>
+#include <vector>
 
 namespace pistis {
   namespace arg_parser {
@@ -10,9 +12,25 @@ namespace pistis {
     public:
       UnknownCmdLineArgError(const std::string& appName,
 			     const std::string& argName);
+      UnknownCmdLineArgError(const std::string& appName,
+			     const std::string& argName,
+			     const std::vector<std::string>& suggestions);
+
+      const std::string& argName() const { return argName_; }
+
+      /** Registered arguments close to the unknown one */
+      const std::vector<std::string>& suggestions() const {
+	return suggestions_;
+      }
 
     private:
-      static std::string _createMessage(const std::string& argName);
+      std::string argName_;
+      std::vector<std::string> suggestions_;
+
+      static std::string _createMessage(
+	  const std::string& argName,
+	  const std::vector<std::string>& suggestions
+      );
     };
 
   }
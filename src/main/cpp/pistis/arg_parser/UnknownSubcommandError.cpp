@@ -0,0 +1,19 @@
+#include "UnknownSubcommandError.hpp"
+#include <sstream>
+
+using namespace pistis::arg_parser;
+
+UnknownSubcommandError::UnknownSubcommandError(const std::string& appName,
+					       const std::string& subcommand):
+    CmdLineArgError(appName, createMessage_(subcommand)),
+    subcommand_(subcommand) {
+  // Intentionally left blank
+}
+
+std::string UnknownSubcommandError::createMessage_(
+    const std::string& subcommand
+) {
+  std::ostringstream msg;
+  msg << "Unknown command \"" << subcommand << "\".  Use -h for help.";
+  return msg.str();
+}
@@ -0,0 +1,24 @@
+#ifndef __PISTIS__ARG_PARSER__UNKNOWNSUBCOMMANDERROR_HPP__
+#define __PISTIS__ARG_PARSER__UNKNOWNSUBCOMMANDERROR_HPP__
+
+#include <pistis/arg_parser/CmdLineArgError.hpp>
+
+namespace pistis {
+  namespace arg_parser {
+
+    class UnknownSubcommandError : public CmdLineArgError {
+    public:
+      UnknownSubcommandError(const std::string& appName,
+			     const std::string& subcommand);
+
+      const std::string& subcommand() const { return subcommand_; }
+
+    private:
+      std::string subcommand_;
+
+      static std::string createMessage_(const std::string& subcommand);
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,156 @@
+#include "WorkStealingScheduler.hpp"
+#include <pistis/exceptions/IllegalValueError.hpp>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+#include <stdlib.h>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  const size_t CACHE_LINE_SIZE= 64;
+
+  // Padded to a cache line and allocated on a cache line boundary by
+  // allocateQueues(), so workers claiming chunks from different queues
+  // do not contend for the same line.  new does not honor alignas()
+  // beyond alignof(std::max_align_t) before C++17.
+  struct WorkQueue {
+    std::atomic<size_t> next;
+    size_t end;
+    char padding[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>) -
+		 sizeof(size_t)];
+  };
+
+  static_assert(sizeof(WorkQueue) == CACHE_LINE_SIZE,
+		"WorkQueue must fill exactly one cache line");
+
+  struct FreeQueues {
+    void operator()(WorkQueue* queues) const { free(queues); }
+  };
+
+  typedef std::unique_ptr<WorkQueue[], FreeQueues> QueueArray;
+
+  QueueArray allocateQueues(size_t n) {
+    void* p= nullptr;
+    if (posix_memalign(&p, CACHE_LINE_SIZE, n * sizeof(WorkQueue))) {
+      throw std::bad_alloc();
+    }
+    WorkQueue* queues= static_cast<WorkQueue*>(p);
+    for (size_t i= 0; i < n; ++i) {
+      new (queues + i) WorkQueue();
+    }
+    return QueueArray(queues);
+  }
+
+  class SchedulerRun {
+  public:
+    SchedulerRun(size_t numWorkers, size_t numItems, size_t chunkSize,
+		 const WorkStealingScheduler::WorkFunction& work):
+        queues_(allocateQueues(numWorkers)), numWorkers_(numWorkers),
+	chunkSize_(chunkSize), work_(work), failed_(false), errorLock_(),
+	error_() {
+      const size_t perWorker= numItems / numWorkers;
+      const size_t extra= numItems % numWorkers;
+      size_t begin= 0;
+      for (size_t i= 0; i < numWorkers; ++i) {
+	const size_t n= perWorker + ((i < extra) ? 1 : 0);
+	queues_[i].next.store(begin, std::memory_order_relaxed);
+	queues_[i].end= begin + n;
+	begin += n;
+      }
+    }
+
+    void runWorker(size_t worker) {
+      try {
+	for (size_t i= 0; i < numWorkers_; ++i) {
+	  WorkQueue& q= queues_[(worker + i) % numWorkers_];
+	  while (!failed_.load(std::memory_order_relaxed)) {
+	    const size_t begin=
+	        q.next.fetch_add(chunkSize_, std::memory_order_relaxed);
+	    if (begin >= q.end) {
+	      break;
+	    }
+	    work_(worker, begin, std::min(begin + chunkSize_, q.end));
+	  }
+	}
+      } catch(...) {
+	std::lock_guard<std::mutex> lock(errorLock_);
+	if (!error_) {
+	  error_= std::current_exception();
+	}
+	failed_.store(true, std::memory_order_relaxed);
+      }
+    }
+
+    // Make the workers that are running stop claiming chunks
+    void abandon() {
+      failed_.store(true, std::memory_order_relaxed);
+    }
+
+    void rethrowIfFailed() const {
+      if (error_) {
+	std::rethrow_exception(error_);
+      }
+    }
+
+  private:
+    QueueArray queues_;
+    size_t numWorkers_;
+    size_t chunkSize_;
+    const WorkStealingScheduler::WorkFunction& work_;
+    std::atomic<bool> failed_;
+    std::mutex errorLock_;
+    std::exception_ptr error_;
+  };
+}
+
+WorkStealingScheduler::WorkStealingScheduler(size_t numThreads):
+    numThreads_(numThreads ? numThreads
+		           : std::max(1u, std::thread::hardware_concurrency())) {
+  // Intentionally left blank
+}
+
+void WorkStealingScheduler::run(size_t numItems, size_t chunkSize,
+				const WorkFunction& work) const {
+  if (!chunkSize) {
+    throw pistis::exceptions::IllegalValueError("chunkSize", "must be > 0",
+						PISTIS_EX_HERE);
+  }
+  if (!numItems) {
+    return;
+  }
+
+  const size_t numChunks= (numItems + chunkSize - 1) / chunkSize;
+  const size_t numWorkers= std::min(numThreads_, numChunks);
+  SchedulerRun schedulerRun(numWorkers, numItems, chunkSize, work);
+  std::vector<std::thread> threads;
+
+  auto joinAll= [&threads]() {
+    for (auto i= threads.begin(); i != threads.end(); ++i) {
+      i->join();
+    }
+  };
+
+  try {
+    threads.reserve(numWorkers - 1);
+    for (size_t i= 1; i < numWorkers; ++i) {
+      threads.emplace_back([&schedulerRun, i]() {
+	schedulerRun.runWorker(i);
+      });
+    }
+  } catch(...) {
+    // The threads already started refer to schedulerRun, and destroying
+    // them unjoined would terminate the process
+    schedulerRun.abandon();
+    joinAll();
+    throw;
+  }
+  schedulerRun.runWorker(0);
+  joinAll();
+  schedulerRun.rethrowIfFailed();
+}
@@ -0,0 +1,41 @@
+#ifndef __PISTIS__ARG_PARSER__WORKSTEALINGSCHEDULER_HPP__
+#define __PISTIS__ARG_PARSER__WORKSTEALINGSCHEDULER_HPP__
+
+#include <functional>
+#include <stddef.h>
+
+namespace pistis {
+  namespace arg_parser {
+
+    /** Runs a loop over [0, numItems) on several threads.
+     *
+     *  The index range is divided evenly among the workers up front.  Each
+     *  worker claims chunks from the front of its own range and, once its
+     *  range is exhausted, steals chunks from the other workers' ranges.
+     *  Claiming a chunk is a single atomic fetch-and-add, so no locks are
+     *  taken while the loop runs.  The calling thread acts as worker 0.
+     */
+    class WorkStealingScheduler {
+    public:
+      typedef std::function<void (size_t worker, size_t begin, size_t end)>
+              WorkFunction;
+
+    public:
+      WorkStealingScheduler(size_t numThreads = 0);
+
+      size_t numThreads() const { return numThreads_; }
+
+      /** Call work(worker, begin, end) for disjoint chunks covering
+       *  [0, numItems).  If work throws, the remaining chunks are abandoned
+       *  and the first exception is rethrown once all workers have stopped.
+       */
+      void run(size_t numItems, size_t chunkSize,
+	       const WorkFunction& work) const;
+
+    private:
+      size_t numThreads_;
+    };
+
+  }
+}
+#endif
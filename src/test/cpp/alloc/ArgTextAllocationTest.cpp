@@ -0,0 +1,114 @@
+/** @file ArgTextAllocationTest.cpp
+ *
+ *  Counts the heap allocations made when arguments are registered with
+ *  names and descriptions in static storage.  These tests replace the
+ *  global operator new, so they are linked into a program of their own
+ *  rather than into the unit tests.
+ */
+
+#include <pistis/arg_parser/ArgText.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <gtest/gtest.h>
+#include <new>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  bool countingAllocations= false;
+  size_t numAllocations= 0;
+}
+
+void* operator new(size_t size) {
+  if (countingAllocations) {
+    ++numAllocations;
+  }
+  void* p= malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  free(p);
+}
+
+namespace {
+  const size_t NUM_OPTIONS= 64;
+
+  enum class Text { STATIC, COPIED, SHORT };
+
+  class ManyArgs : public SimpleCmdLineArgs {
+  public:
+    ManyArgs(): SimpleCmdLineArgs(), value_(0),
+		name_("--a-rather-long-option-name"),
+		description_("a description that is too long for SSO") {
+      // Intentionally left blank
+    }
+
+    void registerArg(Text text) {
+      switch (text) {
+        case Text::STATIC:
+	  registerNamedArg_(
+	      StaticText("--a-rather-long-option-name"),
+	      StaticText("a description that is too long for SSO"),
+	      false, value_
+	  );
+	  break;
+
+        case Text::COPIED:
+	  registerNamedArg_(name_, description_, false, value_);
+	  break;
+
+        case Text::SHORT:
+	  registerNamedArg_(std::string("-a"), std::string("short"), false,
+			    value_);
+	  break;
+      }
+    }
+
+  private:
+    int value_;
+    std::string name_;
+    std::string description_;
+  };
+
+  size_t allocationsToRegister(Text text) {
+    std::vector<ManyArgs*> args;
+    for (size_t i= 0; i < NUM_OPTIONS; ++i) {
+      args.push_back(new ManyArgs());
+    }
+
+    numAllocations= 0;
+    countingAllocations= true;
+    for (size_t i= 0; i < NUM_OPTIONS; ++i) {
+      args[i]->registerArg(text);
+    }
+    countingAllocations= false;
+
+    for (auto i= args.begin(); i != args.end(); ++i) {
+      delete *i;
+    }
+    return numAllocations;
+  }
+}
+
+TEST(ArgTextAllocationTests, RegisterWithoutCopyingText) {
+  // Each copied name and description is too long to be stored in the
+  // string itself, so copying them costs two allocations per option
+  const size_t staticAllocations= allocationsToRegister(Text::STATIC);
+  const size_t copiedAllocations= allocationsToRegister(Text::COPIED);
+  EXPECT_GE(copiedAllocations, staticAllocations + 2 * NUM_OPTIONS);
+
+  // Text short enough to be stored in the string itself allocates
+  // nothing, so registering it only makes the allocations that do not
+  // hold text.  Static text must make no more than that.
+  EXPECT_EQ(staticAllocations, allocationsToRegister(Text::SHORT));
+}
@@ -0,0 +1,65 @@
+/** @file CmdLineArgGeneratorBench.cpp
+ *
+ *  Benchmarks for pistis::arg_parser::CmdLineArgGenerator.
+ */
+
+#include <pistis/arg_parser/CmdLineArgGenerator.hpp>
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  const size_t NUM_ARGS= 1024;
+
+  class ArgVector {
+  public:
+    ArgVector(const std::string& value): values_(NUM_ARGS + 1, value),
+					 argv_() {
+      values_[0]= "app";
+      for (auto i= values_.begin(); i != values_.end(); ++i) {
+	argv_.push_back(&(*i)[0]);
+      }
+      argv_.push_back(nullptr);
+    }
+
+    int argc() const { return (int)values_.size(); }
+    char** argv() { return argv_.data(); }
+
+  private:
+    std::vector<std::string> values_;
+    std::vector<char*> argv_;
+  };
+
+  template <typename Function>
+  void consumeAll(benchmark::State& state, const std::string& value,
+		  const Function& f) {
+    ArgVector args(value);
+    for (auto _ : state) {
+      CmdLineArgGenerator gen(args.argc(), args.argv());
+      while (gen.remaining()) {
+	benchmark::DoNotOptimize(f(gen));
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ARGS);
+  }
+}
+
+static void BM_Next(benchmark::State& state) {
+  consumeAll(state, "some-argument-value",
+	     [](CmdLineArgGenerator& gen) { return gen.next(); });
+}
+BENCHMARK(BM_Next);
+
+static void BM_NextAsInt(benchmark::State& state) {
+  consumeAll(state, "123456789",
+	     [](CmdLineArgGenerator& gen) { return gen.nextAsInt(); });
+}
+BENCHMARK(BM_NextAsInt);
+
+static void BM_NextAsDouble(benchmark::State& state) {
+  consumeAll(state, "12345.6789",
+	     [](CmdLineArgGenerator& gen) { return gen.nextAsDouble(); });
+}
+BENCHMARK(BM_NextAsDouble);
@@ -0,0 +1,65 @@
+/** @file GetoptBench.cpp
+ *
+ *  Baseline for the dispatch benchmarks: the same command lines parsed
+ *  with getopt_long().
+ */
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include <getopt.h>
+#include <stdlib.h>
+
+namespace {
+  // Number of options given on each benchmarked command line.  Must match
+  // SimpleCmdLineArgsBench.cpp.
+  const size_t NUM_GIVEN= 64;
+
+  std::string optionName(size_t i) {
+    return "option-" + std::to_string(i);
+  }
+}
+
+static void BM_GetoptLong(benchmark::State& state) {
+  const size_t numOptions= state.range(0);
+  std::vector<std::string> names;
+  std::vector<struct option> options;
+  std::vector<int> values(numOptions);
+
+  for (size_t i= 0; i < numOptions; ++i) {
+    names.push_back(optionName(i));
+  }
+  for (size_t i= 0; i < numOptions; ++i) {
+    options.push_back(option{ names[i].c_str(), required_argument, nullptr,
+	                      (int)(i + 256) });
+  }
+  options.push_back(option{ nullptr, 0, nullptr, 0 });
+
+  std::vector<std::string> words;
+  std::vector<char*> argv;
+  words.push_back("app");
+  for (size_t i= 0; i < NUM_GIVEN; ++i) {
+    words.push_back("--" + optionName((i * 7919) % numOptions));
+    words.push_back("4242");
+  }
+  for (auto i= words.begin(); i != words.end(); ++i) {
+    argv.push_back(&(*i)[0]);
+  }
+  argv.push_back(nullptr);
+
+  opterr= 0;
+  for (auto _ : state) {
+    // Zero makes getopt_long() reinitialize itself
+    optind= 0;
+    int c;
+    while ((c= getopt_long((int)words.size(), argv.data(), "", options.data(),
+			   nullptr)) != -1) {
+      if (c >= 256) {
+	values[c - 256]= atoi(optarg);
+      }
+    }
+  }
+  benchmark::DoNotOptimize(values.data());
+  state.SetItemsProcessed(state.iterations() * NUM_GIVEN);
+}
+BENCHMARK(BM_GetoptLong)->RangeMultiplier(10)->Range(10, 10000);
@@ -0,0 +1,339 @@
+/** @file SimpleCmdLineArgsBench.cpp
+ *
+ *  Benchmarks for pistis::arg_parser::SimpleCmdLineArgs: dispatch to
+ *  handlers, ArgFormatter conversions, splitAndApply() and error paths.
+ */
+
+#include <pistis/arg_parser/IllegalValueError.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <benchmark/benchmark.h>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  // Number of options given on each benchmarked command line
+  const size_t NUM_GIVEN= 64;
+
+  class BenchArgs : public SimpleCmdLineArgs {
+  public:
+    template <typename Value>
+    using Formatter= SimpleCmdLineArgs::ArgFormatter<Value>;
+
+    using SimpleCmdLineArgs::splitAndApply;
+
+  public:
+    BenchArgs(size_t numOptions): SimpleCmdLineArgs(), values_(numOptions) {
+      for (size_t i= 0; i < numOptions; ++i) {
+	registerNamedArgInRange_(optionName(i), "option", false, 0, 1000000,
+				 values_[i]);
+      }
+    }
+
+    static std::string optionName(size_t i) {
+      return "--option-" + std::to_string(i);
+    }
+
+  private:
+    std::vector<int> values_;
+  };
+
+  class ListArgs : public SimpleCmdLineArgs {
+  public:
+    ListArgs(bool preScan): SimpleCmdLineArgs(), ids_(), inputs_() {
+      setPreScan(preScan);
+      registerNamedArg_("--id", "ids", false, ",", false, ids_);
+      registerNamedArg_("--input", "inputs", false, inputs_);
+    }
+
+  protected:
+    virtual void initValues_() {
+      ids_= std::vector<int>();
+      inputs_= std::vector<std::string>();
+    }
+
+  private:
+    std::vector<int> ids_;
+    std::vector<std::string> inputs_;
+  };
+
+  class WeightArgs : public SimpleCmdLineArgs {
+  public:
+    WeightArgs(): SimpleCmdLineArgs(), weights_(), lazyWeights_() {
+      registerNamedArg_("--weights", "weights", false, ",", false,
+			weights_);
+      registerNamedArg_("--lazy-weights", "weights", false, ",", false,
+			lazyWeights_);
+    }
+
+  protected:
+    virtual void initValues_() { weights_.clear(); }
+
+  private:
+    std::vector<double> weights_;
+    Lazy< std::vector<double> > lazyWeights_;
+  };
+
+  class DefineArgs : public SimpleCmdLineArgs {
+  public:
+    DefineArgs(): SimpleCmdLineArgs(), defines_() {
+      registerNamedArg_("--define", "definitions", false, ",",
+			DuplicateKeyPolicy::KEEP_LAST, defines_);
+    }
+
+  protected:
+    virtual void initValues_() { defines_.clear(); }
+
+  private:
+    std::unordered_map<std::string, double> defines_;
+  };
+
+  class CommandLine {
+  public:
+    CommandLine(size_t numOptions, const std::string& value):
+        words_(), argv_() {
+      words_.push_back("app");
+      for (size_t i= 0; i < NUM_GIVEN; ++i) {
+	words_.push_back(BenchArgs::optionName((i * 7919) % numOptions));
+	words_.push_back(value);
+      }
+      for (auto i= words_.begin(); i != words_.end(); ++i) {
+	argv_.push_back(&(*i)[0]);
+      }
+      argv_.push_back(nullptr);
+    }
+
+    CommandLine(const std::vector<std::string>& words):
+        words_(words), argv_() {
+      for (auto i= words_.begin(); i != words_.end(); ++i) {
+	argv_.push_back(&(*i)[0]);
+      }
+      argv_.push_back(nullptr);
+    }
+
+    int argc() const { return (int)words_.size(); }
+    char** argv() { return argv_.data(); }
+
+  private:
+    std::vector<std::string> words_;
+    std::vector<char*> argv_;
+  };
+}
+
+static void BM_Dispatch(benchmark::State& state) {
+  const size_t numOptions= state.range(0);
+  BenchArgs args(numOptions);
+  CommandLine cmdLine(numOptions, "4242");
+
+  for (auto _ : state) {
+    args.parse(cmdLine.argc(), cmdLine.argv());
+  }
+  state.SetItemsProcessed(state.iterations() * NUM_GIVEN);
+}
+BENCHMARK(BM_Dispatch)->RangeMultiplier(10)->Range(10, 10000);
+
+static void BM_RegisterOptions(benchmark::State& state) {
+  const size_t numOptions= state.range(0);
+  for (auto _ : state) {
+    BenchArgs args(numOptions);
+    benchmark::DoNotOptimize(&args);
+  }
+  state.SetItemsProcessed(state.iterations() * numOptions);
+}
+BENCHMARK(BM_RegisterOptions)->RangeMultiplier(10)->Range(10, 10000);
+
+static void BM_FormatInt(benchmark::State& state) {
+  const std::string value("123456789");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(BenchArgs::Formatter<int>::format(value));
+  }
+}
+BENCHMARK(BM_FormatInt);
+
+static void BM_FormatIntInRange(benchmark::State& state) {
+  const std::string value("123456");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+	BenchArgs::Formatter<int>::format(value, 0, 1000000)
+    );
+  }
+}
+BENCHMARK(BM_FormatIntInRange);
+
+static void BM_FormatIntInSet(benchmark::State& state) {
+  const std::string value("42");
+  const std::unordered_set<int> legalValues({ 1, 2, 3, 5, 8, 13, 21, 42 });
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+	BenchArgs::Formatter<int>::format(value, legalValues)
+    );
+  }
+}
+BENCHMARK(BM_FormatIntInSet);
+
+static void BM_FormatDouble(benchmark::State& state) {
+  const std::string value("12345.6789");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(BenchArgs::Formatter<double>::format(value));
+  }
+}
+BENCHMARK(BM_FormatDouble);
+
+static void BM_FormatString(benchmark::State& state) {
+  const std::string value("some-string-value");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+	BenchArgs::Formatter<std::string>::format(value)
+    );
+  }
+}
+BENCHMARK(BM_FormatString);
+
+static void BM_SplitAndApply(benchmark::State& state) {
+  const size_t numItems= state.range(0);
+  std::string list;
+  for (size_t i= 0; i < numItems; ++i) {
+    if (i) {
+      list.push_back(',');
+    }
+    list += std::to_string(i % 1000);
+  }
+
+  for (auto _ : state) {
+    int64_t total= 0;
+    BenchArgs::splitAndApply(list, ",", false,
+			     [&total](const std::string& item) {
+      total += BenchArgs::Formatter<int>::format(item);
+    });
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * numItems);
+  state.SetBytesProcessed(state.iterations() * list.size());
+}
+BENCHMARK(BM_SplitAndApply)->RangeMultiplier(32)->Range(1, 1 << 20);
+
+// Half of the items are in one --id list, the other half are separate
+// --input options.  The argument is whether to pre-scan.
+static void BM_ParseLongLists(benchmark::State& state) {
+  const size_t numItems= 1 << 16;
+  std::vector<std::string> words({ "app", "--id", "" });
+  for (size_t i= 0; i < numItems / 2; ++i) {
+    if (i) {
+      words[2].push_back(',');
+    }
+    words[2] += std::to_string(i);
+    words.push_back("--input");
+    words.push_back("input-file-" + std::to_string(i));
+  }
+  CommandLine cmdLine(words);
+  ListArgs args(state.range(0) != 0);
+
+  for (auto _ : state) {
+    args.parse(cmdLine.argc(), cmdLine.argv());
+  }
+  state.SetItemsProcessed(state.iterations() * numItems);
+}
+BENCHMARK(BM_ParseLongLists)->Arg(0)->Arg(1);
+
+// Hyper-parameter overrides, either all in one --define list (argument
+// 1) or each in its own --define option (argument 0)
+static void BM_ParseDefines(benchmark::State& state) {
+  const size_t numPairs= 4096;
+  std::vector<std::string> words({ "app" });
+  for (size_t i= 0; i < numPairs; ++i) {
+    const std::string pair=
+        "layer" + std::to_string(i) + ".learning_rate=0.0" +
+        std::to_string(i % 100);
+    if (!state.range(0) || (words.size() == 1)) {
+      words.push_back("--define");
+      words.push_back(pair);
+    } else {
+      words.back() += "," + pair;
+    }
+  }
+  CommandLine cmdLine(words);
+  DefineArgs args;
+
+  for (auto _ : state) {
+    args.parse(cmdLine.argc(), cmdLine.argv());
+  }
+  state.SetItemsProcessed(state.iterations() * numPairs);
+}
+BENCHMARK(BM_ParseDefines)->Arg(0)->Arg(1);
+
+// Parsing a list of 64K doubles converted while parsing (argument 0)
+// or left for a Lazy destination to convert on use (argument 1)
+static void BM_ParseLazyList(benchmark::State& state) {
+  const size_t numItems= 1 << 16;
+  std::vector<std::string> words({ "app", "--weights", "" });
+  if (state.range(0)) {
+    words[1]= "--lazy-weights";
+  }
+  for (size_t i= 0; i < numItems; ++i) {
+    if (i) {
+      words[2].push_back(',');
+    }
+    words[2] += std::to_string(i * 0.25);
+  }
+  CommandLine cmdLine(words);
+  WeightArgs args;
+
+  for (auto _ : state) {
+    args.parse(cmdLine.argc(), cmdLine.argv());
+  }
+}
+BENCHMARK(BM_ParseLazyList)->Arg(0)->Arg(1);
+
+// Parsing a list of 1M doubles on one thread (argument 0) or on four
+// threads (argument 4)
+static void BM_ParseParallelList(benchmark::State& state) {
+  const size_t numItems= 1 << 20;
+  std::vector<std::string> words({ "app", "--weights", "" });
+  for (size_t i= 0; i < numItems; ++i) {
+    if (i) {
+      words[2].push_back(',');
+    }
+    words[2] += std::to_string(i * 0.25);
+  }
+  CommandLine cmdLine(words);
+  WeightArgs args;
+
+  if (state.range(0)) {
+    args.setParallelConversion(1 << 16, state.range(0));
+  }
+  for (auto _ : state) {
+    args.parse(cmdLine.argc(), cmdLine.argv());
+  }
+}
+BENCHMARK(BM_ParseParallelList)->Arg(0)->Arg(4)->UseRealTime();
+
+static void BM_InvalidValueError(benchmark::State& state) {
+  BenchArgs args(100);
+  CommandLine cmdLine(100, "not-a-number");
+
+  for (auto _ : state) {
+    try {
+      args.parse(cmdLine.argc(), cmdLine.argv());
+    } catch(const IllegalValueError& e) {
+      benchmark::DoNotOptimize(e.what());
+    }
+  }
+}
+BENCHMARK(BM_InvalidValueError);
+
+static void BM_OutOfRangeError(benchmark::State& state) {
+  BenchArgs args(100);
+  CommandLine cmdLine(100, "2000000");
+
+  for (auto _ : state) {
+    try {
+      args.parse(cmdLine.argc(), cmdLine.argv());
+    } catch(const IllegalValueError& e) {
+      benchmark::DoNotOptimize(e.what());
+    }
+  }
+}
+BENCHMARK(BM_OutOfRangeError);
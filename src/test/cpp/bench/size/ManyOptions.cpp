@@ -0,0 +1,94 @@
+/** @file ManyOptions.cpp
+ *
+ *  A translation unit that registers many options of common kinds, like
+ *  the argument classes of a typical tool.  "make bench-size" reports the
+ *  size of its object file and how long it takes to compile, to track
+ *  how much code SimpleCmdLineArgs.hpp generates in the programs that
+ *  use it.  It is never linked.
+ */
+
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  class ManyOptions : public SimpleCmdLineArgs {
+  public:
+    ManyOptions();
+
+  private:
+    int threads_;
+    int port_;
+    int retries_;
+    int level_;
+    int mode_;
+    double timeout_;
+    double ratio_;
+    double weight_;
+    std::string host_;
+    std::string user_;
+    std::string format_;
+    std::string output_;
+    std::vector<int> ids_;
+    std::vector<int> shards_;
+    std::vector<int> levels_;
+    std::vector<double> weights_;
+    std::vector<double> thresholds_;
+    std::vector<std::string> includes_;
+    std::vector<std::string> excludes_;
+    std::vector<std::string> tags_;
+    std::vector<std::string> files_;
+    std::unordered_set<int> ports_;
+    std::unordered_set<std::string> features_;
+    std::unordered_set<std::string> regions_;
+  };
+
+  ManyOptions::ManyOptions():
+      SimpleCmdLineArgs(), threads_(1), port_(80), retries_(3), level_(0),
+      mode_(0), timeout_(1.0), ratio_(0.5), weight_(1.0), host_(), user_(),
+      format_(), output_(), ids_(), shards_(), levels_(), weights_(),
+      thresholds_(), includes_(), excludes_(), tags_(), files_(), ports_(),
+      features_(), regions_() {
+    ValueMap<int> modes;
+    modes.setValue("fast", 0);
+    modes.setValue("safe", 1);
+
+    registerNamedArg_("--threads", "threads", false, threads_);
+    registerNamedArgInRange_("--port", "port", false, 1, 65535, port_);
+    registerNamedArgInRange_("--retries", "retries", false, 0, 10, retries_);
+    registerNamedArgInSet_("--level", "level", false,
+			   std::unordered_set<int>({ 0, 1, 2 }), level_);
+    registerNamedArg_("--mode", "mode", false, modes, mode_);
+    registerNamedArg_("--timeout", "timeout", false, timeout_);
+    registerNamedArgInRange_("--ratio", "ratio", false, 0.0, 1.0, ratio_);
+    registerNamedArg_("--weight", "weight", false, weight_);
+    registerNamedArg_("--host", "host", false, host_);
+    registerNamedArg_("--user", "user", false, user_);
+    registerNamedArgInSet_("--format", "format", false,
+			   std::unordered_set<std::string>({ "json", "csv" }),
+			   format_);
+    registerNamedArg_("--output", "output", false, output_);
+    registerNamedArg_("--ids", "ids", false, ",", false, ids_);
+    registerNamedArg_("--shard", "shards", false, shards_);
+    registerNamedArgInRange_("--levels", "levels", false, ",", false, 0, 9,
+			     levels_);
+    registerNamedArg_("--weights", "weights", false, ",", false, weights_);
+    registerNamedArg_("--threshold", "thresholds", false, thresholds_);
+    registerNamedArg_("--include", "includes", false, includes_);
+    registerNamedArg_("--exclude", "excludes", false, ",", true, excludes_);
+    registerNamedArg_("--tag", "tags", false, tags_);
+    registerNamedArg_("--ports", "ports", false, ",", false, ports_);
+    registerNamedArg_("--feature", "features", false, features_);
+    registerNamedArgInSet_("--region", "regions", false,
+			   std::unordered_set<std::string>({ "us", "eu" }),
+			   regions_);
+    registerUnnamedArg_("files", false, files_);
+  }
+}
+
+SimpleCmdLineArgs* createManyOptions() {
+  return new ManyOptions();
+}
@@ -0,0 +1,169 @@
+/** @file ArgConversionTest.cpp
+ *
+ *  Unit tests for converting values of user-defined types with
+ *  pistis::arg_parser::ArgConversion.
+ */
+
+#include <pistis/arg_parser/ArgConversion.hpp>
+#include <pistis/arg_parser/CmdLineSchema.hpp>
+#include <pistis/arg_parser/IllegalValueError.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  struct Counts {
+    int constructed;
+    int copied;
+    int moved;
+  };
+
+  Counts counts;
+
+  struct Shard {
+    std::string host;
+    int port;
+
+    Shard(): host(), port(0) { }
+    Shard(const std::string& host, int port): host(host), port(port) {
+      ++counts.constructed;
+    }
+    Shard(const Shard& other): host(other.host), port(other.port) {
+      ++counts.copied;
+    }
+    Shard(Shard&& other): host(std::move(other.host)), port(other.port) {
+      ++counts.moved;
+    }
+    Shard& operator=(const Shard& other) = default;
+    Shard& operator=(Shard&& other) = default;
+
+    bool operator==(const Shard& other) const {
+      return (host == other.host) && (port == other.port);
+    }
+  };
+
+  struct ShardHash {
+    size_t operator()(const Shard& s) const {
+      return std::hash<std::string>()(s.host) ^ s.port;
+    }
+  };
+
+  struct Deployment {
+    Shard primary;
+    std::vector<Shard> replicas;
+  };
+}
+
+namespace pistis {
+  namespace arg_parser {
+    template <>
+    struct ArgConversion<Shard> {
+      template <typename Emplace>
+      static void convert(const char* begin, const char* end,
+			  const Emplace& emplace) {
+	const char* colon= std::find(begin, end, ':');
+	if (colon == end) {
+	  throw std::invalid_argument("Shard must be host:port");
+	}
+	emplace(std::string(begin, colon),
+		std::stoi(std::string(colon + 1, end)));
+      }
+    };
+  }
+}
+
+namespace {
+  class ShardArgs : public SimpleCmdLineArgs {
+  public:
+    ShardArgs(): SimpleCmdLineArgs(), primary_(), shards_(), backups_() {
+      setPreScan(true);
+      registerNamedArg_("--primary", "primary shard", false, primary_);
+      registerNamedArg_("--shards", "shards", false, ",", false, shards_);
+      registerNamedArg_("--backup", "backup shard", false, backups_);
+    }
+
+    const Shard& primary() const { return primary_; }
+    const std::vector<Shard>& shards() const { return shards_; }
+    const std::unordered_set<Shard, ShardHash>& backups() const {
+      return backups_;
+    }
+
+  protected:
+    virtual void initValues_() {
+      shards_.clear();
+      backups_.clear();
+    }
+
+  private:
+    Shard primary_;
+    std::vector<Shard> shards_;
+    std::unordered_set<Shard, ShardHash> backups_;
+  };
+
+  class DeploymentSchema : public CmdLineSchema<Deployment> {
+  public:
+    DeploymentSchema(): CmdLineSchema<Deployment>() {
+      registerNamedArg_("--primary", "primary shard", false,
+			&Deployment::primary);
+      registerUnnamedArg_("replicas", false, &Deployment::replicas);
+    }
+  };
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(ArgConversionTests, ConvertInPlace) {
+  const char* ARGV[] = { "app", "--shards", "a:1,b:2,c:3", "--primary",
+			 "p:80", "--backup", "x:7", "--backup", "y:8",
+			 "--shards", "d:4", nullptr };
+  ShardArgs args;
+
+  counts= Counts{ 0, 0, 0 };
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.primary(), Shard("p", 80));
+  EXPECT_EQ(args.shards(),
+	    std::vector<Shard>({ Shard("a", 1), Shard("b", 2), Shard("c", 3),
+				 Shard("d", 4) }));
+  EXPECT_EQ(args.backups().size(), 2);
+  EXPECT_EQ(args.backups().count(Shard("y", 8)), 1);
+
+  // The primary is constructed, then assigned.  Every shard in a
+  // container is constructed once, in the container.
+  counts= Counts{ 0, 0, 0 };
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(counts.constructed, 7);
+  EXPECT_EQ(counts.copied, 0);
+  EXPECT_EQ(counts.moved, 0);
+}
+
+TEST(ArgConversionTests, ConversionErrors) {
+  const char* ARGV[] = { "app", "--shards", "a:1,b", nullptr };
+  ShardArgs args;
+
+  try {
+    args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+    FAIL() << "IllegalValueError not thrown";
+  } catch(const IllegalValueError& e) {
+    EXPECT_NE(std::string(e.what()).find("Shard must be host:port"),
+	      std::string::npos) << e.what();
+    EXPECT_NE(std::string(e.what()).find("shards (--shards)"),
+	      std::string::npos) << e.what();
+  }
+}
+
+TEST(ArgConversionTests, Schema) {
+  const char* ARGV[] = { "app", "--primary", "p:80", "r:1", "r:2", nullptr };
+  DeploymentSchema schema;
+  Deployment deployment;
+
+  schema.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV), deployment);
+  EXPECT_EQ(deployment.primary, Shard("p", 80));
+  EXPECT_EQ(deployment.replicas,
+	    std::vector<Shard>({ Shard("r", 1), Shard("r", 2) }));
+}
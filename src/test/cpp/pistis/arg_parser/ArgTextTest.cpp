@@ -0,0 +1,93 @@
+/** @file ArgTextTest.cpp
+ *
+ *  Unit tests for pistis::arg_parser::ArgText and registering arguments
+ *  with names and descriptions in static storage.  The allocations that
+ *  registration makes are counted by alloc/ArgTextAllocationTest.cpp.
+ */
+
+#include <pistis/arg_parser/ArgText.hpp>
+#include <pistis/arg_parser/IllegalValueError.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  class StaticArgs : public SimpleCmdLineArgs {
+  public:
+    StaticArgs(): SimpleCmdLineArgs(), value_(0) {
+      registerNamedArg_(StaticText("--a-rather-long-option-name"),
+			StaticText("a description that is too long for SSO"),
+			false, value_);
+    }
+
+    int value() const { return value_; }
+
+  private:
+    int value_;
+  };
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(ArgTextTests, OwnedAndStaticText) {
+  static const char TEXT[]= "--verbose";
+  std::string s("--verbose");
+  ArgText owned(s);
+  ArgText fromStatic= StaticText(TEXT);
+  ArgText empty;
+
+  s[2]= 'x';
+  EXPECT_TRUE(owned.isOwned());
+  EXPECT_EQ(owned.str(), "--verbose");
+  EXPECT_FALSE(fromStatic.isOwned());
+  EXPECT_EQ(fromStatic.data(), TEXT);
+  EXPECT_EQ(fromStatic.size(), 9);
+  EXPECT_EQ(owned, fromStatic);
+  EXPECT_NE(owned, ArgText::view(s));
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.c_str()[0], '\0');
+
+  // Arrays larger than their text have the size of the text, and arrays
+  // that may be changed are not static text
+  static const char PADDED[32]= "--name";
+  EXPECT_EQ(StaticText(PADDED).size(), 6);
+  EXPECT_EQ(ArgText(StaticText(PADDED)).str(), "--name");
+  EXPECT_FALSE((std::is_constructible<StaticText, char (&)[32]>::value));
+
+  // Copies of owned text keep their own copy
+  ArgText copy(owned);
+  owned= ArgText("--quiet");
+  EXPECT_EQ(copy.str(), "--verbose");
+  EXPECT_EQ(owned.str(), "--quiet");
+  EXPECT_EQ(copy.c_str()[copy.size()], '\0');
+
+  std::ostringstream out;
+  out << fromStatic << "|" << owned;
+  EXPECT_EQ(out.str(), "--verbose|--quiet");
+  EXPECT_EQ(SeededHash<ArgText>()(copy),
+	    SeededHash<ArgText>()(ArgText::view(std::string("--verbose"))));
+}
+
+TEST(ArgTextTests, ParseWithStaticText) {
+  const char* ARGV[] = { "app", "--a-rather-long-option-name", "12",
+			 nullptr };
+  const char* BAD[] = { "app", "--a-rather-long-option-name", "x", nullptr };
+  StaticArgs args;
+
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.value(), 12);
+
+  try {
+    args.parse(ARGC_FOR(BAD), const_cast<char**>(BAD));
+    FAIL() << "IllegalValueError not thrown";
+  } catch(const IllegalValueError& e) {
+    EXPECT_NE(std::string(e.what()).find(
+		  "a description that is too long for SSO "
+		  "(--a-rather-long-option-name)"),
+	      std::string::npos) << e.what();
+  }
+}
@@ -0,0 +1,114 @@
+/** @file BatchCmdLineParserTest.cpp
+ *
+ *  Unit tests for pistis::arg_parser::BatchCmdLineParser and
+ *  pistis::arg_parser::CmdLineTokenizer.
+ */
+
+#include <pistis/arg_parser/BatchCmdLineParser.hpp>
+#include <pistis/arg_parser/CmdLineSchema.hpp>
+#include <pistis/exceptions/IllegalValueError.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  struct Job {
+    int priority;
+    std::string queue;
+    std::vector<std::string> inputs;
+
+    Job(): priority(0), queue(), inputs() { }
+  };
+
+  class JobSchema : public CmdLineSchema<Job> {
+  public:
+    JobSchema() {
+      registerNamedArgInRange_("-p", "priority", true, 0, 10,
+			       &Job::priority);
+      registerNamedArg_("-q", "queue", false, &Job::queue);
+      registerUnnamedArg_("inputs", false, &Job::inputs);
+    }
+  };
+
+  std::vector<std::string> tokens(const std::string& line) {
+    CmdLineTokenizer tokenizer;
+    int n= tokenizer.tokenize(line);
+    return std::vector<std::string>(tokenizer.argv(), tokenizer.argv() + n);
+  }
+}
+
+TEST(CmdLineTokenizerTests, Tokenize) {
+  CmdLineTokenizer tokenizer;
+
+  EXPECT_EQ(tokenizer.tokenize("   "), 0);
+  EXPECT_EQ(tokenizer.argv()[0], nullptr);
+
+  EXPECT_EQ(tokenizer.tokenize(" run  -p 5\tfile.txt "), 4);
+  EXPECT_EQ(tokenizer.argv()[4], nullptr);
+  EXPECT_EQ(tokens(" run  -p 5\tfile.txt "),
+	    std::vector<std::string>({ "run", "-p", "5", "file.txt" }));
+  EXPECT_EQ(tokens("run 'a b' \"c \\\"d\\\"\" e\\ f g''h"),
+	    std::vector<std::string>({ "run", "a b", "c \"d\"", "e f",
+		                       "gh" }));
+  EXPECT_THROW(tokenizer.tokenize("run 'abc"),
+	       pistis::exceptions::IllegalValueError);
+  EXPECT_THROW(tokenizer.tokenize("run \"abc"),
+	       pistis::exceptions::IllegalValueError);
+}
+
+TEST(BatchCmdLineParserTests, ParseLines) {
+  const size_t NUM_LINES= 5000;
+  std::vector<std::string> lines;
+
+  for (size_t i= 0; i < NUM_LINES; ++i) {
+    std::ostringstream line;
+    if ((i % 7) == 3) {
+      line << "job -q q" << i << " in" << i;    // Missing required -p
+    } else if ((i % 11) == 5) {
+      line << "job -p 99";                       // Out of range
+    } else {
+      line << "job -p " << (i % 10) << " -q q" << i << " in" << i
+	   << " 'other " << i << "'";
+    }
+    lines.push_back(line.str());
+  }
+  lines.push_back("");
+
+  BatchCmdLineParser<JobSchema> parser(4, 16);
+  std::vector<BatchParseResult<Job>> results= parser.parse(lines);
+
+  ASSERT_EQ(results.size(), lines.size());
+  for (size_t i= 0; i < NUM_LINES; ++i) {
+    const BatchParseResult<Job>& r= results[i];
+    if (((i % 7) == 3) || ((i % 11) == 5)) {
+      EXPECT_FALSE(r.ok()) << "Line " << i;
+      EXPECT_FALSE(r.error().empty()) << "Line " << i;
+    } else {
+      ASSERT_TRUE(r.ok()) << "Line " << i << ": " << r.error();
+      EXPECT_EQ(r.value().priority, (int)(i % 10));
+      EXPECT_EQ(r.value().queue, "q" + std::to_string(i));
+      EXPECT_EQ(r.value().inputs,
+		std::vector<std::string>({ "in" + std::to_string(i),
+		                           "other " + std::to_string(i) }));
+    }
+  }
+  EXPECT_FALSE(results.back().ok());
+}
+
+TEST(BatchCmdLineParserTests, ParseStream) {
+  std::istringstream input("job -p 1 a\njob -p x\njob -p 2 b c\n");
+  BatchCmdLineParser<JobSchema> parser(2, 1);
+  std::vector<BatchParseResult<Job>> results= parser.parse(input);
+
+  ASSERT_EQ(results.size(), 3);
+  EXPECT_TRUE(results[0].ok());
+  EXPECT_EQ(results[0].value().inputs, std::vector<std::string>({ "a" }));
+  EXPECT_FALSE(results[1].ok());
+  EXPECT_TRUE(results[2].ok());
+  EXPECT_EQ(results[2].value().priority, 2);
+  EXPECT_EQ(results[2].value().inputs,
+	    std::vector<std::string>({ "b", "c" }));
+}
@@ -0,0 +1,127 @@
+/** @file CmdLineSchemaTest.cpp
+ *
+ *  Unit tests for pistis::arg_parser::CmdLineSchema.
+ */
+
+#include <pistis/arg_parser/CmdLineSchema.hpp>
+#include <pistis/arg_parser/IllegalValueError.hpp>
+#include <pistis/arg_parser/RequiredCmdLineArgMissingError.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  enum class Color { NONE, RED, GREEN, BLUE };
+
+  struct JobSpec {
+    int threads;
+    double ratio;
+    std::string name;
+    Color color;
+    std::vector<int> ids;
+    std::unordered_set<std::string> tags;
+    std::vector<std::string> inputs;
+
+    JobSpec(): threads(0), ratio(0.0), name(), color(Color::NONE), ids(),
+	       tags(), inputs() {
+    }
+  };
+
+  class JobSpecSchema : public CmdLineSchema<JobSpec> {
+  public:
+    JobSpecSchema(): CmdLineSchema<JobSpec>(), checkCount_(0) {
+      ValueMap<Color> colors;
+      colors.setValue("red", Color::RED);
+      colors.setValue("green", Color::GREEN);
+      colors.setValue("blue", Color::BLUE);
+
+      registerNamedArgInRange_("-t", "thread count", true, 1, 64,
+			       &JobSpec::threads);
+      registerNamedArg_("-r", "ratio", false, &JobSpec::ratio);
+      registerNamedArg_("-n", "job name", false, &JobSpec::name);
+      registerNamedArg_("-c", "color", false, colors, &JobSpec::color);
+      registerNamedArg_("-i", "ids", false, ",", false, &JobSpec::ids);
+      registerNamedArg_("-g", "tag", false, &JobSpec::tags);
+      registerUnnamedArg_("input files", false, &JobSpec::inputs);
+    }
+
+    int checkCount() const { return checkCount_; }
+
+  protected:
+    virtual void checkValues_() {
+      ++checkCount_;
+      if (currentTarget().name == "bad") {
+	throw IllegalValueError("", "-n", "bad", "Name is reserved");
+      }
+    }
+
+  private:
+    int checkCount_;
+  };
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(CmdLineSchemaTests, ParseIntoTargets) {
+  const char* FIRST[] = {
+      "some_program", "-t", "4", "-r", "0.25", "-n", "first", "-c", "green",
+      "-i", "1,2,3", "-g", "a", "-g", "b", "x.txt", "y.txt", nullptr
+  };
+  const char* SECOND[] = {
+      "some_program", "-t", "8", "-i", "9", "z.txt", nullptr
+  };
+  JobSpecSchema schema;
+  JobSpec first;
+  JobSpec second;
+
+  schema.parse(ARGC_FOR(FIRST), const_cast<char**>(FIRST), first);
+  schema.parse(ARGC_FOR(SECOND), const_cast<char**>(SECOND), second);
+
+  EXPECT_EQ(first.threads, 4);
+  EXPECT_NEAR(first.ratio, 0.25, 1e-10);
+  EXPECT_EQ(first.name, "first");
+  EXPECT_EQ(first.color, Color::GREEN);
+  EXPECT_EQ(first.ids, std::vector<int>({ 1, 2, 3 }));
+  EXPECT_EQ(first.tags, std::unordered_set<std::string>({ "a", "b" }));
+  EXPECT_EQ(first.inputs, std::vector<std::string>({ "x.txt", "y.txt" }));
+
+  EXPECT_EQ(second.threads, 8);
+  EXPECT_NEAR(second.ratio, 0.0, 1e-10);
+  EXPECT_EQ(second.name, "");
+  EXPECT_EQ(second.color, Color::NONE);
+  EXPECT_EQ(second.ids, std::vector<int>({ 9 }));
+  EXPECT_TRUE(second.tags.empty());
+  EXPECT_EQ(second.inputs, std::vector<std::string>({ "z.txt" }));
+  EXPECT_EQ(schema.checkCount(), 2);
+}
+
+TEST(CmdLineSchemaTests, ParseErrors) {
+  const char* MISSING_REQUIRED[] = { "some_program", "-r", "1.5", nullptr };
+  const char* OUT_OF_RANGE[] = { "some_program", "-t", "65", nullptr };
+  const char* BAD_COLOR[] =
+      { "some_program", "-t", "1", "-c", "purple", nullptr };
+  const char* BAD_ID[] = { "some_program", "-t", "1", "-i", "1,x", nullptr };
+  const char* CHECK_FAILS[] =
+      { "some_program", "-t", "1", "-n", "bad", nullptr };
+  JobSpecSchema schema;
+  JobSpec target;
+
+  EXPECT_THROW(schema.parse(ARGC_FOR(MISSING_REQUIRED),
+			    const_cast<char**>(MISSING_REQUIRED), target),
+	       RequiredCmdLineArgMissingError);
+  EXPECT_THROW(schema.parse(ARGC_FOR(OUT_OF_RANGE),
+			    const_cast<char**>(OUT_OF_RANGE), target),
+	       IllegalValueError);
+  EXPECT_THROW(schema.parse(ARGC_FOR(BAD_COLOR),
+			    const_cast<char**>(BAD_COLOR), target),
+	       IllegalValueError);
+  EXPECT_THROW(schema.parse(ARGC_FOR(BAD_ID),
+			    const_cast<char**>(BAD_ID), target),
+	       IllegalValueError);
+  EXPECT_THROW(schema.parse(ARGC_FOR(CHECK_FAILS),
+			    const_cast<char**>(CHECK_FAILS), target),
+	       IllegalValueError);
+}
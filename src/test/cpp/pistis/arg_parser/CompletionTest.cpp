@@ -0,0 +1,145 @@
+/** @file CompletionTest.cpp
+ *
+ *  Unit tests for pistis::arg_parser::CompletionTrie and shell completion
+ *  in pistis::arg_parser::SimpleCmdLineArgs.
+ */
+
+#include <pistis/arg_parser/CompletionTrie.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  class DeployArgs : public SimpleCmdLineArgs {
+  public:
+    DeployArgs(): SimpleCmdLineArgs(), region_(), replicas_(0), format_(),
+		  mode_(), targets_() {
+      ValueMap<int> formats;
+      formats.setValue("json", 0);
+      formats.setValue("yaml", 1);
+      formats.setValue("yml", 1);
+
+      registerNamedArgInSet_("--region", "region", false,
+			     std::unordered_set<std::string>({
+				 "us-east", "us-west", "eu-central" }),
+			     region_);
+      registerNamedArgInSet_("--replicas", "replica count", false,
+			     std::unordered_set<int>({ 1, 3, 5 }),
+			     replicas_);
+      registerNamedArg_("--format", "output format", false, formats,
+			format_);
+      registerNamedArg_("--mode", "mode", false,
+			[this](CmdLineArgGenerator& args,
+			       const std::string& argName) {
+	mode_= args.nextInSet(argName, { "fast", "safe" });
+      });
+      addCompletions_("--mode", { "fast", "safe" });
+      registerUnnamedArgInSet_("targets", true,
+			       std::unordered_set<std::string>({
+				   "web", "worker", "db" }),
+			       targets_);
+    }
+
+  private:
+    std::string region_;
+    int replicas_;
+    int format_;
+    std::string mode_;
+    std::vector<std::string> targets_;
+  };
+
+  std::string completeTrie(const CompletionTrie& trie,
+			   const std::string& prefix) {
+    std::string out;
+    trie.complete(prefix, out);
+    return out;
+  }
+
+  std::string complete(const SimpleCmdLineArgs& args,
+		       const std::vector<std::string>& argv) {
+    std::vector<char*> ptrs;
+    for (auto i= argv.begin(); i != argv.end(); ++i) {
+      ptrs.push_back(const_cast<char*>(i->c_str()));
+    }
+    ptrs.push_back(nullptr);
+
+    int fds[2];
+    if (pipe(fds) < 0) {
+      return "pipe failed";
+    }
+    const bool handled= args.complete((int)argv.size(), ptrs.data(), fds[1]);
+    close(fds[1]);
+
+    std::string out;
+    char buffer[256];
+    ssize_t n;
+    while ((n= read(fds[0], buffer, sizeof(buffer))) > 0) {
+      out.append(buffer, n);
+    }
+    close(fds[0]);
+    return handled ? out : "not handled";
+  }
+}
+
+TEST(CompletionTrieTests, Complete) {
+  CompletionTrie trie;
+  std::string out;
+
+  EXPECT_TRUE(trie.empty());
+  EXPECT_EQ(trie.complete("", out), 0);
+
+  trie.insert("--verbose");
+  trie.insert("--version");
+  trie.insert("--ver");
+  trie.insert("-v");
+  trie.insert("--verbose");
+  trie.insert("");
+  EXPECT_EQ(trie.size(), 5);
+
+  EXPECT_EQ(completeTrie(trie, "--ver"), "--ver\n--verbose\n--version\n");
+  EXPECT_EQ(completeTrie(trie, "--verb"), "--verbose\n");
+  EXPECT_EQ(completeTrie(trie, "-"),
+	    "--ver\n--verbose\n--version\n-v\n");
+  EXPECT_EQ(completeTrie(trie, "--x"), "");
+  EXPECT_EQ(completeTrie(trie, "--versions"), "");
+  EXPECT_EQ(trie.complete("", out), 5);
+}
+
+TEST(SimpleCmdLineArgsCompletionTests, Complete) {
+  DeployArgs args;
+
+  EXPECT_EQ(complete(args, { "deploy", "--region", "us-east" }),
+	    "not handled");
+  EXPECT_EQ(complete(args, { "deploy", "--__complete", "1", "deploy",
+			     "--re" }),
+	    "--region\n--replicas\n");
+  EXPECT_EQ(complete(args, { "deploy", "--__complete", "1", "deploy",
+			     "--h" }),
+	    "--help\n");
+  EXPECT_EQ(complete(args, { "deploy", "--__complete", "2", "deploy",
+			     "--region", "us" }),
+	    "us-east\nus-west\n");
+  EXPECT_EQ(complete(args, { "deploy", "--__complete", "2", "deploy",
+			     "--replicas" }),
+	    "1\n3\n5\n");
+  EXPECT_EQ(complete(args, { "deploy", "--__complete", "2", "deploy",
+			     "--format", "y" }),
+	    "yaml\nyml\n");
+  EXPECT_EQ(complete(args, { "deploy", "--__complete", "4", "deploy",
+			     "--format", "json", "--mode", "" }),
+	    "fast\nsafe\n");
+
+  // Values of named arguments are skipped when finding the unnamed
+  // argument a word belongs to
+  EXPECT_EQ(complete(args, { "deploy", "--__complete", "4", "deploy",
+			     "--region", "w", "web", "w" }),
+	    "web\nworker\n");
+
+  EXPECT_EQ(complete(args, { "deploy", "--__complete", "9", "deploy" }), "");
+  EXPECT_EQ(complete(args, { "deploy", "--__complete", "x", "deploy" }), "");
+}
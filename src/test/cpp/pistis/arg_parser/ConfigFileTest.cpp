@@ -0,0 +1,294 @@
+/** @file ConfigFileTest.cpp
+ *
+ *  Unit tests for pistis::arg_parser::ConfigFileReader and configuration
+ *  files in pistis::arg_parser::SimpleCmdLineArgs.
+ */
+
+#include <pistis/arg_parser/ConfigFileError.hpp>
+#include <pistis/arg_parser/ConfigFileReader.hpp>
+#include <pistis/arg_parser/ConfigImage.hpp>
+#include <pistis/arg_parser/IllegalValueError.hpp>
+#include <pistis/arg_parser/MappedFile.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include "TempFile.hpp"
+#include <pistis/exceptions/IllegalValueError.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace pistis::arg_parser;
+using pistis::arg_parser::test::TempFile;
+
+namespace {
+  struct Entry {
+    std::string section;
+    std::string key;
+    std::string value;
+    size_t line;
+
+    bool operator==(const Entry& other) const {
+      return (section == other.section) && (key == other.key) &&
+	     (value == other.value) && (line == other.line);
+    }
+  };
+
+  std::ostream& operator<<(std::ostream& out, const Entry& e) {
+    return out << "[" << e.section << "] " << e.key << "=" << e.value
+	       << " (line " << e.line << ")";
+  }
+
+  std::vector<Entry> readAll(const std::string& text) {
+    std::string fileName("test.cfg");
+    ConfigFileReader reader(fileName, text.data(),
+			    text.data() + text.size());
+    ConfigEntry entry;
+    std::vector<Entry> entries;
+
+    while (reader.next(entry)) {
+      entries.push_back(Entry{
+	  std::string(entry.section, entry.sectionSize),
+	  std::string(entry.key, entry.keySize),
+	  std::string(entry.value, entry.valueSize),
+	  entry.line
+      });
+    }
+    return entries;
+  }
+
+  class ServerArgs : public SimpleCmdLineArgs {
+  public:
+    ServerArgs(): SimpleCmdLineArgs(), port_(0), host_(), logLevel_(),
+		  paths_() {
+      registerNamedArg_("--port", "port", true, port_);
+      registerNamedArg_("--host", "host", false, host_);
+      registerNamedArg_("--log.level", "log level", false, logLevel_);
+      registerNamedArg_("-p", "search path", false, paths_);
+      registerConfigFileArg_("--config", "configuration file");
+    }
+
+    using SimpleCmdLineArgs::addConfigFile_;
+
+    int port() const { return port_; }
+    const std::string& host() const { return host_; }
+    const std::string& logLevel() const { return logLevel_; }
+    const std::vector<std::string>& paths() const { return paths_; }
+
+  protected:
+    virtual void initValues_() {
+      port_= 0;
+      host_.clear();
+      logLevel_.clear();
+      paths_.clear();
+    }
+
+  private:
+    int port_;
+    std::string host_;
+    std::string logLevel_;
+    std::vector<std::string> paths_;
+  };
+
+  class ReorderedServerArgs : public SimpleCmdLineArgs {
+  public:
+    ReorderedServerArgs(): SimpleCmdLineArgs(), port_(0), host_() {
+      registerNamedArg_("--host", "host", false, host_);
+      registerNamedArg_("--port", "port", true, port_);
+    }
+
+  private:
+    int port_;
+    std::string host_;
+  };
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(ConfigFileReaderTests, ReadEntries) {
+  const std::string TEXT=
+      "# A comment\n"
+      "  port = 80  \n"
+      "\n"
+      "; Another comment\n"
+      "[ log ]\r\n"
+      "level=\"debug \"\n"
+      "empty =\n"
+      "[net]\n"
+      "host = example.com";
+
+  EXPECT_EQ(readAll(TEXT), std::vector<Entry>({
+	Entry{ "", "port", "80", 2 },
+	Entry{ "log", "level", "debug ", 6 },
+	Entry{ "log", "empty", "", 7 },
+	Entry{ "net", "host", "example.com", 9 }
+  }));
+  EXPECT_TRUE(readAll("").empty());
+
+  try {
+    readAll("a = 1\nb\n");
+    FAIL() << "ConfigFileError not thrown";
+  } catch(const ConfigFileError& e) {
+    EXPECT_EQ(e.fileName(), "test.cfg");
+    EXPECT_EQ(e.line(), 2);
+  }
+  EXPECT_THROW(readAll("[section\n"), ConfigFileError);
+  EXPECT_THROW(readAll(" = 1\n"), ConfigFileError);
+
+  // The reader keeps its own copy of the file name
+  const std::string text("a = 1\n");
+  const std::string base("defaults");
+  ConfigFileReader reader(base + ".cfg", text.data(),
+			  text.data() + text.size());
+  EXPECT_EQ(reader.fileName(), "defaults.cfg");
+}
+
+TEST(ConfigFileReaderTests, MappedFile) {
+  TempFile file("a = 1\n");
+  MappedFile mapped(file.path());
+
+  EXPECT_EQ(std::string(mapped.begin(), mapped.end()), "a = 1\n");
+  EXPECT_GT(mapped.modificationTime(), 0);
+
+  MappedFile other(std::move(mapped));
+  EXPECT_EQ(other.size(), 6);
+  EXPECT_TRUE(mapped.empty());
+
+  // Devices and pipes have no size to map
+  EXPECT_THROW(MappedFile("/dev/null"), pistis::exceptions::IllegalValueError);
+}
+
+TEST(SimpleCmdLineArgsConfigTests, ConfigFiles) {
+  const char* NO_ARGS[] = { "server", nullptr };
+  TempFile defaults("port = 80\nhost = localhost\n[log]\nlevel = info\n"
+		    "-p = /usr/lib\n-p = /lib\n");
+  TempFile overrides("host = example.com\n");
+  ServerArgs args;
+
+  args.addConfigFile_(defaults.path(), true);
+  args.addConfigFile_("/tmp/pistis_no_such_config_file", false);
+  args.parse(ARGC_FOR(NO_ARGS), const_cast<char**>(NO_ARGS));
+  EXPECT_EQ(args.port(), 80);
+  EXPECT_EQ(args.host(), "localhost");
+  EXPECT_EQ(args.logLevel(), "info");
+  EXPECT_EQ(args.paths(), std::vector<std::string>({ "/usr/lib", "/lib" }));
+
+  // The command line overrides every file, and later files override
+  // earlier ones
+  const char* WITH_ARGS[] = { "server", "--port", "8080", "-p", "/opt",
+			      "--config", overrides.path().c_str(), nullptr };
+  args.parse(ARGC_FOR(WITH_ARGS), const_cast<char**>(WITH_ARGS));
+  EXPECT_EQ(args.port(), 8080);
+  EXPECT_EQ(args.host(), "example.com");
+  EXPECT_EQ(args.logLevel(), "info");
+  EXPECT_EQ(args.paths(), std::vector<std::string>({ "/opt" }));
+
+  // --config only applies to the parse it was given in
+  args.parse(ARGC_FOR(NO_ARGS), const_cast<char**>(NO_ARGS));
+  EXPECT_EQ(args.host(), "localhost");
+}
+
+TEST(SimpleCmdLineArgsConfigTests, ConfigFileErrors) {
+  TempFile unknown("port = 80\nthreads = 4\n");
+  TempFile badValue("port = abc\n");
+  TempFile syntax("port\n");
+  const char* UNKNOWN[] = { "server", "--config", unknown.path().c_str(),
+			    nullptr };
+  const char* BAD_VALUE[] = { "server", "--config", badValue.path().c_str(),
+			      nullptr };
+  const char* SYNTAX[] = { "server", "--config", syntax.path().c_str(),
+			   nullptr };
+  const char* MISSING[] = { "server", "--config",
+			    "/tmp/pistis_no_such_config_file", nullptr };
+  const char* NOT_A_FILE[] = { "server", "--config", "/dev/null", nullptr };
+  ServerArgs args;
+
+  try {
+    args.parse(ARGC_FOR(UNKNOWN), const_cast<char**>(UNKNOWN));
+    FAIL() << "ConfigFileError not thrown";
+  } catch(const ConfigFileError& e) {
+    EXPECT_EQ(e.fileName(), unknown.path());
+    EXPECT_EQ(e.line(), 2);
+  }
+  EXPECT_THROW(args.parse(ARGC_FOR(BAD_VALUE), const_cast<char**>(BAD_VALUE)),
+	       IllegalValueError);
+  EXPECT_THROW(args.parse(ARGC_FOR(SYNTAX), const_cast<char**>(SYNTAX)),
+	       ConfigFileError);
+  EXPECT_THROW(args.parse(ARGC_FOR(MISSING), const_cast<char**>(MISSING)),
+	       ConfigFileError);
+  EXPECT_THROW(args.parse(ARGC_FOR(NOT_A_FILE),
+			  const_cast<char**>(NOT_A_FILE)),
+	       ConfigFileError);
+}
+
+TEST(ConfigImageTests, WriteAndLoad) {
+  TempFile imageFile("");
+  ConfigImageWriter writer;
+  ConfigImage image;
+
+  writer.add(1, 3, "abc", 3);
+  writer.add(0, 7, "", 0);
+  writer.write(imageFile.path(), 1234, 100, 5678);
+
+  EXPECT_FALSE(image.load(imageFile.path(), 1235, 2, 100, 5678));
+  EXPECT_FALSE(image.load(imageFile.path(), 1234, 2, 101, 5678));
+  EXPECT_FALSE(image.load(imageFile.path(), 1234, 2, 100, 5679));
+  EXPECT_FALSE(image.load(imageFile.path(), 1234, 1, 100, 5678));
+  EXPECT_FALSE(image.load("/tmp/pistis_no_such_image", 1234, 2, 100, 5678));
+  EXPECT_EQ(image.size(), 0);
+
+  ASSERT_TRUE(image.load(imageFile.path(), 1234, 2, 100, 5678));
+  ASSERT_EQ(image.size(), 2);
+  EXPECT_EQ(image.begin()[0].handler, 1);
+  EXPECT_EQ(image.begin()[0].line, 3);
+  EXPECT_EQ(std::string(image.value(image.begin()[0])), "abc");
+  EXPECT_EQ(image.begin()[1].handler, 0);
+  EXPECT_EQ(image.begin()[1].line, 7);
+  EXPECT_EQ(std::string(image.value(image.begin()[1])), "");
+
+  imageFile.rewrite("not an image");
+  EXPECT_FALSE(image.load(imageFile.path(), 1234, 2, 100, 5678));
+}
+
+TEST(SimpleCmdLineArgsConfigTests, CompiledConfigFiles) {
+  const char* NO_ARGS[] = { "server", nullptr };
+  TempFile config("port = 80\n[log]\nlevel = info\n-p = /a\n-p = /b\n");
+  TempFile imageFile("");
+  ServerArgs args;
+
+  unlink(imageFile.path().c_str());
+  args.addConfigFile_(config.path(), true, imageFile.path());
+
+  // The first parse reads the text and writes the image, and the
+  // second replays the image
+  for (int i= 0; i < 2; ++i) {
+    args.parse(ARGC_FOR(NO_ARGS), const_cast<char**>(NO_ARGS));
+    EXPECT_EQ(access(imageFile.path().c_str(), R_OK), 0);
+    EXPECT_EQ(args.port(), 80);
+    EXPECT_EQ(args.logLevel(), "info");
+    EXPECT_EQ(args.paths(), std::vector<std::string>({ "/a", "/b" }));
+  }
+
+  const char* WITH_ARGS[] = { "server", "--port", "8080", nullptr };
+  args.parse(ARGC_FOR(WITH_ARGS), const_cast<char**>(WITH_ARGS));
+  EXPECT_EQ(args.port(), 8080);
+  EXPECT_EQ(args.logLevel(), "info");
+
+  // Changing the text makes the image stale
+  config.rewrite("port = 81\n");
+  args.parse(ARGC_FOR(NO_ARGS), const_cast<char**>(NO_ARGS));
+  EXPECT_EQ(args.port(), 81);
+  EXPECT_EQ(args.logLevel(), "");
+  EXPECT_TRUE(args.paths().empty());
+
+  // An image compiled for a different set of arguments is ignored.  In
+  // this one, "--port" has the index "--host" has in ServerArgs.
+  SimpleCmdLineArgs empty;
+  EXPECT_THROW(empty.compileConfigFile(config.path(), imageFile.path()),
+	       ConfigFileError);
+
+  ReorderedServerArgs reordered;
+  reordered.compileConfigFile(config.path(), imageFile.path());
+  args.parse(ARGC_FOR(NO_ARGS), const_cast<char**>(NO_ARGS));
+  EXPECT_EQ(args.port(), 81);
+  EXPECT_EQ(args.host(), "");
+}
@@ -0,0 +1,169 @@
+/** @file ConfigWatcherTest.cpp
+ *
+ *  Unit tests for pistis::arg_parser::ConfigWatcher.
+ */
+
+#include <pistis/arg_parser/CmdLineSchema.hpp>
+#include <pistis/arg_parser/ConfigWatcher.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  std::string configPath;
+
+  struct Tuning {
+    int cacheSize;
+    std::string mode;
+
+    Tuning(): cacheSize(0), mode() { }
+  };
+
+  class TuningSchema : public CmdLineSchema<Tuning> {
+  public:
+    TuningSchema() {
+      registerNamedArgInRange_("--cache-size", "cache size", true, 1, 1000,
+			       &Tuning::cacheSize);
+      registerNamedArg_("--mode", "mode", false, &Tuning::mode);
+      addConfigFile_(configPath, true);
+    }
+  };
+
+  // A target that can only be created numLeft more times
+  struct FragileTuning {
+    static std::atomic<int> numLeft;
+    int cacheSize;
+
+    FragileTuning(): cacheSize(0) {
+      if (numLeft-- <= 0) {
+	throw std::runtime_error("No more tunings");
+      }
+    }
+  };
+
+  std::atomic<int> FragileTuning::numLeft(0);
+
+  class FragileTuningSchema : public CmdLineSchema<FragileTuning> {
+  public:
+    FragileTuningSchema() {
+      registerNamedArg_("--cache-size", "cache size", true,
+			&FragileTuning::cacheSize);
+      addConfigFile_(configPath, true);
+    }
+  };
+
+  // Write a new file and rename it over the old one, as deployment
+  // tools do
+  void replaceConfig(const std::string& text) {
+    std::string tmp= configPath + ".new";
+    FILE* f= fopen(tmp.c_str(), "w");
+    fwrite(text.data(), 1, text.size(), f);
+    fclose(f);
+    rename(tmp.c_str(), configPath.c_str());
+  }
+
+  template <typename Predicate>
+  bool waitFor(const Predicate& p) {
+    for (int i= 0; i < 500; ++i) {
+      if (p()) {
+	return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+  }
+}
+
+TEST(ConfigWatcherTests, ReloadOnChange) {
+  char dir[]= "/tmp/pistis_watch_XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir));
+  configPath= std::string(dir) + "/tuning.cfg";
+  replaceConfig("cache-size = 10\n");
+
+  const char* ARGV[] = { "server", "--mode", "fast", nullptr };
+  std::atomic<int> numErrors(0);
+  ConfigWatcher<TuningSchema> watcher(
+      3, const_cast<char**>(ARGV),
+      [&numErrors](const std::string&) { ++numErrors; },
+      std::chrono::milliseconds(10)
+  );
+
+  EXPECT_EQ(watcher.version(), 0);
+  EXPECT_EQ(watcher.snapshot()->cacheSize, 10);
+  EXPECT_EQ(watcher.snapshot()->mode, "fast");
+
+  replaceConfig("cache-size = 20\nmode = slow\n");
+  ASSERT_TRUE(waitFor([&watcher]() { return watcher.version() >= 1; }));
+  EXPECT_EQ(watcher.snapshot()->cacheSize, 20);
+  EXPECT_EQ(watcher.snapshot()->mode, "fast");
+
+  // The new value is out of range, so the last good snapshot stays
+  // current
+  const uint64_t version= watcher.version();
+  replaceConfig("cache-size = 5000\n");
+  ASSERT_TRUE(waitFor([&numErrors]() { return numErrors > 0; }));
+  EXPECT_EQ(watcher.version(), version);
+  EXPECT_EQ(watcher.snapshot()->cacheSize, 20);
+
+  unlink(configPath.c_str());
+  rmdir(dir);
+}
+
+TEST(ConfigWatcherTests, TargetThatThrows) {
+  char dir[]= "/tmp/pistis_watch_XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir));
+  configPath= std::string(dir) + "/tuning.cfg";
+  replaceConfig("cache-size = 10\n");
+
+  const char* ARGV[] = { "server", nullptr };
+  std::atomic<int> numErrors(0);
+  FragileTuning::numLeft= 1;
+  ConfigWatcher<FragileTuningSchema> watcher(
+      1, const_cast<char**>(ARGV),
+      [&numErrors](const std::string& msg) {
+	// Removing the file at the end is reported as well
+	if (msg == "No more tunings") {
+	  ++numErrors;
+	}
+      },
+      std::chrono::milliseconds(10)
+  );
+
+  // Creating the next target fails, which is reported without stopping
+  // the watcher, and the next change is reloaded
+  replaceConfig("cache-size = 20\n");
+  ASSERT_TRUE(waitFor([&numErrors]() { return numErrors > 0; }));
+  EXPECT_EQ(watcher.version(), 0);
+  EXPECT_EQ(watcher.snapshot()->cacheSize, 10);
+
+  FragileTuning::numLeft= 100;
+  replaceConfig("cache-size = 30\n");
+  ASSERT_TRUE(waitFor([&watcher]() { return watcher.version() >= 1; }));
+  EXPECT_EQ(watcher.snapshot()->cacheSize, 30);
+
+  unlink(configPath.c_str());
+  rmdir(dir);
+}
+
+TEST(ConfigWatcherTests, InvalidInitialConfig) {
+  char dir[]= "/tmp/pistis_watch_XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir));
+  configPath= std::string(dir) + "/tuning.cfg";
+  replaceConfig("cache-size = 0\n");
+
+  const char* ARGV[] = { "server", nullptr };
+  EXPECT_THROW(ConfigWatcher<TuningSchema> watcher(
+		   1, const_cast<char**>(ARGV)),
+	       std::exception);
+
+  unlink(configPath.c_str());
+  rmdir(dir);
+}
@@ -0,0 +1,124 @@
+/** @file EnumBitsTest.cpp
+ *
+ *  Unit tests for arguments of pistis::arg_parser::SimpleCmdLineArgs
+ *  whose values are stored as bitmasks of enum values.
+ */
+
+#include <pistis/arg_parser/IllegalValueError.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <pistis/exceptions/IllegalValueError.hpp>
+#include <gtest/gtest.h>
+#include <bitset>
+#include <string>
+#include <stdint.h>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  enum class Feature { CACHE= 0, COMPRESS= 1, TRACE= 2, RETRY= 63 };
+
+  enum Region { US= 0, EU= 1, ASIA= 99 };
+
+  uint64_t bitOf(Feature f) { return (uint64_t)1 << (int)f; }
+
+  class FeatureArgs : public SimpleCmdLineArgs {
+  public:
+    FeatureArgs(): SimpleCmdLineArgs(), features_(0), disabled_(0),
+		   regions_(), narrow_(0) {
+      registerNamedArg_("--features", "features", false, ",", false,
+			features(), features_);
+      registerNamedArg_("--disable", "disabled features", false,
+			features(), disabled_);
+      registerNamedArg_("--regions", "regions", false, "+", true,
+			regions(), regions_);
+    }
+
+    uint64_t enabled() const { return features_; }
+    uint64_t disabled() const { return disabled_; }
+    const std::bitset<128>& enabledRegions() const { return regions_; }
+
+    void registerNarrowRegions() {
+      registerNamedArg_("--narrow", "narrow", false, regions(), narrow_);
+    }
+
+  protected:
+    virtual void initValues_() {
+      features_= 0;
+      disabled_= 0;
+      regions_.reset();
+    }
+
+  private:
+    uint64_t features_;
+    uint64_t disabled_;
+    std::bitset<128> regions_;
+    uint64_t narrow_;
+
+    static ValueMap<Feature> features() {
+      ValueMap<Feature> valueMap;
+      valueMap.setValue("cache", Feature::CACHE);
+      valueMap.setValue("compress", Feature::COMPRESS);
+      valueMap.setValue("trace", Feature::TRACE);
+      valueMap.setValue("retry", Feature::RETRY);
+      return valueMap;
+    }
+
+    static ValueMap<Region> regions() {
+      ValueMap<Region> valueMap;
+      valueMap.setValue("us", US);
+      valueMap.setValue("eu", EU);
+      valueMap.setValue("asia", ASIA);
+      return valueMap;
+    }
+  };
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(EnumBitsTests, ParseBitmasks) {
+  const char* ARGV[] = { "app", "--features", "cache,retry", "--disable",
+			 "trace", "--features", "cache", "--disable",
+			 "compress", "--regions", "asia+us", nullptr };
+  FeatureArgs args;
+
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.enabled(), bitOf(Feature::CACHE) | bitOf(Feature::RETRY));
+  EXPECT_EQ(args.disabled(),
+	    bitOf(Feature::TRACE) | bitOf(Feature::COMPRESS));
+  EXPECT_EQ(args.enabledRegions().count(), 2);
+  EXPECT_TRUE(args.enabledRegions()[US]);
+  EXPECT_TRUE(args.enabledRegions()[ASIA]);
+
+  const char* EMPTY[] = { "app", "--regions", "", nullptr };
+  args.parse(ARGC_FOR(EMPTY), const_cast<char**>(EMPTY));
+  EXPECT_TRUE(args.enabledRegions().none());
+  EXPECT_EQ(args.enabled(), 0);
+}
+
+TEST(EnumBitsTests, IllegalNames) {
+  const char* UNKNOWN[] = { "app", "--features", "cache,fast", nullptr };
+  const char* EMPTY[] = { "app", "--features", "", nullptr };
+  FeatureArgs args;
+
+  try {
+    args.parse(ARGC_FOR(UNKNOWN), const_cast<char**>(UNKNOWN));
+    FAIL() << "IllegalValueError not thrown";
+  } catch(const IllegalValueError& e) {
+    EXPECT_NE(std::string(e.what()).find("features (--features)"),
+	      std::string::npos) << e.what();
+    EXPECT_NE(std::string(e.what()).find("Legal values are"),
+	      std::string::npos) << e.what();
+    EXPECT_NE(std::string(e.what()).find("fast"), std::string::npos)
+	<< e.what();
+  }
+  EXPECT_EQ(args.enabled(), 0);
+  EXPECT_THROW(args.parse(ARGC_FOR(EMPTY), const_cast<char**>(EMPTY)),
+	       IllegalValueError);
+}
+
+TEST(EnumBitsTests, ValuesMustFit) {
+  FeatureArgs args;
+
+  EXPECT_THROW(args.registerNarrowRegions(),
+	       pistis::exceptions::IllegalValueError);
+}
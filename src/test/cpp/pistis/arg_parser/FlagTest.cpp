@@ -0,0 +1,332 @@
+/** @file FlagTest.cpp
+ *
+ *  Unit tests for flags registered with
+ *  pistis::arg_parser::SimpleCmdLineArgs::registerFlag_() and
+ *  registerCountingFlag_().
+ */
+
+#include <pistis/arg_parser/IllegalValueError.hpp>
+#include <pistis/arg_parser/ParseStats.hpp>
+#include <pistis/arg_parser/ResourceLimitExceededError.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <pistis/arg_parser/UnknownCmdLineArgError.hpp>
+#include "TempFile.hpp"
+#include <pistis/exceptions/IllegalStateError.hpp>
+#include <pistis/exceptions/IllegalValueError.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <bitset>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace pistis::arg_parser;
+using pistis::arg_parser::test::TempFile;
+
+namespace {
+  const size_t NUM_FEATURES= 300;
+
+  class FlagArgs : public SimpleCmdLineArgs {
+  public:
+    FlagArgs(): SimpleCmdLineArgs(), color_(true), extract_(false),
+		force_(false), verbosity_(0), level_(0), features_() {
+      registerFlag_("--color", "use color", true, color_);
+      registerFlag_("-x", "extract", false, extract_);
+      registerFlag_("-f", "force", false, force_);
+      registerCountingFlag_("-v", "verbosity", verbosity_);
+      registerNamedArg_("--level", "level", false, level_);
+      for (size_t i= 0; i < NUM_FEATURES; ++i) {
+	registerFlag_("--feature-" + std::to_string(i), "feature", true,
+		      features_, i);
+      }
+    }
+
+    bool color() const { return color_; }
+    bool extract() const { return extract_; }
+    bool force() const { return force_; }
+    int verbosity() const { return verbosity_; }
+    int level() const { return level_; }
+    const std::bitset<NUM_FEATURES>& features() const { return features_; }
+
+    using SimpleCmdLineArgs::addConfigFile_;
+
+    void registerTwice(const std::string& name) {
+      bool value= false;
+      registerFlag_(name, "twice", true, value);
+    }
+
+  protected:
+    virtual void initValues_() {
+      color_= true;
+      extract_= false;
+      force_= false;
+      verbosity_= 0;
+      features_.reset();
+    }
+
+  private:
+    bool color_;
+    bool extract_;
+    bool force_;
+    int verbosity_;
+    int level_;
+    std::bitset<NUM_FEATURES> features_;
+  };
+
+  class ServiceArgs : public SimpleCmdLineArgs {
+  public:
+    ServiceArgs(): SimpleCmdLineArgs(), debug_(false), color_(true),
+		   verbosity_(0) {
+      registerFlag_("--debug", "debug", true, debug_);
+      bindEnvironment_("PISTIS_FLAG_TEST_");
+      registerFlag_("--color", "use color", true, color_);
+      registerCountingFlag_("-v", "verbosity", verbosity_);
+    }
+
+    bool debug() const { return debug_.load(); }
+    bool color() const { return color_; }
+    int verbosity() const { return verbosity_; }
+
+  protected:
+    virtual void initValues_() {
+      debug_.store(false);
+      color_= true;
+      verbosity_= 0;
+    }
+
+  private:
+    std::atomic<bool> debug_;
+    bool color_;
+    int verbosity_;
+  };
+
+  class RecordingObserver : public ParseObserver {
+  public:
+    RecordingObserver(): events_() { }
+
+    const std::vector<std::string>& events() const { return events_; }
+
+    virtual void begin(Event event, const std::string& name) {
+      events_.push_back("begin " + name);
+    }
+    virtual void end(Event event, const std::string& name) { }
+
+  private:
+    std::vector<std::string> events_;
+  };
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(FlagTests, SetAndClearFlags) {
+  const char* ARGV[] = { "app", "--no-color", "--feature-7",
+			 "--feature-299", "--level", "3", "--feature-8",
+			 "--no-feature-8", "--feature-12=true",
+			 "--feature-13=false", nullptr };
+  FlagArgs args;
+
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_FALSE(args.color());
+  EXPECT_EQ(args.features().count(), 3);
+  EXPECT_TRUE(args.features()[7]);
+  EXPECT_TRUE(args.features()[12]);
+  EXPECT_TRUE(args.features()[299]);
+  EXPECT_EQ(args.level(), 3);
+  EXPECT_EQ(args.verbosity(), 0);
+
+  const char* EXPLICIT[] = { "app", "--color=false", "-v", nullptr };
+  args.parse(ARGC_FOR(EXPLICIT), const_cast<char**>(EXPLICIT));
+  EXPECT_FALSE(args.color());
+  EXPECT_TRUE(args.features().none());
+  EXPECT_EQ(args.verbosity(), 1);
+}
+
+TEST(FlagTests, CombinedShortFlags) {
+  const char* ARGV[] = { "app", "-vvv", "-xv", "-f", nullptr };
+  FlagArgs args;
+
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.verbosity(), 4);
+  EXPECT_TRUE(args.extract());
+  EXPECT_TRUE(args.force());
+
+  // Nothing is applied from a combination with an unknown flag
+  const char* UNKNOWN[] = { "app", "-xvq", nullptr };
+  EXPECT_THROW(args.parse(ARGC_FOR(UNKNOWN), const_cast<char**>(UNKNOWN)),
+	       UnknownCmdLineArgError);
+  EXPECT_FALSE(args.extract());
+  EXPECT_EQ(args.verbosity(), 0);
+}
+
+TEST(FlagTests, IllegalValues) {
+  const char* NOT_BOOL[] = { "app", "--color=maybe", nullptr };
+  const char* NEGATED[] = { "app", "--no-color=true", nullptr };
+  const char* COUNTED[] = { "app", "-v=true", nullptr };
+  const char* NOT_NEGATABLE[] = { "app", "--no-x", nullptr };
+  FlagArgs args;
+
+  try {
+    args.parse(ARGC_FOR(NOT_BOOL), const_cast<char**>(NOT_BOOL));
+    FAIL() << "IllegalValueError not thrown";
+  } catch(const IllegalValueError& e) {
+    EXPECT_NE(std::string(e.what()).find("use color (--color)"),
+	      std::string::npos) << e.what();
+    EXPECT_NE(std::string(e.what()).find("maybe"), std::string::npos)
+	<< e.what();
+  }
+  EXPECT_THROW(args.parse(ARGC_FOR(NEGATED), const_cast<char**>(NEGATED)),
+	       IllegalValueError);
+  EXPECT_THROW(args.parse(ARGC_FOR(COUNTED), const_cast<char**>(COUNTED)),
+	       IllegalValueError);
+  EXPECT_THROW(args.parse(ARGC_FOR(NOT_NEGATABLE),
+			  const_cast<char**>(NOT_NEGATABLE)),
+	       UnknownCmdLineArgError);
+}
+
+TEST(FlagTests, NamesInUse) {
+  FlagArgs args;
+
+  EXPECT_THROW(args.registerTwice("--color"),
+	       pistis::exceptions::IllegalStateError);
+  EXPECT_THROW(args.registerTwice("--level"),
+	       pistis::exceptions::IllegalStateError);
+  EXPECT_THROW(args.registerTwice("--no-color"),
+	       pistis::exceptions::IllegalStateError);
+  EXPECT_THROW(args.registerTwice("-q"),
+	       pistis::exceptions::IllegalValueError);
+  EXPECT_THROW(args.registerTwice("color"),
+	       pistis::exceptions::IllegalValueError);
+}
+
+TEST(FlagTests, SuggestFlags) {
+  const char* ARGV[] = { "app", "--colour", nullptr };
+  FlagArgs args;
+
+  try {
+    args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+    FAIL() << "UnknownCmdLineArgError not thrown";
+  } catch(const UnknownCmdLineArgError& e) {
+    EXPECT_NE(std::string(e.what()).find("--color"), std::string::npos)
+	<< e.what();
+  }
+}
+
+TEST(FlagTests, ConfigFiles) {
+  const char* NO_ARGS[] = { "app", nullptr };
+  const char* WITH_ARGS[] = { "app", "--color", "-v", nullptr };
+  TempFile config("no-color = \nfeature-3 = true\n-x = \n-v = 2\n");
+  TempFile bad("feature-3 = maybe\n");
+  TempFile imageFile("");
+  FlagArgs args;
+
+  unlink(imageFile.path().c_str());
+  args.addConfigFile_(config.path(), true, imageFile.path());
+
+  // The first parse reads the text and the second replays the image
+  for (int i= 0; i < 2; ++i) {
+    args.parse(ARGC_FOR(NO_ARGS), const_cast<char**>(NO_ARGS));
+    EXPECT_FALSE(args.color());
+    EXPECT_TRUE(args.extract());
+    EXPECT_EQ(args.verbosity(), 2);
+    EXPECT_EQ(args.features().count(), 1);
+    EXPECT_TRUE(args.features()[3]);
+  }
+
+  // The command line overrides the file
+  args.parse(ARGC_FOR(WITH_ARGS), const_cast<char**>(WITH_ARGS));
+  EXPECT_TRUE(args.color());
+  EXPECT_EQ(args.verbosity(), 1);
+  EXPECT_TRUE(args.features()[3]);
+
+  FlagArgs other;
+  other.addConfigFile_(bad.path(), true);
+  EXPECT_THROW(other.parse(ARGC_FOR(NO_ARGS), const_cast<char**>(NO_ARGS)),
+	       IllegalValueError);
+}
+
+TEST(FlagTests, Environment) {
+  const char* NO_ARGS[] = { "app", nullptr };
+  const char* WITH_ARGS[] = { "app", "--no-debug", nullptr };
+  ServiceArgs args;
+
+  setenv("PISTIS_FLAG_TEST_DEBUG", "true", 1);
+  setenv("PISTIS_FLAG_TEST_COLOR", "false", 1);
+  setenv("PISTIS_FLAG_TEST_V", "3", 1);
+  args.parse(ARGC_FOR(NO_ARGS), const_cast<char**>(NO_ARGS));
+  EXPECT_TRUE(args.debug());
+  EXPECT_FALSE(args.color());
+  EXPECT_EQ(args.verbosity(), 3);
+
+  args.parse(ARGC_FOR(WITH_ARGS), const_cast<char**>(WITH_ARGS));
+  EXPECT_FALSE(args.debug());
+  EXPECT_FALSE(args.color());
+
+  setenv("PISTIS_FLAG_TEST_COLOR", "maybe", 1);
+  EXPECT_THROW(args.parse(ARGC_FOR(NO_ARGS), const_cast<char**>(NO_ARGS)),
+	       IllegalValueError);
+
+  unsetenv("PISTIS_FLAG_TEST_DEBUG");
+  unsetenv("PISTIS_FLAG_TEST_COLOR");
+  unsetenv("PISTIS_FLAG_TEST_V");
+}
+
+TEST(FlagTests, MaxOccurrences) {
+  const char* TWICE[] = { "app", "-vv", "--color", "--no-color", nullptr };
+  const char* COMBINED[] = { "app", "-vxv", "-v", nullptr };
+  const char* REPEATED[] = { "app", "--feature-1", "--feature-1",
+			     "--no-feature-1", nullptr };
+  FlagArgs args;
+  ParseLimits limits;
+
+  limits.maxOccurrences= 2;
+  args.setParseLimits(limits);
+  args.parse(ARGC_FOR(TWICE), const_cast<char**>(TWICE));
+  EXPECT_EQ(args.verbosity(), 2);
+  EXPECT_FALSE(args.color());
+  EXPECT_THROW(args.parse(ARGC_FOR(COMBINED), const_cast<char**>(COMBINED)),
+	       ResourceLimitExceededError);
+  EXPECT_THROW(args.parse(ARGC_FOR(REPEATED), const_cast<char**>(REPEATED)),
+	       ResourceLimitExceededError);
+}
+
+TEST(FlagTests, StatsAndObserver) {
+  const char* ARGV[] = { "app", "-xv", "--no-color", "--level", "3",
+			 nullptr };
+  FlagArgs args;
+  ParseStats stats;
+  RecordingObserver observer;
+
+  args.setParseStats(&stats);
+  args.setParseObserver(&observer);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  args.setParseStats(nullptr);
+  args.setParseObserver(nullptr);
+
+  EXPECT_EQ(stats.handlerInvocations, 4);
+  EXPECT_EQ(observer.events(),
+	    std::vector<std::string>({
+		"begin initValues_", "begin -x", "begin -v", "begin --color",
+		"begin --level", "begin checkValues_" }));
+}
+
+TEST(FlagTests, RuntimeFlags) {
+  const char* ARGV[] = { "app", "--debug", nullptr };
+  ServiceArgs args;
+
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  const RuntimeFlagRegistry& flags= args.runtimeFlags();
+
+  // Only flags with atomic destinations can be changed while running
+  ASSERT_EQ(flags.size(), 1);
+  EXPECT_TRUE(flags.has("--debug"));
+  EXPECT_FALSE(flags.has("--color"));
+  EXPECT_EQ(flags.get("--debug"), "true");
+
+  flags.set("--debug", "false");
+  EXPECT_FALSE(args.debug());
+  EXPECT_EQ(flags.get("--debug"), "false");
+  EXPECT_THROW(flags.set("--debug", "yes"),
+	       pistis::exceptions::IllegalValueError);
+  EXPECT_FALSE(args.debug());
+}
@@ -0,0 +1,126 @@
+/** @file KeyValueArgsTest.cpp
+ *
+ *  Unit tests for arguments of pistis::arg_parser::SimpleCmdLineArgs
+ *  whose values are key=value pairs.
+ */
+
+#include <pistis/arg_parser/IllegalValueError.hpp>
+#include <pistis/arg_parser/ResourceLimitExceededError.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  class DefineArgs : public SimpleCmdLineArgs {
+  public:
+    DefineArgs(DuplicateKeyPolicy onDuplicate):
+	SimpleCmdLineArgs(), defines_(), ports_() {
+      registerNamedArg_("-D", "definitions", false, onDuplicate, defines_);
+      registerNamedArg_("--ports", "ports", false, ";", onDuplicate,
+			ports_);
+    }
+
+    const std::unordered_map<std::string, std::string>& defines() const {
+      return defines_;
+    }
+    const std::map<int, double>& ports() const { return ports_; }
+
+  protected:
+    virtual void initValues_() {
+      defines_.clear();
+      ports_.clear();
+    }
+
+  private:
+    std::unordered_map<std::string, std::string> defines_;
+    std::map<int, double> ports_;
+  };
+
+  void expectIllegalValue(DefineArgs& args, int argc, const char** argv,
+			  const std::string& details) {
+    try {
+      args.parse(argc, const_cast<char**>(argv));
+      FAIL() << "IllegalValueError not thrown";
+    } catch(const IllegalValueError& e) {
+      EXPECT_NE(std::string(e.what()).find(details), std::string::npos)
+	  << e.what();
+    }
+  }
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(KeyValueArgsTests, ParsePairs) {
+  const char* ARGV[] = { "app", "-D", "NAME=value", "-D", "EMPTY=",
+			 "--ports", "80=1.5;443=2.5", "-D", "EQ=a=b",
+			 "--ports", "8080=3", nullptr };
+  DefineArgs args(DuplicateKeyPolicy::REJECT);
+
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.defines(),
+	    (std::unordered_map<std::string, std::string>({
+		{ "NAME", "value" }, { "EMPTY", "" }, { "EQ", "a=b" } })));
+  EXPECT_EQ(args.ports(),
+	    (std::map<int, double>({ { 80, 1.5 }, { 443, 2.5 },
+				     { 8080, 3.0 } })));
+}
+
+TEST(KeyValueArgsTests, DuplicateKeys) {
+  const char* ARGV[] = { "app", "-D", "A=1", "--ports", "80=1;80=2", "-D",
+			 "A=2", nullptr };
+  DefineArgs keepFirst(DuplicateKeyPolicy::KEEP_FIRST);
+  DefineArgs keepLast(DuplicateKeyPolicy::KEEP_LAST);
+  DefineArgs reject(DuplicateKeyPolicy::REJECT);
+
+  keepFirst.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(keepFirst.defines().at("A"), "1");
+  EXPECT_EQ(keepFirst.ports().at(80), 1.0);
+
+  keepLast.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(keepLast.defines().at("A"), "2");
+  EXPECT_EQ(keepLast.ports().at(80), 2.0);
+
+  expectIllegalValue(reject, ARGC_FOR(ARGV), ARGV, "Duplicate key");
+}
+
+TEST(KeyValueArgsTests, MalformedPairs) {
+  const char* NO_EQUALS[] = { "app", "-D", "NAME", nullptr };
+  const char* NO_KEY[] = { "app", "-D", "=value", nullptr };
+  const char* EMPTY[] = { "app", "-D", "", nullptr };
+  const char* BAD_KEY[] = { "app", "--ports", "80=1;http=2", nullptr };
+  const char* BAD_VALUE[] = { "app", "--ports", "80=fast", nullptr };
+  const char* EMPTY_ITEM[] = { "app", "--ports", "80=1;;81=2", nullptr };
+  DefineArgs args(DuplicateKeyPolicy::REJECT);
+
+  expectIllegalValue(args, ARGC_FOR(NO_EQUALS), NO_EQUALS,
+		     "Expected key=value");
+  expectIllegalValue(args, ARGC_FOR(NO_KEY), NO_KEY, "Key is empty");
+  expectIllegalValue(args, ARGC_FOR(EMPTY), EMPTY, "Value is empty");
+  expectIllegalValue(args, ARGC_FOR(BAD_KEY), BAD_KEY, "http");
+  expectIllegalValue(args, ARGC_FOR(BAD_VALUE), BAD_VALUE, "fast");
+  expectIllegalValue(args, ARGC_FOR(EMPTY_ITEM), EMPTY_ITEM,
+		     "Expected key=value");
+  expectIllegalValue(args, ARGC_FOR(BAD_VALUE), BAD_VALUE,
+		     "ports (--ports)");
+}
+
+TEST(KeyValueArgsTests, ParseLimits) {
+  const char* ARGV[] = { "app", "--ports", "1=1;2=2;3=3", nullptr };
+  DefineArgs args(DuplicateKeyPolicy::REJECT);
+  ParseLimits limits;
+
+  limits.maxListElements= 2;
+  args.setParseLimits(limits);
+  EXPECT_THROW(args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV)),
+	       ResourceLimitExceededError);
+  EXPECT_TRUE(args.ports().empty());
+
+  limits.maxListElements= 3;
+  args.setParseLimits(limits);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.ports().size(), 3);
+}
@@ -0,0 +1,130 @@
+/** @file LazyTest.cpp
+ *
+ *  Unit tests for converting values of pistis::arg_parser::Lazy
+ *  destinations on first use.
+ */
+
+#include <pistis/arg_parser/IllegalValueError.hpp>
+#include <pistis/arg_parser/Lazy.hpp>
+#include <pistis/arg_parser/ParseStats.hpp>
+#include <pistis/arg_parser/ResourceLimitExceededError.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  class LazyArgs : public SimpleCmdLineArgs {
+  public:
+    LazyArgs(): SimpleCmdLineArgs(), threads_(4), weights_(), tags_(),
+		name_(std::string("none")) {
+      registerNamedArg_("--threads", "threads", false, threads_);
+      registerNamedArg_("--weights", "weights", false, ",", false,
+			weights_);
+      registerNamedArg_("--tag", "tags", false, tags_);
+      registerNamedArg_("--name", "name", false, name_);
+    }
+
+    const Lazy<int>& threads() const { return threads_; }
+    const Lazy< std::vector<double> >& weights() const { return weights_; }
+    const Lazy< std::unordered_set<std::string> >& tags() const {
+      return tags_;
+    }
+    const Lazy<std::string>& name() const { return name_; }
+
+  private:
+    Lazy<int> threads_;
+    Lazy< std::vector<double> > weights_;
+    Lazy< std::unordered_set<std::string> > tags_;
+    Lazy<std::string> name_;
+  };
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(LazyTests, ConvertOnFirstUse) {
+  const char* ARGV[] = { "app", "--threads", "8", "--weights", "0.5,1.5",
+			 "--tag", "a", "--weights", "2.5", "--tag", "b",
+			 "--tag", "a", nullptr };
+  LazyArgs args;
+
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_FALSE(args.threads().converted());
+  ASSERT_EQ(args.weights().tokens().size(), 2);
+  EXPECT_EQ(args.weights().tokens()[0], ARGV[4]);
+  EXPECT_EQ(args.weights().tokens()[1], ARGV[8]);
+
+  EXPECT_EQ(*args.threads(), 8);
+  EXPECT_TRUE(args.threads().converted());
+  EXPECT_EQ(*args.weights(), std::vector<double>({ 0.5, 1.5, 2.5 }));
+  EXPECT_EQ(args.tags()->size(), 2);
+  EXPECT_FALSE(args.name().given());
+  EXPECT_EQ(*args.name(), "none");
+
+  // Values from the last parse replace values from earlier ones
+  const char* AGAIN[] = { "app", "--weights", "3", nullptr };
+  args.parse(ARGC_FOR(AGAIN), const_cast<char**>(AGAIN));
+  EXPECT_FALSE(args.threads().given());
+  EXPECT_EQ(*args.threads(), 4);
+  EXPECT_EQ(*args.weights(), std::vector<double>({ 3.0 }));
+  EXPECT_TRUE(args.tags()->empty());
+}
+
+TEST(LazyTests, ErrorsOnFirstUse) {
+  const char* ARGV[] = { "app", "--threads", "many", "--weights", "1,x",
+			 nullptr };
+  LazyArgs args;
+
+  // parse() does not look at the values
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  try {
+    args.threads().get();
+    FAIL() << "IllegalValueError not thrown";
+  } catch(const IllegalValueError& e) {
+    EXPECT_NE(std::string(e.what()).find("threads (--threads)"),
+	      std::string::npos) << e.what();
+    EXPECT_NE(std::string(e.what()).find("many"), std::string::npos)
+	<< e.what();
+  }
+  EXPECT_FALSE(args.threads().converted());
+  EXPECT_THROW(args.threads().get(), IllegalValueError);
+  EXPECT_THROW(args.validateAll(), IllegalValueError);
+
+  const char* LEGAL[] = { "app", "--threads", "2", "--weights", "1,2",
+			  nullptr };
+  args.parse(ARGC_FOR(LEGAL), const_cast<char**>(LEGAL));
+  args.validateAll();
+  EXPECT_TRUE(args.weights().converted());
+  EXPECT_EQ(*args.threads(), 2);
+}
+
+TEST(LazyTests, Limits) {
+  const char* LONG_LIST[] = { "app", "--weights", "1,2,3", nullptr };
+  const char* TWO_LISTS[] = { "app", "--weights", "1,2", "--weights", "3",
+			      nullptr };
+  LazyArgs args;
+  ParseLimits limits;
+  ParseStats stats;
+
+  // The number of items is checked by parse()
+  limits.maxListElements= 2;
+  args.setParseLimits(limits);
+  EXPECT_THROW(args.parse(ARGC_FOR(LONG_LIST), const_cast<char**>(LONG_LIST)),
+	       ResourceLimitExceededError);
+
+  // The bytes stored are only known once the value is converted, so
+  // get() checks them.  The parse only records the text, and that is
+  // all the stats count.
+  limits.maxListElements= ParseLimits::UNLIMITED;
+  limits.maxContainerBytes= 2 * sizeof(double);
+  args.setParseLimits(limits);
+  args.setParseStats(&stats);
+  args.parse(ARGC_FOR(TWO_LISTS), const_cast<char**>(TWO_LISTS));
+  args.setParseStats(nullptr);
+  EXPECT_EQ(stats.handlerInvocations, 2);
+  EXPECT_FALSE(args.weights().converted());
+  EXPECT_THROW(args.weights().get(), ResourceLimitExceededError);
+}
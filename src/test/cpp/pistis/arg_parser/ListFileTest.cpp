@@ -0,0 +1,180 @@
+/** @file ListFileTest.cpp
+ *
+ *  Unit tests for list values read from files by
+ *  pistis::arg_parser::SimpleCmdLineArgs when setListFiles() is on.
+ */
+
+#include <pistis/arg_parser/IllegalValueError.hpp>
+#include <pistis/arg_parser/ResourceLimitExceededError.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include "TempFile.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace pistis::arg_parser;
+using pistis::arg_parser::test::TempFile;
+
+namespace {
+  class ListArgs : public SimpleCmdLineArgs {
+  public:
+    ListArgs(): SimpleCmdLineArgs(), ids_(), names_(), paths_(), name_() {
+      registerNamedArg_("--ids", "ids", false, ",", false, ids_);
+      registerNamedArg_("--names", "names", false, ",", false, names_);
+      registerNamedArg_("-p", "search path", false, paths_);
+      registerNamedArg_("--name", "name", false, name_);
+    }
+
+    const std::vector<int>& ids() const { return ids_; }
+    const std::unordered_set<std::string>& names() const { return names_; }
+    const std::vector<std::string>& paths() const { return paths_; }
+    const std::string& name() const { return name_; }
+
+  protected:
+    virtual void initValues_() {
+      ids_.clear();
+      names_.clear();
+      paths_.clear();
+      name_.clear();
+    }
+
+  private:
+    std::vector<int> ids_;
+    std::unordered_set<std::string> names_;
+    std::vector<std::string> paths_;
+    std::string name_;
+  };
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(ListFileTests, ReadItems) {
+  // Enough lines that some span the chunks the file is read in
+  const int numIds= 50000;
+  std::string text;
+  for (int i= 0; i < numIds; ++i) {
+    text += std::to_string(i) + ((i % 3) ? "\n" : "\r\n");
+  }
+  text += "\n-1";
+  ASSERT_GT(text.size(), 2 * SimpleCmdLineArgs::LIST_FILE_CHUNK_SIZE);
+  TempFile ids(text);
+  TempFile names("alice\nbob\n\nalice\n");
+  const std::string idArg= ids.arg();
+  const std::string nameArg= names.arg();
+  const char* ARGV[] = { "app", "--ids", "7,8", "--ids", idArg.c_str(),
+			 "--names", nameArg.c_str(), nullptr };
+  ListArgs args;
+
+  args.setListFiles(true);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  ASSERT_EQ(args.ids().size(), numIds + 3);
+  EXPECT_EQ(args.ids()[1], 8);
+  for (int i= 0; i < numIds; ++i) {
+    ASSERT_EQ(args.ids()[i + 2], i);
+  }
+  EXPECT_EQ(args.ids().back(), -1);
+  EXPECT_EQ(args.names(), std::unordered_set<std::string>({ "alice", "bob" }));
+}
+
+TEST(ListFileTests, UnsplitLists) {
+  // A vector registered without a separator reads the file too, but a
+  // single value does not
+  TempFile paths("/usr/lib\n/lib\n");
+  const std::string pathArg= paths.arg();
+  const char* ARGV[] = { "app", "-p", "/opt", "-p", pathArg.c_str(),
+			 "--name", pathArg.c_str(), nullptr };
+  ListArgs args;
+
+  args.setListFiles(true);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.paths(),
+	    std::vector<std::string>({ "/opt", "/usr/lib", "/lib" }));
+  EXPECT_EQ(args.name(), pathArg);
+}
+
+TEST(ListFileTests, ReportLineOfIllegalItem) {
+  TempFile ids("1\n2\n\nthree\n4\n");
+  const std::string idArg= ids.arg();
+  const char* ARGV[] = { "app", "--ids", idArg.c_str(), nullptr };
+  const char* MISSING[] = { "app", "--ids", "@/tmp/pistis_no_such_ids.txt",
+			    nullptr };
+  ListArgs args;
+
+  args.setListFiles(true);
+  try {
+    args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+    FAIL() << "IllegalValueError not thrown";
+  } catch(const IllegalValueError& e) {
+    EXPECT_NE(std::string(e.what()).find("ids (--ids)"), std::string::npos)
+	<< e.what();
+    EXPECT_NE(std::string(e.what()).find("three"), std::string::npos)
+	<< e.what();
+    EXPECT_NE(std::string(e.what()).find("Line 4 of"), std::string::npos)
+	<< e.what();
+  }
+  EXPECT_EQ(args.ids(), std::vector<int>({ 1, 2 }));
+  EXPECT_THROW(args.parse(ARGC_FOR(MISSING), const_cast<char**>(MISSING)),
+	       IllegalValueError);
+}
+
+TEST(ListFileTests, EnforceLimits) {
+  TempFile ids("1\n2\n3\n");
+  const std::string idArg= ids.arg();
+  const char* ARGV[] = { "app", "--ids", idArg.c_str(), nullptr };
+  ListArgs args;
+  ParseLimits limits;
+
+  limits.maxListElements= 2;
+  args.setParseLimits(limits);
+  args.setListFiles(true);
+  EXPECT_THROW(args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV)),
+	       ResourceLimitExceededError);
+}
+
+TEST(ListFileTests, LimitLineSize) {
+  // The long line spans several chunks and has no newline to end it
+  TempFile longLine("1\n2\n" +
+		    std::string(SimpleCmdLineArgs::MAX_LIST_FILE_LINE_SIZE + 1,
+				'7'));
+  TempFile names("alice\n" + std::string(65, 'b') + "\n");
+  const std::string idArg= longLine.arg();
+  const std::string nameArg= names.arg();
+  const char* LONG_LINE[] = { "app", "--ids", idArg.c_str(), nullptr };
+  const char* LONG_NAME[] = { "app", "--names", nameArg.c_str(), nullptr };
+  ListArgs args;
+  ParseLimits limits;
+
+  args.setListFiles(true);
+  try {
+    args.parse(ARGC_FOR(LONG_LINE), const_cast<char**>(LONG_LINE));
+    FAIL() << "IllegalValueError not thrown";
+  } catch(const IllegalValueError& e) {
+    EXPECT_NE(std::string(e.what()).find("Line 3 of"), std::string::npos)
+	<< e.what();
+  }
+
+  // maxTokenSize applies to the lines of the file as well
+  args.parse(ARGC_FOR(LONG_NAME), const_cast<char**>(LONG_NAME));
+  limits.maxTokenSize= 64;
+  args.setParseLimits(limits);
+  try {
+    args.parse(ARGC_FOR(LONG_NAME), const_cast<char**>(LONG_NAME));
+    FAIL() << "IllegalValueError not thrown";
+  } catch(const IllegalValueError& e) {
+    EXPECT_NE(std::string(e.what()).find("Line 2 of"), std::string::npos)
+	<< e.what();
+    EXPECT_NE(std::string(e.what()).find("longer than 64 bytes"),
+	      std::string::npos) << e.what();
+  }
+}
+
+TEST(ListFileTests, OffByDefault) {
+  const char* ARGV[] = { "app", "--names", "@home,@work", nullptr };
+  ListArgs args;
+
+  EXPECT_FALSE(args.listFiles());
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.names(),
+	    std::unordered_set<std::string>({ "@home", "@work" }));
+}
@@ -0,0 +1,135 @@
+/** @file MappedArrayTest.cpp
+ *
+ *  Unit tests for pistis::arg_parser::MappedArray destinations of
+ *  pistis::arg_parser::SimpleCmdLineArgs.
+ */
+
+#include <pistis/arg_parser/IllegalValueError.hpp>
+#include <pistis/arg_parser/MappedArray.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include "TempFile.hpp"
+#include <pistis/exceptions/IllegalValueError.hpp>
+#include <gtest/gtest.h>
+#include <limits>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+using namespace pistis::arg_parser;
+using pistis::arg_parser::test::TempFile;
+
+namespace {
+  template <typename T>
+  std::string bytesOf(const std::vector<T>& values) {
+    return std::string((const char*)values.data(),
+		       values.size() * sizeof(T));
+  }
+
+  class EmbeddingArgs : public SimpleCmdLineArgs {
+  public:
+    EmbeddingArgs(): SimpleCmdLineArgs(), embedding_(), ids_() {
+      registerNamedArgInRange_("--embedding", "embedding", false,
+			       -1.0f, 1.0f, embedding_);
+      registerNamedArg_("--ids", "ids", false, ids_);
+    }
+
+    const MappedArray<float>& embedding() const { return embedding_; }
+    const MappedArray<uint64_t>& ids() const { return ids_; }
+
+  private:
+    MappedArray<float> embedding_;
+    MappedArray<uint64_t> ids_;
+  };
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(MappedArrayTests, MapFiles) {
+  std::vector<uint64_t> ids;
+  for (uint64_t i= 0; i < 10000; ++i) {
+    ids.push_back(i * i);
+  }
+  TempFile embeddingFile(bytesOf(std::vector<float>({ 0.5f, -1.0f, 1.0f })),
+			 ".f32");
+  TempFile idFile(bytesOf(ids), ".le.u64");
+  const std::string embedding= embeddingFile.arg();
+  const std::string idPath= idFile.arg();
+  const char* ARGV[] = { "app", "--embedding", embedding.c_str(), "--ids",
+			 idPath.c_str(), nullptr };
+  EmbeddingArgs args;
+
+  EXPECT_TRUE(args.ids().empty());
+  EXPECT_EQ(args.ids().data(), nullptr);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.embedding().path(), embeddingFile.path());
+  EXPECT_EQ(std::vector<float>(args.embedding().begin(),
+			       args.embedding().end()),
+	    std::vector<float>({ 0.5f, -1.0f, 1.0f }));
+  ASSERT_EQ(args.ids().size(), ids.size());
+  EXPECT_EQ(args.ids()[9999], 9999 * 9999);
+
+  // Copies share the mapping
+  MappedArray<uint64_t> copy= args.ids();
+  EXPECT_EQ(copy.data(), args.ids().data());
+}
+
+TEST(MappedArrayTests, CheckFiles) {
+  TempFile wrongType(bytesOf(std::vector<double>({ 0.5 })), ".f64");
+  TempFile bigEndian(bytesOf(std::vector<uint64_t>({ 1 })), ".be.u64");
+  TempFile partial(bytesOf(std::vector<uint32_t>({ 1, 2, 3 })), ".u64");
+  MappedArray<uint64_t> array;
+
+  EXPECT_THROW(array.map(wrongType.path()),
+	       pistis::exceptions::IllegalValueError);
+  EXPECT_THROW(array.map(partial.path()),
+	       pistis::exceptions::IllegalValueError);
+  EXPECT_THROW(array.map("/tmp/pistis_no_such_array.u64"),
+	       pistis::exceptions::IllegalValueError);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  EXPECT_THROW(array.map(bigEndian.path()),
+	       pistis::exceptions::IllegalValueError);
+#endif
+  EXPECT_TRUE(array.empty());
+  EXPECT_TRUE(array.path().empty());
+
+  MappedArray<uint8_t> bytes;
+  TempFile byteFile(bytesOf(std::vector<uint8_t>({ 1, 2 })), ".be.u8");
+  bytes.map(byteFile.path());
+  EXPECT_EQ(bytes.size(), 2);
+}
+
+TEST(MappedArrayTests, IllegalValues) {
+  std::vector<float> values(10000, 0.25f);
+  values[7000]= 2.0f;
+  values[9000]= -3.0f;
+  TempFile outOfRange(bytesOf(values), ".f32");
+  values[7000]= std::numeric_limits<float>::quiet_NaN();
+  TempFile nan(bytesOf(values), ".f32");
+  const std::string outOfRangeArg= outOfRange.arg();
+  const std::string nanArg= nan.arg();
+  const char* OUT_OF_RANGE[] = { "app", "--embedding", outOfRangeArg.c_str(),
+				 nullptr };
+  const char* NAN_VALUE[] = { "app", "--embedding", nanArg.c_str(),
+			      nullptr };
+  const char* NO_AT[] = { "app", "--ids", "ids.u64", nullptr };
+  const char* MISSING[] = { "app", "--ids", "@/tmp/pistis_no_such_ids.u64",
+			    nullptr };
+  EmbeddingArgs args;
+
+  try {
+    args.parse(ARGC_FOR(OUT_OF_RANGE), const_cast<char**>(OUT_OF_RANGE));
+    FAIL() << "IllegalValueError not thrown";
+  } catch(const IllegalValueError& e) {
+    EXPECT_NE(std::string(e.what()).find("embedding (--embedding)"),
+	      std::string::npos) << e.what();
+    EXPECT_NE(std::string(e.what()).find("Element 7000"), std::string::npos)
+	<< e.what();
+  }
+  EXPECT_TRUE(args.embedding().empty());
+  EXPECT_THROW(args.parse(ARGC_FOR(NAN_VALUE), const_cast<char**>(NAN_VALUE)),
+	       IllegalValueError);
+  EXPECT_THROW(args.parse(ARGC_FOR(NO_AT), const_cast<char**>(NO_AT)),
+	       IllegalValueError);
+  EXPECT_THROW(args.parse(ARGC_FOR(MISSING), const_cast<char**>(MISSING)),
+	       IllegalValueError);
+}
@@ -0,0 +1,130 @@
+/** @file OptionSuggesterTest.cpp
+ *
+ *  Unit tests for pistis::arg_parser::OptionSuggester and suggestions in
+ *  pistis::arg_parser::UnknownCmdLineArgError.
+ */
+
+#include <pistis/arg_parser/OptionSuggester.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <pistis/arg_parser/UnknownCmdLineArgError.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  size_t levenshtein(const std::string& a, const std::string& b) {
+    std::vector< std::vector<size_t> > d(a.size() + 1,
+					 std::vector<size_t>(b.size() + 1));
+    for (size_t i= 0; i <= a.size(); ++i) {
+      d[i][0]= i;
+    }
+    for (size_t j= 0; j <= b.size(); ++j) {
+      d[0][j]= j;
+    }
+    for (size_t i= 1; i <= a.size(); ++i) {
+      for (size_t j= 1; j <= b.size(); ++j) {
+	d[i][j]= std::min(std::min(d[i - 1][j] + 1, d[i][j - 1] + 1),
+			  d[i - 1][j - 1] + ((a[i - 1] == b[j - 1]) ? 0 : 1));
+      }
+    }
+    return d[a.size()][b.size()];
+  }
+
+  class PluginArgs : public SimpleCmdLineArgs {
+  public:
+    PluginArgs(size_t numPlugins): SimpleCmdLineArgs(), values_() {
+      values_.reserve(numPlugins + 2);
+      values_.push_back(std::string());
+      registerNamedArg_("--verbose", "verbosity", false, values_.back());
+      values_.push_back(std::string());
+      registerNamedArg_("--version", "version", false, values_.back());
+      for (size_t i= 0; i < numPlugins; ++i) {
+	values_.push_back(std::string());
+	registerNamedArg_("--plugin" + std::to_string(i) + "-option",
+			  "plugin option", false, values_.back());
+      }
+    }
+
+  private:
+    std::vector<std::string> values_;
+  };
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(OptionSuggesterTests, EditDistance) {
+  std::mt19937 rng(17);
+  std::uniform_int_distribution<int> len(0, 80);
+  std::uniform_int_distribution<int> ch('a', 'e');
+
+  EXPECT_EQ(OptionSuggester::editDistance("kitten", "sitting", 5), 3);
+  EXPECT_EQ(OptionSuggester::editDistance("kitten", "sitting", 2), 3);
+  EXPECT_EQ(OptionSuggester::editDistance("", "abc", 5), 3);
+  EXPECT_EQ(OptionSuggester::editDistance("abc", "", 1), 2);
+
+  for (int trial= 0; trial < 500; ++trial) {
+    std::string a(len(rng), ' ');
+    std::string b(len(rng), ' ');
+    std::generate(a.begin(), a.end(), [&]() { return (char)ch(rng); });
+    std::generate(b.begin(), b.end(), [&]() { return (char)ch(rng); });
+
+    const size_t expected= levenshtein(a, b);
+    EXPECT_EQ(OptionSuggester::editDistance(a, b, 100), expected)
+        << a << " " << b;
+    EXPECT_EQ(OptionSuggester::editDistance(a, b, 3),
+	      std::min(expected, (size_t)4))
+        << a << " " << b;
+  }
+}
+
+TEST(OptionSuggesterTests, Suggest) {
+  OptionSuggester suggester;
+  suggester.add("--verbose");
+  suggester.add("--version");
+  suggester.add("--output");
+  suggester.add("--out-dir");
+  suggester.add("--color");
+  suggester.add("--colour");
+  suggester.add("-v");
+
+  EXPECT_EQ(suggester.suggest("--verbos"),
+	    std::vector<std::string>({ "--verbose" }));
+  EXPECT_EQ(suggester.suggest("--versoin"),
+	    std::vector<std::string>({ "--version" }));
+  EXPECT_EQ(suggester.suggest("--colur"),
+	    std::vector<std::string>({ "--color", "--colour" }));
+  EXPECT_EQ(suggester.suggest("--colur", 1),
+	    std::vector<std::string>({ "--color" }));
+  EXPECT_EQ(suggester.suggest("-x"), std::vector<std::string>({ "-v" }));
+  EXPECT_TRUE(suggester.suggest("--completely-different").empty());
+  EXPECT_TRUE(suggester.suggest("").empty());
+}
+
+TEST(OptionSuggesterTests, UnknownArgumentSuggestions) {
+  const char* ARGV[] = { "app", "--plugin1234-optoin", "x", nullptr };
+  const char* FAR[] = { "app", "--zzzzzzzzzzzz", "x", nullptr };
+  PluginArgs args(20000);
+
+  try {
+    args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+    FAIL() << "UnknownCmdLineArgError not thrown";
+  } catch(const UnknownCmdLineArgError& e) {
+    EXPECT_EQ(e.argName(), "--plugin1234-optoin");
+    EXPECT_EQ(e.suggestions(),
+	      std::vector<std::string>({ "--plugin1234-option" }));
+    EXPECT_NE(std::string(e.what()).find("did you mean --plugin1234-option?"),
+	      std::string::npos) << e.what();
+  }
+
+  try {
+    args.parse(ARGC_FOR(FAR), const_cast<char**>(FAR));
+    FAIL() << "UnknownCmdLineArgError not thrown";
+  } catch(const UnknownCmdLineArgError& e) {
+    EXPECT_TRUE(e.suggestions().empty());
+    EXPECT_EQ(std::string(e.what()).find("did you mean"), std::string::npos);
+  }
+}
@@ -0,0 +1,192 @@
+/** @file ParallelConversionTest.cpp
+ *
+ *  Unit tests for converting long list values on several threads with
+ *  pistis::arg_parser::SimpleCmdLineArgs::setParallelConversion().
+ */
+
+#include <pistis/arg_parser/IllegalValueError.hpp>
+#include <pistis/arg_parser/ResourceLimitExceededError.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  class ListArgs : public SimpleCmdLineArgs {
+  public:
+    ListArgs(): SimpleCmdLineArgs(), ids_(), names_() {
+      registerNamedArg_("--ids", "ids", false, ",", false, ids_);
+      registerNamedArg_("--names", "names", false, ",", true, names_);
+    }
+
+    const std::vector<int>& ids() const { return ids_; }
+    const std::vector<std::string>& names() const { return names_; }
+
+  protected:
+    virtual void initValues_() {
+      ids_.clear();
+      names_.clear();
+    }
+
+  private:
+    std::vector<int> ids_;
+    std::vector<std::string> names_;
+  };
+
+  // Has no default constructor, so it is never converted in parallel
+  struct Level {
+    explicit Level(int value): value(value) { }
+
+    bool operator==(const Level& other) const {
+      return value == other.value;
+    }
+
+    int value;
+  };
+
+  class LevelArgs : public SimpleCmdLineArgs {
+  public:
+    LevelArgs(): SimpleCmdLineArgs(), levels_() {
+      ValueMap<Level> levelNames;
+      levelNames.setValue("low", Level(1));
+      levelNames.setValue("high", Level(2));
+      registerNamedArg_("--levels", "levels", false, ",", false,
+			levelNames, levels_);
+    }
+
+    const std::vector<Level>& levels() const { return levels_; }
+
+  private:
+    std::vector<Level> levels_;
+  };
+
+  std::string idList(int n) {
+    std::string text;
+    for (int i= 0; i < n; ++i) {
+      if (i) {
+	text.push_back(',');
+      }
+      text.append(std::to_string(i));
+    }
+    return text;
+  }
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(ParallelConversionTests, ItemsWithoutDefaultConstructor) {
+  const char* ARGV[] = { "app", "--levels", "high,low,high", nullptr };
+  LevelArgs args;
+
+  args.setParallelConversion(1, 4);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.levels(),
+	    std::vector<Level>({ Level(2), Level(1), Level(2) }));
+}
+
+TEST(ParallelConversionTests, KeepOrder) {
+  const std::string ids= idList(100000);
+  const char* ARGV[] = { "app", "--ids", "7", "--ids", ids.c_str(),
+			 "--names", "a,,b", nullptr };
+  ListArgs args;
+
+  args.setParallelConversion(16, 4);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  ASSERT_EQ(args.ids().size(), 100001);
+  EXPECT_EQ(args.ids()[0], 7);
+  for (int i= 0; i < 100000; ++i) {
+    ASSERT_EQ(args.ids()[i + 1], i);
+  }
+  EXPECT_EQ(args.names(), std::vector<std::string>({ "a", "", "b" }));
+}
+
+TEST(ParallelConversionTests, ReportFirstIllegalItem) {
+  std::string ids= idList(50000);
+  ids.replace(ids.find(",30000,"), 7, ",x30000,");
+  ids.replace(ids.find(",40000,"), 7, ",y40000,");
+  const char* ARGV[] = { "app", "--ids", ids.c_str(), nullptr };
+  const char* EMPTY[] = { "app", "--ids", "1,,2", nullptr };
+  ListArgs args;
+
+  args.setParallelConversion(4, 4);
+  try {
+    args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+    FAIL() << "IllegalValueError not thrown";
+  } catch(const IllegalValueError& e) {
+    EXPECT_NE(std::string(e.what()).find("ids (--ids)"), std::string::npos)
+	<< e.what();
+    EXPECT_NE(std::string(e.what()).find("x30000"), std::string::npos)
+	<< e.what();
+  }
+
+  // Items before the illegal one are kept, as they are without threads
+  ASSERT_EQ(args.ids().size(), 30000);
+  EXPECT_EQ(args.ids().back(), 29999);
+  EXPECT_THROW(args.parse(ARGC_FOR(EMPTY), const_cast<char**>(EMPTY)),
+	       IllegalValueError);
+}
+
+TEST(ParallelConversionTests, EnforceLimits) {
+  const std::string ids= idList(1000);
+  const char* ARGV[] = { "app", "--ids", ids.c_str(), nullptr };
+  ListArgs args;
+  ParseLimits limits;
+
+  limits.maxListElements= 999;
+  args.setParseLimits(limits);
+  args.setParallelConversion(4, 2);
+  EXPECT_THROW(args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV)),
+	       ResourceLimitExceededError);
+
+  limits.maxListElements= 1000;
+  args.setParseLimits(limits);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.ids().size(), 1000);
+
+  // Slots that are over the byte limit are never allocated
+  limits.maxContainerBytes= 999 * sizeof(int);
+  args.setParseLimits(limits);
+  EXPECT_THROW(args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV)),
+	       ResourceLimitExceededError);
+}
+
+TEST(ParallelConversionTests, LimitBytesWhileConverting) {
+  // The names "0" to "4999" have 18890 characters and span several
+  // chunks
+  const std::string names= idList(5000);
+  const char* ARGV[] = { "app", "--names", names.c_str(), nullptr };
+  ListArgs args;
+  ParseLimits limits;
+
+  limits.maxContainerBytes= 5000 * sizeof(std::string) + 1000;
+  args.setParseLimits(limits);
+  args.setParallelConversion(4, 4);
+  EXPECT_THROW(args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV)),
+	       ResourceLimitExceededError);
+  EXPECT_LT(args.names().size(), 5000);
+
+  limits.maxContainerBytes= 5000 * sizeof(std::string) + 18890;
+  args.setParseLimits(limits);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.names().size(), 5000);
+  EXPECT_EQ(args.names()[4999], "4999");
+}
+
+TEST(ParallelConversionTests, ShortValuesAndOff) {
+  const std::string ids= idList(1000);
+  const char* ARGV[] = { "app", "--ids", "1,2,3", "--ids", ids.c_str(),
+			 nullptr };
+  ListArgs args;
+
+  EXPECT_EQ(args.parallelConversionMinSize(), SIZE_MAX);
+  args.setParallelConversion(ids.size() + 1);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.ids().size(), 1003);
+
+  args.setParallelConversion(SIZE_MAX);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.ids().size(), 1003);
+  EXPECT_EQ(args.ids()[1002], 999);
+}
@@ -0,0 +1,184 @@
+/** @file ParseLimitsTest.cpp
+ *
+ *  Unit tests for pistis::arg_parser::ParseLimits and
+ *  pistis::arg_parser::SeededHash.
+ */
+
+#include <pistis/arg_parser/ResourceLimitExceededError.hpp>
+#include <pistis/arg_parser/SeededHash.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  class TenantArgs : public SimpleCmdLineArgs {
+  public:
+    TenantArgs(): SimpleCmdLineArgs(), ids_(), tags_(), names_(), level_(0) {
+      registerNamedArg_("--ids", "ids", false, ",", false, ids_);
+      registerNamedArg_("--tag", "tags", false, tags_);
+      registerNamedArg_("--level", "level", false, level_);
+      registerUnnamedArg_("names", false, names_);
+    }
+
+    const std::vector<int>& ids() const { return ids_; }
+    const std::unordered_set<std::string, SeededHash<std::string> >&
+        tags() const {
+      return tags_;
+    }
+
+  private:
+    std::vector<int> ids_;
+    std::unordered_set<std::string, SeededHash<std::string> > tags_;
+    std::vector<std::string> names_;
+    int level_;
+  };
+
+  template <size_t N>
+  void parseAndExpectLimit(TenantArgs& args, const char* (&argv)[N],
+			   const std::string& argName,
+			   const std::string& quantity, size_t limit) {
+    try {
+      args.parse((int)N - 1, const_cast<char**>(argv));
+      FAIL() << "ResourceLimitExceededError not thrown";
+    } catch(const ResourceLimitExceededError& e) {
+      EXPECT_EQ(e.argName(), argName);
+      EXPECT_EQ(e.quantity(), quantity);
+      EXPECT_EQ(e.limit(), limit);
+    }
+  }
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(ParseLimitsTests, Unlimited) {
+  const char* ARGV[] = { "app", "--ids", "1,2,3,4,5", "--tag", "a",
+			 "--tag", "b", "x", "y", "z", nullptr };
+  TenantArgs args;
+
+  EXPECT_EQ(args.parseLimits().maxTokens, ParseLimits::UNLIMITED);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.ids(), std::vector<int>({ 1, 2, 3, 4, 5 }));
+  EXPECT_EQ(args.tags().size(), 2);
+  EXPECT_EQ(args.tags().count("a"), 1);
+}
+
+TEST(ParseLimitsTests, TokenLimits) {
+  const char* ARGV[] = { "app", "x", "y", "z", nullptr };
+  const char* LONG[] = { "app", "x", "a-rather-long-argument", nullptr };
+  TenantArgs args;
+  ParseLimits limits;
+
+  limits.maxTokens= 3;
+  limits.maxTokenSize= 8;
+  args.setParseLimits(limits);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  parseAndExpectLimit(args, LONG, "", "Length of argument 2", 8);
+
+  limits.maxTokens= 2;
+  args.setParseLimits(limits);
+  parseAndExpectLimit(args, ARGV, "", "Number of arguments", 2);
+}
+
+TEST(ParseLimitsTests, ListAndContainerLimits) {
+  const char* ARGV[] = { "app", "--ids", "1,2,3,4", nullptr };
+  const char* LONG_LIST[] = { "app", "--ids", "1,2,3,4,5", nullptr };
+  const char* TAGS[] = { "app", "--tag", "0123456789", "--tag",
+			 "0123456789", nullptr };
+  TenantArgs args;
+  ParseLimits limits;
+
+  limits.maxListElements= 4;
+  args.setParseLimits(limits);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.ids().size(), 4);
+  parseAndExpectLimit(args, LONG_LIST, "ids (--ids)",
+		      "Number of list elements", 4);
+
+  // Each parse starts counting bytes from zero
+  limits.maxContainerBytes= 4 * sizeof(int);
+  args.setParseLimits(limits);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+
+  limits.maxContainerBytes= sizeof(std::string) + 10;
+  args.setParseLimits(limits);
+  parseAndExpectLimit(args, TAGS, "tags (--tag)",
+		      "Number of bytes stored", sizeof(std::string) + 10);
+
+  // Room reserved for a list is capped by the byte limit too, so a long
+  // list cannot allocate far past it before the limit is checked
+  std::string ids("0");
+  for (int i= 1; i < 10000; ++i) {
+    ids += "," + std::to_string(i);
+  }
+  const char* HUGE_LIST[] = { "app", "--ids", ids.c_str(), nullptr };
+  TenantArgs other;
+  ParseLimits byteLimit;
+  byteLimit.maxContainerBytes= 4 * sizeof(int);
+  other.setParseLimits(byteLimit);
+  parseAndExpectLimit(other, HUGE_LIST, "ids (--ids)",
+		      "Number of bytes stored", 4 * sizeof(int));
+  EXPECT_LT(other.ids().capacity(), 100);
+}
+
+TEST(ParseLimitsTests, OccurrenceLimit) {
+  const char* ARGV[] = { "app", "--level", "1", "--tag", "a", "--tag", "b",
+			 nullptr };
+  const char* REPEATED[] = { "app", "--level", "1", "--level", "2",
+			     "--level", "3", nullptr };
+  TenantArgs args;
+  ParseLimits limits;
+
+  limits.maxOccurrences= 2;
+  args.setParseLimits(limits);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  parseAndExpectLimit(args, REPEATED, "level (--level)",
+		      "Number of occurrences", 2);
+}
+
+TEST(SeededHashTests, Hash) {
+  SeededHash<std::string> hashString;
+  SeededHash<int> hashInt;
+  std::unordered_set<size_t> hashes;
+
+  EXPECT_EQ(hashString("--verbose"), hashString(std::string("--verbose")));
+  EXPECT_EQ(hashInt(17), hashInt(17));
+  for (int i= 0; i < 1000; ++i) {
+    hashes.insert(hashInt(i));
+    hashes.insert(hashString(std::to_string(i)));
+  }
+  EXPECT_EQ(hashes.size(), 2000);
+
+  // Every length of the last, partial block is handled
+  std::string s;
+  for (size_t i= 0; i < 17; ++i) {
+    hashes.insert(hashString(s));
+    s.push_back('x');
+  }
+  EXPECT_EQ(hashes.size(), 2017);
+}
+
+TEST(SeededHashTests, KnownAnswers) {
+  // The key and message of the SipHash paper's test vector, whose
+  // SipHash-2-4 is given in its Appendix A.  The SipHash-1-3 values
+  // come from the reference implementation with the same key.
+  const uint64_t k0= 0x0706050403020100ULL;
+  const uint64_t k1= 0x0f0e0d0c0b0a0908ULL;
+  unsigned char message[15];
+  for (size_t i= 0; i < sizeof(message); ++i) {
+    message[i]= (unsigned char)i;
+  }
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  EXPECT_EQ(sipHash24(message, 15, k0, k1), 0xa129ca6149be45e5ULL);
+  EXPECT_EQ(sipHash24(message, 0, k0, k1), 0x726fdb47dd0e0e31ULL);
+  EXPECT_EQ(sipHash13(message, 0, k0, k1), 0xabac0158050fc4dcULL);
+  EXPECT_EQ(sipHash13(message, 8, k0, k1), 0x369095118d299a8eULL);
+  EXPECT_EQ(sipHash13(message, 15, k0, k1), 0xd320d86d2a519956ULL);
+#endif
+}
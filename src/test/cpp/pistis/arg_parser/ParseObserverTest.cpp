@@ -0,0 +1,157 @@
+/** @file ParseObserverTest.cpp
+ *
+ *  Unit tests for pistis::arg_parser::ParseObserver and
+ *  pistis::arg_parser::ChromeTraceWriter.
+ */
+
+#include <pistis/arg_parser/ChromeTraceWriter.hpp>
+#include <pistis/arg_parser/IllegalValueError.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  class ServerArgs : public SimpleCmdLineArgs {
+  public:
+    ServerArgs(): SimpleCmdLineArgs(), port_(0), host_() {
+      registerNamedArgInRange_("--port", "port", false, 1, 65535, port_);
+      registerNamedArg_("--host", "host", false, host_);
+    }
+
+  private:
+    int port_;
+    std::string host_;
+  };
+
+  class RecordingObserver : public ParseObserver {
+  public:
+    RecordingObserver(): events_() { }
+
+    const std::vector<std::string>& events() const { return events_; }
+
+    virtual void begin(Event event, const std::string& name) {
+      events_.push_back("begin " + name);
+    }
+    virtual void end(Event event, const std::string& name) {
+      events_.push_back("end " + name);
+    }
+
+  private:
+    std::vector<std::string> events_;
+  };
+
+  class ThrowingObserver : public ParseObserver {
+  public:
+    virtual void begin(Event event, const std::string& name) { }
+    virtual void end(Event event, const std::string& name) {
+      throw std::runtime_error("end");
+    }
+  };
+
+  size_t countOf(const std::string& text, const std::string& s) {
+    size_t n= 0;
+    for (size_t i= text.find(s); i != std::string::npos;
+	 i= text.find(s, i + 1)) {
+      ++n;
+    }
+    return n;
+  }
+
+  std::string readFile(const std::string& path) {
+    std::ifstream in(path);
+    std::ostringstream text;
+    text << in.rdbuf();
+    return text.str();
+  }
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(ParseObserverTests, BeginAndEnd) {
+  const char* ARGV[] = { "app", "--port", "8080", "--host", "localhost",
+			 nullptr };
+  const char* BAD_PORT[] = { "app", "--port", "99999", nullptr };
+  ServerArgs args;
+  RecordingObserver observer;
+
+  args.setParseObserver(&observer);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(observer.events(),
+	    std::vector<std::string>({
+		"begin initValues_", "end initValues_",
+		"begin --port", "end --port",
+		"begin --host", "end --host",
+		"begin checkValues_", "end checkValues_" }));
+
+  EXPECT_THROW(args.parse(ARGC_FOR(BAD_PORT), const_cast<char**>(BAD_PORT)),
+	       IllegalValueError);
+  EXPECT_EQ(observer.events().size(), 12);
+  EXPECT_EQ(observer.events().back(), "end --port");
+}
+
+TEST(ParseObserverTests, ObserverThatThrows) {
+  const char* ARGV[] = { "app", "--port", "8080", nullptr };
+  const char* BAD_PORT[] = { "app", "--port", "99999", nullptr };
+  ServerArgs args;
+  ThrowingObserver observer;
+
+  // What end() throws is discarded, even while a handler's exception is
+  // propagating
+  args.setParseObserver(&observer);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_THROW(args.parse(ARGC_FOR(BAD_PORT), const_cast<char**>(BAD_PORT)),
+	       IllegalValueError);
+}
+
+TEST(ParseObserverTests, ChromeTrace) {
+  const char* ARGV[] = { "app", "--port", "8080", "--host", "localhost",
+			 nullptr };
+  const size_t NUM_THREADS= 4;
+  const size_t NUM_PARSES= 300;
+  std::string path("/tmp/pistis_trace_XXXXXX");
+  close(mkstemp(&path[0]));
+
+  {
+    ChromeTraceWriter writer(path);
+    std::vector<std::thread> threads;
+    for (size_t t= 0; t < NUM_THREADS; ++t) {
+      threads.emplace_back([&writer, &ARGV, NUM_PARSES]() {
+	ServerArgs args;
+	args.setParseObserver(&writer);
+	// Enough events to fill each thread's ring several times
+	for (size_t i= 0; i < NUM_PARSES; ++i) {
+	  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+	}
+      });
+    }
+    writer.flush();
+    for (auto i= threads.begin(); i != threads.end(); ++i) {
+      i->join();
+    }
+  }
+
+  const std::string trace= readFile(path);
+  unlink(path.c_str());
+
+  const size_t expected= NUM_THREADS * NUM_PARSES * 4;
+  EXPECT_EQ(trace.substr(0, 16), "{\"traceEvents\":[");
+  EXPECT_EQ(trace.substr(trace.size() - 3), "]}\n");
+  EXPECT_EQ(countOf(trace, "\"ph\":\"B\""), expected);
+  EXPECT_EQ(countOf(trace, "\"ph\":\"E\""), expected);
+  EXPECT_EQ(countOf(trace, "{\"name\":\"--port\",\"cat\":\"handleValue\""),
+	    NUM_THREADS * NUM_PARSES * 2);
+  for (size_t t= 1; t <= NUM_THREADS; ++t) {
+    EXPECT_NE(trace.find("\"tid\":" + std::to_string(t) + "}"),
+	      std::string::npos);
+  }
+  EXPECT_EQ(countOf(trace, "{"), expected * 2 + 1);
+}
@@ -0,0 +1,89 @@
+/** @file ParseStatsTest.cpp
+ *
+ *  Unit tests for pistis::arg_parser::ParseStats.
+ */
+
+#include <pistis/arg_parser/IllegalValueError.hpp>
+#include <pistis/arg_parser/ParseStats.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  class ServerArgs : public SimpleCmdLineArgs {
+  public:
+    ServerArgs(): SimpleCmdLineArgs(), port_(0), host_(), files_() {
+      registerNamedArgInRange_("--port", "port", true, 1, 65535, port_);
+      registerNamedArg_("--host", "host", false, host_);
+      registerUnnamedArg_("files", false, files_);
+    }
+
+  protected:
+    virtual void checkValues_() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+  private:
+    int port_;
+    std::string host_;
+    std::vector<std::string> files_;
+  };
+
+  uint64_t allocationCalls= 0;
+
+  // Pretends each parse allocates 5 blocks totalling 80 bytes
+  void countAllocations(uint64_t& allocations, uint64_t& bytes) {
+    ++allocationCalls;
+    allocations= 5 * allocationCalls;
+    bytes= 80 * allocationCalls;
+  }
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(ParseStatsTests, CollectStats) {
+  const char* ARGV[] = { "app", "--port", "8080", "--host", "localhost",
+			 "a.txt", "b.txt", nullptr };
+  const char* BAD_PORT[] = { "app", "--port", "99999", nullptr };
+  ServerArgs args;
+  ParseStats stats;
+
+  EXPECT_EQ(args.parseStats(), nullptr);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+
+  ParseStats::setAllocationCounter(countAllocations);
+  args.setParseStats(&stats);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(stats.parses, 1);
+  EXPECT_EQ(stats.tokens, 6);
+  EXPECT_EQ(stats.handlerInvocations, 4);
+  EXPECT_EQ(stats.allocations, 5);
+  EXPECT_EQ(stats.bytesAllocated, 80);
+  EXPECT_EQ(stats.exceptions, 0);
+  EXPECT_GE(stats.checkValuesTime, 1000000);
+  EXPECT_GE(stats.checkTime, stats.checkValuesTime);
+
+  EXPECT_THROW(args.parse(ARGC_FOR(BAD_PORT), const_cast<char**>(BAD_PORT)),
+	       IllegalValueError);
+  EXPECT_EQ(stats.parses, 2);
+  EXPECT_EQ(stats.tokens, 8);
+  EXPECT_EQ(stats.handlerInvocations, 5);
+  EXPECT_EQ(stats.allocations, 10);
+  EXPECT_EQ(stats.exceptions, 1);
+
+  // Nothing is collected once the stats are removed
+  args.setParseStats(nullptr);
+  ParseStats::setAllocationCounter(nullptr);
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(stats.parses, 2);
+  EXPECT_EQ(stats.handlerInvocations, 5);
+
+  stats.reset();
+  EXPECT_EQ(stats.parses, 0);
+  EXPECT_EQ(stats.checkTime, 0);
+}
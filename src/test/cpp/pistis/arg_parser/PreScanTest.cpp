@@ -0,0 +1,116 @@
+/** @file PreScanTest.cpp
+ *
+ *  Unit tests for reserving container destinations before parsing in
+ *  pistis::arg_parser::SimpleCmdLineArgs.
+ */
+
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  class ListArgs : public SimpleCmdLineArgs {
+  public:
+    ListArgs(): SimpleCmdLineArgs(), ids_(), inputs_(), tags_(), level_(0),
+		files_() {
+      registerNamedArg_("--id", "ids", false, ",", false, ids_);
+      registerNamedArg_("--input", "inputs", false, inputs_);
+      registerNamedArg_("--tag", "tags", false, ",", false, tags_);
+      registerNamedArg_("--level", "level", false, level_);
+      registerNamedArg_("--verbose", "verbose", false,
+			[](CmdLineArgGenerator& args,
+			   const std::string& argName) { });
+      registerUnnamedArg_("files", false, files_);
+    }
+
+    const std::vector<int>& ids() const { return ids_; }
+    const std::vector<std::string>& inputs() const { return inputs_; }
+    const std::unordered_set<std::string>& tags() const { return tags_; }
+    int level() const { return level_; }
+    const std::vector<std::string>& files() const { return files_; }
+
+  protected:
+    virtual void initValues_() {
+      ids_= std::vector<int>();
+      inputs_= std::vector<std::string>();
+      tags_= std::unordered_set<std::string>();
+      files_= std::vector<std::string>();
+    }
+
+  private:
+    std::vector<int> ids_;
+    std::vector<std::string> inputs_;
+    std::unordered_set<std::string> tags_;
+    int level_;
+    std::vector<std::string> files_;
+  };
+
+  std::string idList(int n) {
+    std::string ids;
+    for (int i= 0; i < n; ++i) {
+      if (i) {
+	ids.push_back(',');
+      }
+      ids += std::to_string(i);
+    }
+    return ids;
+  }
+
+  void parse(ListArgs& args, std::vector<std::string> argv) {
+    std::vector<char*> ptrs;
+    for (auto i= argv.begin(); i != argv.end(); ++i) {
+      ptrs.push_back(const_cast<char*>(i->c_str()));
+    }
+    ptrs.push_back(nullptr);
+    args.parse((int)argv.size(), ptrs.data());
+  }
+}
+
+TEST(PreScanTests, ReserveContainers) {
+  const std::string ids= idList(1000);
+  ListArgs args;
+
+  EXPECT_FALSE(args.preScan());
+  args.setPreScan(true);
+  parse(args, { "app", "--id", ids, "--input", "a", "a.txt", "--verbose",
+		"--id", "1000,1001", "--level", "3", "--input", "b",
+		"--tag", "x,y,z", "b.txt", "--input", "c" });
+
+  ASSERT_EQ(args.ids().size(), 1002);
+  EXPECT_EQ(args.ids().capacity(), 1002);
+  EXPECT_EQ(args.ids()[999], 999);
+  EXPECT_EQ(args.ids()[1001], 1001);
+  EXPECT_EQ(args.inputs(), std::vector<std::string>({ "a", "b", "c" }));
+  EXPECT_EQ(args.inputs().capacity(), 3);
+  EXPECT_EQ(args.tags().size(), 3);
+  EXPECT_EQ(args.level(), 3);
+  EXPECT_EQ(args.files(), std::vector<std::string>({ "a.txt", "b.txt" }));
+  EXPECT_EQ(args.files().capacity(), 2);
+
+  ParseLimits limits;
+  limits.maxListElements= 2000;
+  args.setParseLimits(limits);
+  parse(args, { "app", "--id", idList(10), "--id", idList(10) });
+  EXPECT_EQ(args.ids().size(), 20);
+  EXPECT_EQ(args.ids().capacity(), 20);
+
+  // Reservations stop at the limit on the size of one list, even when
+  // several lists add up to more
+  limits.maxListElements= 5;
+  args.setParseLimits(limits);
+  parse(args, { "app", "--id", idList(3), "--id", idList(4) });
+  EXPECT_EQ(args.ids().size(), 7);
+  EXPECT_GE(args.ids().capacity(), 7);
+}
+
+TEST(PreScanTests, WithoutPreScan) {
+  ListArgs args;
+
+  parse(args, { "app", "--id", idList(1000) });
+  ASSERT_EQ(args.ids().size(), 1000);
+  EXPECT_GT(args.ids().capacity(), 1000);
+}
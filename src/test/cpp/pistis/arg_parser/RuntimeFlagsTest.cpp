@@ -0,0 +1,222 @@
+/** @file RuntimeFlagsTest.cpp
+ *
+ *  Unit tests for std::atomic destinations in
+ *  pistis::arg_parser::SimpleCmdLineArgs,
+ *  pistis::arg_parser::RuntimeFlagRegistry and
+ *  pistis::arg_parser::FlagAdminServer.
+ */
+
+#include <pistis/arg_parser/FlagAdminServer.hpp>
+#include <pistis/arg_parser/IllegalValueError.hpp>
+#include <pistis/arg_parser/SimpleCmdLineArgs.hpp>
+#include <pistis/exceptions/IllegalValueError.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  class TunableArgs : public SimpleCmdLineArgs {
+  public:
+    TunableArgs(): SimpleCmdLineArgs(), batchSize_(100), samplingRate_(0.5),
+		   name_() {
+      registerNamedArgInRange_("--batch-size", "batch size", false, 1,
+			       10000, batchSize_);
+      registerNamedArg_("--sampling-rate", "sampling rate", false,
+			samplingRate_);
+      registerNamedArg_("--name", "name", false, name_);
+    }
+
+    int batchSize() const {
+      return batchSize_.load(std::memory_order_relaxed);
+    }
+    double samplingRate() const {
+      return samplingRate_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<int> batchSize_;
+    std::atomic<double> samplingRate_;
+    std::string name_;
+  };
+
+  std::string request(const std::string& path, const std::string& text,
+		      size_t numResponses) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family= AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    int fd= socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+      close(fd);
+      return "connect failed";
+    }
+    if (write(fd, text.data(), text.size()) != (ssize_t)text.size()) {
+      close(fd);
+      return "write failed";
+    }
+
+    // Read until every command has been answered
+    std::string response;
+    char buffer[256];
+    size_t found= 0;
+    while (found < numResponses) {
+      ssize_t n= read(fd, buffer, sizeof(buffer));
+      if (n <= 0) {
+	break;
+      }
+      response.append(buffer, n);
+      found= 0;
+      for (size_t i= 0; (i= response.find("ok\n", i)) != std::string::npos;
+	   i += 3) {
+	++found;
+      }
+      for (size_t i= 0; (i= response.find("error ", i)) != std::string::npos;
+	   ++i) {
+	++found;
+      }
+    }
+    close(fd);
+    return response;
+  }
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(RuntimeFlagsTests, AtomicDestinations) {
+  const char* ARGV[] =
+      { "server", "--batch-size", "64", "--sampling-rate", "0.25", nullptr };
+  const char* OUT_OF_RANGE[] = { "server", "--batch-size", "0", nullptr };
+  TunableArgs args;
+
+  args.parse(ARGC_FOR(ARGV), const_cast<char**>(ARGV));
+  EXPECT_EQ(args.batchSize(), 64);
+  EXPECT_NEAR(args.samplingRate(), 0.25, 1e-10);
+  EXPECT_THROW(args.parse(ARGC_FOR(OUT_OF_RANGE),
+			  const_cast<char**>(OUT_OF_RANGE)),
+	       IllegalValueError);
+
+  const RuntimeFlagRegistry& flags= args.runtimeFlags();
+  ASSERT_EQ(flags.size(), 2);
+  EXPECT_TRUE(flags.has("--batch-size"));
+  EXPECT_FALSE(flags.has("--name"));
+  EXPECT_EQ(flags.get("--batch-size"), "64");
+
+  flags.set("--batch-size", "128");
+  EXPECT_EQ(args.batchSize(), 128);
+  flags.set("--sampling-rate", "0.125");
+  EXPECT_NEAR(args.samplingRate(), 0.125, 1e-10);
+
+  // Runtime changes go through the same range check as the command line
+  EXPECT_THROW(flags.set("--batch-size", "20000"),
+	       pistis::exceptions::IllegalValueError);
+  EXPECT_THROW(flags.set("--batch-size", "abc"),
+	       pistis::exceptions::IllegalValueError);
+  EXPECT_THROW(flags.set("--name", "abc"),
+	       pistis::exceptions::IllegalValueError);
+  EXPECT_EQ(args.batchSize(), 128);
+
+  std::vector<RuntimeFlagRegistry::FlagValue> values= flags.values();
+  ASSERT_EQ(values.size(), 2);
+  EXPECT_EQ(values[0].name, "--batch-size");
+  EXPECT_EQ(values[0].description, "batch size");
+  EXPECT_EQ(values[0].value, "128");
+  EXPECT_EQ(values[1].name, "--sampling-rate");
+  EXPECT_EQ(values[1].value, "0.125");
+
+  // Values are printed with enough digits to read back unchanged
+  flags.set("--sampling-rate", "0.1234567890123");
+  EXPECT_EQ(std::stod(flags.get("--sampling-rate")), args.samplingRate());
+  flags.set("--sampling-rate", flags.get("--sampling-rate"));
+  EXPECT_EQ(args.samplingRate(), 0.1234567890123);
+}
+
+TEST(RuntimeFlagsTests, AdminServer) {
+  TunableArgs args;
+  const std::string path=
+      "/tmp/pistis_flags_" + std::to_string(getpid()) + ".sock";
+  FlagAdminServer server(args.runtimeFlags(), path);
+
+  EXPECT_EQ(server.execute("get --batch-size"), "100\nok\n");
+  EXPECT_EQ(server.execute("frobnicate"),
+	    "error Unknown command \"frobnicate\"\n");
+
+  EXPECT_EQ(request(path, "set --batch-size 256\nget --batch-size\n", 2),
+	    "ok\n256\nok\n");
+  EXPECT_EQ(args.batchSize(), 256);
+  EXPECT_EQ(request(path, "list\r\n", 1),
+	    "--batch-size 256\n--sampling-rate 0.5\nok\n");
+
+  std::string response= request(path, "set --batch-size -1\n", 1);
+  EXPECT_EQ(response.compare(0, 6, "error "), 0) << response;
+  EXPECT_EQ(args.batchSize(), 256);
+}
+
+TEST(RuntimeFlagsTests, IdleAdminClient) {
+  TunableArgs args;
+  const std::string path=
+      "/tmp/pistis_flags_idle_" + std::to_string(getpid()) + ".sock";
+  FlagAdminServer server(args.runtimeFlags(), path,
+			 std::chrono::milliseconds(100));
+
+  // A client that connects and sends nothing is disconnected once the
+  // timeout passes, and the next client is served
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family= AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  int idle= socket(AF_UNIX, SOCK_STREAM, 0);
+  ASSERT_EQ(connect(idle, (struct sockaddr*)&addr, sizeof(addr)), 0);
+
+  EXPECT_EQ(request(path, "get --batch-size\n", 1), "100\nok\n");
+  char c;
+  EXPECT_EQ(read(idle, &c, 1), 0);
+  close(idle);
+}
+
+TEST(RuntimeFlagsTests, BusyAdminClient) {
+  TunableArgs args;
+  const std::string path=
+      "/tmp/pistis_flags_busy_" + std::to_string(getpid()) + ".sock";
+  FlagAdminServer server(args.runtimeFlags(), path,
+			 std::chrono::milliseconds(200));
+
+  // A client that keeps sending commands is still disconnected once the
+  // timeout has passed since it connected
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family= AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  int busy= socket(AF_UNIX, SOCK_STREAM, 0);
+  ASSERT_EQ(connect(busy, (struct sockaddr*)&addr, sizeof(addr)), 0);
+
+  static const char COMMAND[]= "get --batch-size\n";
+  const auto start= std::chrono::steady_clock::now();
+  bool disconnected= false;
+  char buffer[256];
+  while (!disconnected &&
+	 ((std::chrono::steady_clock::now() - start) <
+	      std::chrono::seconds(5))) {
+    if (send(busy, COMMAND, sizeof(COMMAND) - 1, MSG_NOSIGNAL) < 0) {
+      disconnected= true;
+    } else {
+      usleep(20000);
+      ssize_t n= recv(busy, buffer, sizeof(buffer), MSG_DONTWAIT);
+      disconnected= !n || ((n < 0) && (errno != EAGAIN));
+    }
+  }
+  EXPECT_TRUE(disconnected);
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+	    std::chrono::seconds(2));
+  close(busy);
+
+  EXPECT_EQ(request(path, "get --batch-size\n", 1), "100\nok\n");
+}
@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <ostream>
 #include <unordered_set>
+#include <stdlib.h>
 
 using namespace pistis::arg_parser;
 namespace util = pistis::util;
@@ -636,6 +637,38 @@ namespace {
     s_= args.next();
   }
 
+  class EnvironmentCmdLineArgs : public AnySimpleCmdLineArgs {
+  public:
+    EnvironmentCmdLineArgs():
+        AnySimpleCmdLineArgs(), threads_(0), ratio_(0.0), name_(), ids_() {
+      registerNamedArg_("--num-threads", "thread count", true, threads_);
+      bindEnvironment_("PISTIS_TEST_");
+      registerNamedArg_("--ratio", "ratio", false, ratio_);
+      registerNamedArg_("--ids", "ids", false, ",", false, ids_);
+      registerNamedArg_("-n", "name", false, name_);
+      bindEnvVar_("-n", "PISTIS_TEST_OTHER_NAME");
+    }
+
+    virtual void reset() {
+      AnySimpleCmdLineArgs::reset();
+      threads_= 0;
+      ratio_= 0.0;
+      name_.clear();
+      ids_.clear();
+    }
+
+    int threads() const { return threads_; }
+    double ratio() const { return ratio_; }
+    const std::string& name() const { return name_; }
+    const std::vector<int>& ids() const { return ids_; }
+
+  private:
+    int threads_;
+    double ratio_;
+    std::string name_;
+    std::vector<int> ids_;
+  };
+
 }
 
 #define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
@@ -1042,3 +1075,63 @@ TEST(SimpleCmdLineArgsTests, UnnamedArbitraryCmdLineArgs) {
   EXPECT_THROW(args.parse(ARGC_FOR(BAD), const_cast<char**>(BAD)),
 		    IllegalValueError);
 }
+
+TEST(SimpleCmdLineArgsTests, EnvironmentValues) {
+  const char* NO_ARGS[] = { "some_program", nullptr };
+  const char* WITH_ARGS[] =
+      { "some_program", "--num-threads", "8", "--ids", "7", nullptr };
+  EnvironmentCmdLineArgs args;
+
+  unsetenv("PISTIS_TEST_NUM_THREADS");
+  unsetenv("PISTIS_TEST_RATIO");
+  unsetenv("PISTIS_TEST_IDS");
+  unsetenv("PISTIS_TEST_OTHER_NAME");
+  unsetenv("PISTIS_TEST_N");
+  EXPECT_THROW(args.parse(ARGC_FOR(NO_ARGS), const_cast<char**>(NO_ARGS)),
+	       RequiredCmdLineArgMissingError);
+
+  setenv("PISTIS_TEST_NUM_THREADS", "4", 1);
+  setenv("PISTIS_TEST_RATIO", "0.5", 1);
+  setenv("PISTIS_TEST_IDS", "1,2,3", 1);
+  setenv("PISTIS_TEST_OTHER_NAME", "foo", 1);
+
+  args.reset();
+  args.parse(ARGC_FOR(NO_ARGS), const_cast<char**>(NO_ARGS));
+  EXPECT_EQ(args.threads(), 4);
+  EXPECT_NEAR(args.ratio(), 0.5, 1e-10);
+  EXPECT_EQ(args.ids(), std::vector<int>({ 1, 2, 3 }));
+  EXPECT_EQ(args.name(), "foo");
+
+  args.reset();
+  args.parse(ARGC_FOR(WITH_ARGS), const_cast<char**>(WITH_ARGS));
+  EXPECT_EQ(args.threads(), 8);
+  EXPECT_NEAR(args.ratio(), 0.5, 1e-10);
+  EXPECT_EQ(args.ids(), std::vector<int>({ 7 }));
+
+  setenv("PISTIS_TEST_RATIO", "bad", 1);
+  args.reset();
+  EXPECT_THROW(args.parse(ARGC_FOR(WITH_ARGS), const_cast<char**>(WITH_ARGS)),
+	       IllegalValueError);
+
+  // "-n" is bound to PISTIS_TEST_N before PISTIS_TEST_OTHER_NAME, so
+  // PISTIS_TEST_N wins whichever the environment lists first
+  unsetenv("PISTIS_TEST_RATIO");
+  unsetenv("PISTIS_TEST_OTHER_NAME");
+  setenv("PISTIS_TEST_N", "bar", 1);
+  setenv("PISTIS_TEST_OTHER_NAME", "foo", 1);
+  args.reset();
+  args.parse(ARGC_FOR(NO_ARGS), const_cast<char**>(NO_ARGS));
+  EXPECT_EQ(args.name(), "bar");
+
+  unsetenv("PISTIS_TEST_N");
+  setenv("PISTIS_TEST_N", "bar", 1);
+  args.reset();
+  args.parse(ARGC_FOR(NO_ARGS), const_cast<char**>(NO_ARGS));
+  EXPECT_EQ(args.name(), "bar");
+
+  unsetenv("PISTIS_TEST_NUM_THREADS");
+  unsetenv("PISTIS_TEST_RATIO");
+  unsetenv("PISTIS_TEST_IDS");
+  unsetenv("PISTIS_TEST_OTHER_NAME");
+  unsetenv("PISTIS_TEST_N");
+}
@@ -0,0 +1,187 @@
+/** @file SubcommandCmdLineArgsTest.cpp
+ *
+ *  Unit tests for pistis::arg_parser::SubcommandCmdLineArgs.
+ */
+
+#include <pistis/arg_parser/SubcommandCmdLineArgs.hpp>
+#include <pistis/arg_parser/RequiredCmdLineArgMissingError.hpp>
+#include <pistis/arg_parser/UnknownCmdLineArgError.hpp>
+#include <pistis/arg_parser/UnknownSubcommandError.hpp>
+#include <pistis/exceptions/IllegalValueError.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace pistis::arg_parser;
+
+namespace {
+  int numCreated= 0;
+
+  class GetArgs : public SimpleCmdLineArgs {
+  public:
+    GetArgs(): SimpleCmdLineArgs(), appName_(), key_(), timeout_(0) {
+      ++numCreated;
+      registerNamedArg_("-t", "timeout", false, timeout_);
+      registerUnnamedArg_("key", true, key_);
+    }
+
+    const std::string& appName() const { return appName_; }
+    const std::string& key() const { return key_; }
+    int timeout() const { return timeout_; }
+
+  protected:
+    virtual void init_(int argc, char** argv) {
+      SimpleCmdLineArgs::init_(argc, argv);
+      appName_= argv[0];
+      key_.clear();
+      timeout_= 0;
+    }
+
+  private:
+    std::string appName_;
+    std::string key_;
+    int timeout_;
+  };
+
+  class PutArgs : public SimpleCmdLineArgs {
+  public:
+    PutArgs(): SimpleCmdLineArgs(), values_() {
+      ++numCreated;
+      registerUnnamedArg_("values", true, values_);
+    }
+
+    const std::vector<std::string>& values() const { return values_; }
+
+  private:
+    std::vector<std::string> values_;
+  };
+
+  template <typename Args>
+  std::unique_ptr<AbstractCmdLineArgs> create() {
+    return std::unique_ptr<AbstractCmdLineArgs>(new Args());
+  }
+
+  const SubcommandCmdLineArgs::Subcommand SUBCOMMANDS[] = {
+    { "delete", "Delete a key", &create<GetArgs> },
+    { "get", "Get a key", &create<GetArgs> },
+    { "put", "Store values", &create<PutArgs> },
+  };
+
+  const SubcommandCmdLineArgs::Subcommand UNSORTED[] = {
+    { "get", "Get a key", &create<GetArgs> },
+    { "delete", "Delete a key", &create<GetArgs> },
+  };
+
+  class ToolArgs : public SubcommandCmdLineArgs {
+  public:
+    ToolArgs(): SubcommandCmdLineArgs(SUBCOMMANDS), verbose_(0) {
+      registerNamedArg_("-v", "verbosity", false, verbose_);
+    }
+
+    int verbose() const { return verbose_; }
+
+  private:
+    int verbose_;
+  };
+
+  class WorkspaceToolArgs : public SubcommandCmdLineArgs {
+  public:
+    WorkspaceToolArgs(): SubcommandCmdLineArgs(SUBCOMMANDS), workspace_() {
+      registerUnnamedArg_("workspace", false, workspace_);
+    }
+
+    const std::string& workspace() const { return workspace_; }
+
+  protected:
+    virtual void init_(int argc, char** argv) {
+      SubcommandCmdLineArgs::init_(argc, argv);
+      workspace_.clear();
+    }
+
+  private:
+    std::string workspace_;
+  };
+}
+
+#define ARGC_FOR(args) (sizeof(args)/sizeof(const char*))-1
+
+TEST(SubcommandCmdLineArgsTests, FindSubcommand) {
+  ToolArgs args;
+
+  EXPECT_EQ(args.numSubcommands(), 3);
+  EXPECT_EQ(args.findSubcommand("delete"), &SUBCOMMANDS[0]);
+  EXPECT_EQ(args.findSubcommand("get"), &SUBCOMMANDS[1]);
+  EXPECT_EQ(args.findSubcommand("put"), &SUBCOMMANDS[2]);
+  EXPECT_EQ(args.findSubcommand("aaa"), nullptr);
+  EXPECT_EQ(args.findSubcommand("gets"), nullptr);
+  EXPECT_EQ(args.findSubcommand("zzz"), nullptr);
+  EXPECT_THROW(SubcommandCmdLineArgs unsorted(UNSORTED),
+	       pistis::exceptions::IllegalValueError);
+}
+
+TEST(SubcommandCmdLineArgsTests, ParseSubcommands) {
+  const char* GET[] =
+      { "tool", "-v", "2", "get", "-t", "30", "some_key", nullptr };
+  const char* PUT[] = { "tool", "put", "a", "-b", "c", nullptr };
+  const char* GET_AGAIN[] = { "tool", "get", "other_key", nullptr };
+  ToolArgs args;
+
+  numCreated= 0;
+  args.parse(ARGC_FOR(GET), const_cast<char**>(GET));
+  EXPECT_EQ(numCreated, 1);
+  EXPECT_EQ(args.verbose(), 2);
+  ASSERT_EQ(args.selected(), &SUBCOMMANDS[1]);
+
+  GetArgs* getArgs= dynamic_cast<GetArgs*>(args.selectedArgs());
+  ASSERT_TRUE(getArgs);
+  EXPECT_EQ(getArgs->appName(), "tool get");
+  EXPECT_EQ(getArgs->key(), "some_key");
+  EXPECT_EQ(getArgs->timeout(), 30);
+
+  // Unnamed arguments starting with '-' go to the subcommand, not to us
+  EXPECT_THROW(args.parse(ARGC_FOR(PUT), const_cast<char**>(PUT)),
+	       UnknownCmdLineArgError);
+  EXPECT_EQ(numCreated, 2);
+
+  args.parse(ARGC_FOR(GET_AGAIN), const_cast<char**>(GET_AGAIN));
+  EXPECT_EQ(numCreated, 2);
+  EXPECT_EQ(args.selectedArgs(), getArgs);
+  EXPECT_EQ(getArgs->key(), "other_key");
+  EXPECT_EQ(getArgs->timeout(), 0);
+}
+
+TEST(SubcommandCmdLineArgsTests, ParseErrors) {
+  const char* UNKNOWN[] = { "tool", "-v", "1", "list", "a", nullptr };
+  const char* MISSING[] = { "tool", "-v", "1", nullptr };
+  const char* HELP[] = { "tool", "-h", nullptr };
+  ToolArgs args;
+
+  EXPECT_THROW(args.parse(ARGC_FOR(UNKNOWN), const_cast<char**>(UNKNOWN)),
+	       UnknownSubcommandError);
+  EXPECT_THROW(args.parse(ARGC_FOR(MISSING), const_cast<char**>(MISSING)),
+	       RequiredCmdLineArgMissingError);
+  args.parse(ARGC_FOR(HELP), const_cast<char**>(HELP));
+  EXPECT_TRUE(args.showUsage());
+  EXPECT_EQ(args.selected(), nullptr);
+}
+
+TEST(SubcommandCmdLineArgsTests, OwnUnnamedArgs) {
+  const char* WITH_WORKSPACE[] = { "tool", "ws", "get", "key", nullptr };
+  const char* WITHOUT[] = { "tool", "get", "ws", nullptr };
+  const char* UNKNOWN[] = { "tool", "ws", "list", "a", nullptr };
+  WorkspaceToolArgs args;
+
+  // Values that are not command names go to our own unnamed arguments
+  args.parse(ARGC_FOR(WITH_WORKSPACE), const_cast<char**>(WITH_WORKSPACE));
+  EXPECT_EQ(args.workspace(), "ws");
+  ASSERT_EQ(args.selected(), &SUBCOMMANDS[1]);
+  EXPECT_EQ(dynamic_cast<GetArgs*>(args.selectedArgs())->key(), "key");
+
+  args.parse(ARGC_FOR(WITHOUT), const_cast<char**>(WITHOUT));
+  EXPECT_EQ(args.workspace(), "");
+  EXPECT_EQ(dynamic_cast<GetArgs*>(args.selectedArgs())->key(), "ws");
+
+  // Once they are used up, only command names are accepted
+  EXPECT_THROW(args.parse(ARGC_FOR(UNKNOWN), const_cast<char**>(UNKNOWN)),
+	       UnknownSubcommandError);
+}
@@ -0,0 +1,55 @@
+/** @file TempFile.hpp
+ *
+ *  A file in /tmp that the unit tests remove when they are done with it.
+ */
+#ifndef __PISTIS__ARG_PARSER__TEST__TEMPFILE_HPP__
+#define __PISTIS__ARG_PARSER__TEST__TEMPFILE_HPP__
+
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace pistis {
+  namespace arg_parser {
+    namespace test {
+
+      class TempFile {
+      public:
+	/** Create a file holding contents whose name ends with suffix */
+	TempFile(const std::string& contents,
+		 const std::string& suffix = std::string()):
+	    path_("/tmp/pistis_test_XXXXXX" + suffix) {
+	  int fd= mkstemps(&path_[0], (int)suffix.size());
+	  if (fd >= 0) {
+	    if (write(fd, contents.data(), contents.size()) !=
+		    (ssize_t)contents.size()) {
+	      path_.clear();
+	    }
+	    close(fd);
+	  }
+	}
+	TempFile(const TempFile&) = delete;
+	~TempFile() { unlink(path_.c_str()); }
+
+	const std::string& path() const { return path_; }
+
+	/** The path preceded by '@', as values read from files are given */
+	std::string arg() const { return "@" + path_; }
+
+	void rewrite(const std::string& contents) {
+	  FILE* f= fopen(path_.c_str(), "w");
+	  fwrite(contents.data(), 1, contents.size(), f);
+	  fclose(f);
+	}
+
+	TempFile& operator=(const TempFile&) = delete;
+
+      private:
+	std::string path_;
+      };
+
+    }
+  }
+}
+#endif